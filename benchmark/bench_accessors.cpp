@@ -0,0 +1,106 @@
+﻿/**
+ * @brief 访问器内联的基准测试
+ *
+ * @details 在紧凑循环中调用length()、charAt()、c_str()、operator==和缓存的hashCode()。
+ *  作为对照，通过opaque()隐藏的函数指针调用同样的访问器，与虚函数一样是无法内联的间接调用。
+ *  （不直接使用虚函数，编译器可以推测动态类型而内联，结果不可靠）
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include <string>
+#include <vector>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	size_t lengthOf(const GiString& str)
+	{
+		return str.length();
+	}
+
+	GI_STRING_DATA_TYPE charOf(const GiString& str, size_t index)
+	{
+		return str.charAt(index);
+	}
+
+	void chars(size_t length, size_t iterations)
+	{
+		std::string text;
+		for (size_t i = 0; i < length; ++i)
+		{
+			text += (char)('a' + i * 7 % 26);
+		}
+		GiString str(text.c_str());
+
+		report("charAt() loop", length, measure([&]() {
+			const GiString& s = *opaque(&str);
+			unsigned sum = 0;
+			for (size_t i = 0; i < s.length(); ++i) sum += (unsigned char)s.charAt(i);
+			doNotOptimize(sum);
+		}, iterations), length);
+
+		report("charAt() loop, indirect call", length, measure([&]() {
+			const GiString& s = *opaque(&str);
+			size_t (*lengthFn)(const GiString&) = opaque(&lengthOf);
+			GI_STRING_DATA_TYPE (*charFn)(const GiString&, size_t) = opaque(&charOf);
+			unsigned sum = 0;
+			for (size_t i = 0; i < lengthFn(s); ++i) sum += (unsigned char)charFn(s, i);
+			doNotOptimize(sum);
+		}, iterations), length);
+
+		report("c_str() loop", length, measure([&]() {
+			const GiString& s = *opaque(&str);
+			const GI_STRING_DATA_TYPE* data = s.c_str();
+			unsigned sum = 0;
+			for (size_t i = 0; i < s.length(); ++i) sum += (unsigned char)data[i];
+			doNotOptimize(sum);
+		}, iterations), length);
+		printf("\n");
+	}
+
+	void collection(size_t count, size_t iterations)
+	{
+		std::vector<GiString> strings;
+		for (size_t i = 0; i < count; ++i)
+		{
+			strings.push_back(GiString(("key_" + std::to_string(i % 1000)).c_str()));
+			strings.back().hashCode();
+		}
+		GiString key("key_42");
+
+		report("sum of length()", count, measure([&]() {
+			size_t total = 0;
+			for (const GiString& s : *opaque(&strings)) total += s.length();
+			doNotOptimize(total);
+		}, iterations));
+
+		report("count operator==", count, measure([&]() {
+			size_t matches = 0;
+			for (const GiString& s : *opaque(&strings)) matches += s == key;
+			doNotOptimize(matches);
+		}, iterations));
+
+		report("xor of cached hashCode()", count, measure([&]() {
+			size_t total = 0;
+			for (const GiString& s : *opaque(&strings)) total ^= s.hashCode();
+			doNotOptimize(total);
+		}, iterations));
+		printf("\n");
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "size", "time/op", "throughput");
+
+	chars(64, 2000000);
+	chars(4096, 50000);
+	collection(10000, 2000);
+	printf("sizeof(GiString) = %zu\n", sizeof(GiString));
+
+	return 0;
+}
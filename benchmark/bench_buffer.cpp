@@ -0,0 +1,85 @@
+﻿/**
+ * @brief GiStringBuffer多线程追加的基准测试
+ *
+ * @details 对比分片暂存的GiStringBuffer与单个互斥锁保护的GiStringBuilder。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string_buffer.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+static const size_t APPENDS_PER_THREAD = 200000;
+static const GiStringView LINE = "2022-11-16 12:00:00 INFO request handled\n";
+
+/**
+ * @brief 单个互斥锁保护的构建器，作为对照
+ */
+class LockedBuilder
+{
+public:
+	void append(const GiStringView& str)
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_builder.append(str);
+	}
+
+	size_t length()
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		return m_builder.length();
+	}
+
+private:
+	std::mutex m_lock;
+	GiStringBuilder m_builder;
+};
+
+template <typename Buffer>
+static double run(size_t threadCount)
+{
+	Buffer buffer;
+	auto begin = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&buffer]() {
+			for (size_t i = 0; i < APPENDS_PER_THREAD; ++i)
+			{
+				buffer.append(LINE);
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+	doNotOptimize(buffer.length());
+
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "threads", "time/append", "throughput");
+
+	size_t maxThreads = std::thread::hardware_concurrency();
+	if (maxThreads == 0) maxThreads = 4;
+
+	for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		size_t appends = threads * APPENDS_PER_THREAD;
+		size_t bytes = appends * LINE.length();
+
+		double sharded = run<GiStringBuffer>(threads);
+		double locked = run<LockedBuilder>(threads);
+
+		report("GiStringBuffer (sharded)", threads, sharded / appends, bytes / appends);
+		report("GiStringBuilder + std::mutex", threads, locked / appends, bytes / appends);
+	}
+
+	return 0;
+}
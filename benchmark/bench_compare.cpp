@@ -0,0 +1,66 @@
+﻿/**
+ * @brief equals()和compareTo()的基准测试
+ *
+ * @details 对比原来逐字节的比较方式、memcmp、std::string以及SIMD实现。
+ *  两个字符串内容相同但缓冲区不同，compareTo()的不同字节位于末尾，均为最坏情况。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include <cstring>
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	/**
+	 * @brief 原来的逐字节比较
+	 */
+	bool byteLoop(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b)
+	{
+		while (*a != '\0' && *b != '\0')
+		{
+			if (*a != *b) break;
+			++a;
+			++b;
+		}
+		return *a == *b;
+	}
+
+	void run(size_t length, size_t iterations)
+	{
+		std::string text(length, 'k');
+		std::string last = text;
+		last[length - 1] = 'z';
+		GiString a(text.c_str());
+		GiString b(text.c_str());
+		GiString c(last.c_str());
+		GiString longer((text + "!").c_str());
+		std::string sa = text;
+		std::string sb = text;
+
+		report("byte loop equals", length, measure([&]() { doNotOptimize(byteLoop(opaque(a.c_str()), opaque(b.c_str()))); }, iterations), length);
+		report("memcmp equals", length, measure([&]() { doNotOptimize(memcmp(opaque(a.c_str()), opaque(b.c_str()), length) == 0); }, iterations), length);
+		report("std::string ==", length, measure([&]() { doNotOptimize(*opaque(&sa) == sb); }, iterations), length);
+		report("GiString::equals()", length, measure([&]() { doNotOptimize(opaque(&a)->equals(b)); }, iterations), length);
+		report("GiString::equals() length differs", length, measure([&]() { doNotOptimize(opaque(&a)->equals(longer)); }, iterations));
+		report("std::string::compare()", length, measure([&]() { doNotOptimize(opaque(&sa)->compare(last)); }, iterations), length);
+		report("GiString::compareTo()", length, measure([&]() { doNotOptimize(opaque(&a)->compareTo(c)); }, iterations), length);
+		printf("\n");
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/compare", "throughput");
+
+	size_t lengths[] = { 8, 24, 64, 256, 4096, 65536 };
+	for (size_t length : lengths)
+	{
+		run(length, length > 4096 ? 50000 : 2000000);
+	}
+	return 0;
+}
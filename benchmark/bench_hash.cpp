@@ -0,0 +1,81 @@
+﻿/**
+ * @brief hashCode()的基准测试
+ *
+ * @details 对比Java式的多项式hash、std::hash<std::string>、GiStringView::hashCode()(每次计算)
+ *  以及GiString::hashCode()(缓存)在不同长度下的耗时，并给出以GiString为键的unordered_map查找耗时。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	/**
+	 * @brief Java的String.hashCode()算法
+	 */
+	size_t polynomial(const GI_STRING_DATA_TYPE* data, size_t length)
+	{
+		size_t hash = 0;
+		for (size_t i = 0; i < length; ++i)
+		{
+			hash = hash * 31 + (unsigned char)data[i];
+		}
+		return hash;
+	}
+
+	void run(size_t length, size_t iterations)
+	{
+		std::string text;
+		for (size_t i = 0; i < length; ++i)
+		{
+			text += (char)('a' + i * 7 % 26);
+		}
+		GiString str(text.c_str());
+		GiStringView view = str.view();
+		std::hash<std::string> stdHash;
+
+		report("polynomial (x31)", length, measure([&]() { doNotOptimize(polynomial(opaque(view.data()), length)); }, iterations), length);
+		report("std::hash<std::string>", length, measure([&]() { doNotOptimize(stdHash(text)); }, iterations), length);
+		report("GiStringView::hashCode()", length, measure([&]() { doNotOptimize(opaque(&view)->hashCode()); }, iterations), length);
+		report("GiString::hashCode() cached", length, measure([&]() { doNotOptimize(opaque(&str)->hashCode()); }, iterations), length);
+		printf("\n");
+	}
+
+	void lookup(size_t count, size_t iterations)
+	{
+		std::vector<GiString> keys;
+		std::unordered_map<GiString, size_t> map;
+		for (size_t i = 0; i < count; ++i)
+		{
+			keys.push_back(GiString(("user:" + std::to_string(i * 7919) + ":session").c_str()));
+			map[keys.back()] = i;
+		}
+
+		size_t index = 0;
+		report("unordered_map<GiString> find", count, measure([&]() {
+			doNotOptimize(map.find(keys[index])->second);
+			index = index + 1 == count ? 0 : index + 1;
+		}, iterations));
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/hash", "throughput");
+
+	size_t lengths[] = { 8, 16, 32, 64, 256, 4096, 65536 };
+	for (size_t length : lengths)
+	{
+		run(length, length > 4096 ? 20000 : 2000000);
+	}
+	lookup(100000, 5000000);
+
+	return 0;
+}
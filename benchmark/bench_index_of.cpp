@@ -0,0 +1,47 @@
+﻿/**
+ * @brief indexOf(char)/lastIndexOf(char)的基准测试
+ *
+ * @details 在不包含目标字符的数据中查找（扫描全部数据），对比各指令集实现与memchr/memrchr。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gi_string_simd.h"
+#include <cstring>
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/search", "throughput");
+
+	const size_t sizes[] = { 16, 64, 256, 4096, 65536, 1 << 20, 16 << 20 };
+	for (size_t size : sizes)
+	{
+		GiString haystack(std::string(size, 'a').c_str());
+		const char* data = haystack.c_str();
+		size_t iterations = (size_t)(256 << 20) / size;
+
+		report("GiString::indexOf", size, measure([&]() { doNotOptimize(haystack.indexOf('x')); }, iterations), size);
+		report("memchr", size, measure([&]() { doNotOptimize(memchr(opaque(data), 'x', size)); }, iterations), size);
+		report("Simd::findCharScalar", size, measure([&]() { doNotOptimize(Simd::findCharScalar(data, size, 'x')); }, iterations), size);
+#if GI_STRING_SIMD_X86
+		report("Simd::findCharSse2", size, measure([&]() { doNotOptimize(Simd::findCharSse2(data, size, 'x')); }, iterations), size);
+		if (Simd::detectIsa() >= Simd::ISA_AVX2)
+		{
+			report("Simd::findCharAvx2", size, measure([&]() { doNotOptimize(Simd::findCharAvx2(data, size, 'x')); }, iterations), size);
+		}
+#endif
+
+		report("GiString::lastIndexOf", size, measure([&]() { doNotOptimize(haystack.lastIndexOf('x')); }, iterations), size);
+#if defined(__GLIBC__)
+		report("memrchr", size, measure([&]() { doNotOptimize(memrchr(opaque(data), 'x', size)); }, iterations), size);
+#endif
+		report("Simd::findLastCharScalar", size, measure([&]() { doNotOptimize(Simd::findLastCharScalar(data, size, 'x')); }, iterations), size);
+		printf("\n");
+	}
+
+	return 0;
+}
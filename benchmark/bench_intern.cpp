@@ -0,0 +1,121 @@
+﻿/**
+ * @brief 字符串驻留池的基准测试
+ *
+ * @details 模拟大量记录引用少量取值（字段名、状态码）的场景，对比普通字符串与驻留字符串占用的堆内存，
+ *  并给出intern()命中时的查找吞吐（单线程与多线程）以及驻留前后equals()的耗时。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	const size_t RECORDS = 1000000;
+	const size_t VOCABULARY = 20000;
+
+	/**
+	 * @brief 第index个取值，一半为短字符串，一半超过内联容量
+	 */
+	std::string value(size_t index)
+	{
+		if (index % 2 == 0) return "code_" + std::to_string(index);
+		return "service.request.field." + std::to_string(index) + ".status";
+	}
+
+	void memory()
+	{
+		size_t before = GiString::memoryStats().liveBytes;
+		{
+			std::vector<GiString> records;
+			records.reserve(RECORDS);
+			for (size_t i = 0; i < RECORDS; ++i)
+			{
+				records.push_back(GiString(value(i * 7919 % VOCABULARY).c_str()));
+			}
+			printf("%-40s %10zu %14.1f MB\n", "plain heap bytes", RECORDS, (GiString::memoryStats().liveBytes - before) / 1048576.0);
+		}
+
+		before = GiString::memoryStats().liveBytes;
+		{
+			std::vector<GiString> records;
+			records.reserve(RECORDS);
+			for (size_t i = 0; i < RECORDS; ++i)
+			{
+				records.push_back(GiString(value(i * 7919 % VOCABULARY).c_str()).intern());
+			}
+			printf("%-40s %10zu %14.1f MB\n", "interned heap bytes", RECORDS, (GiString::memoryStats().liveBytes - before) / 1048576.0);
+			printf("%-40s %10zu %14.1f MB\n", "  of which pool", GiString::internStats().entries, GiString::internStats().bytes / 1048576.0);
+		}
+		printf("\n");
+	}
+
+	void lookup(size_t iterations)
+	{
+		std::vector<GiString> keys;
+		for (size_t i = 0; i < VOCABULARY; ++i)
+		{
+			keys.push_back(GiString(value(i).c_str()));
+			keys.back().intern();
+		}
+
+		size_t index = 0;
+		report("intern() hit, 1 thread", VOCABULARY, measure([&]() {
+			// 每次复制一份未驻留的对象，避免命中isInterned()的捷径和缓存的hash数值
+			doNotOptimize(GiString(keys[index].view()).intern());
+			index = index + 1 == VOCABULARY ? 0 : index + 1;
+		}, iterations));
+
+		size_t threadCount = std::thread::hardware_concurrency();
+		if (threadCount < 2) threadCount = 2;
+		auto begin = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&keys, iterations, t]() {
+				size_t index = t * 997 % VOCABULARY;
+				for (size_t i = 0; i < iterations; ++i)
+				{
+					doNotOptimize(GiString(keys[index].view()).intern());
+					index = index + 1 == VOCABULARY ? 0 : index + 1;
+				}
+			});
+		}
+		for (std::thread& thread : threads) thread.join();
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+		printf("%-40s %10zu %11.1f Mops/s\n", "intern() hit, all threads", threadCount, threadCount * iterations * 1000.0 / ns);
+		printf("\n");
+	}
+
+	void equality(size_t iterations)
+	{
+		// 长度相同、只在末尾不同的两个取值，普通比较需要扫描全部内容
+		GiString a = GiString("service.request.field.latency_ms.status.primary");
+		GiString b = GiString("service.request.field.latency_ms.status.replica");
+		GiString ia = a.intern();
+		GiString ib = b.intern();
+		GiString ia2 = GiString(a.view()).intern();
+
+		report("equals() plain, different", a.length(), measure([&]() { doNotOptimize(opaque(&a)->equals(b)); }, iterations));
+		report("equals() interned, different", a.length(), measure([&]() { doNotOptimize(opaque(&ia)->equals(ib)); }, iterations));
+		report("equals() interned, same", a.length(), measure([&]() { doNotOptimize(opaque(&ia)->equals(ia2)); }, iterations));
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s\n", "case", "size", "result");
+
+	memory();
+	lookup(2000000);
+	equality(20000000);
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+﻿/**
+ * @brief length()缓存的基准测试
+ *
+ * @details 对比逐字符遍历时，每次都调用strlen（旧实现）与直接读取缓存长度的耗时。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include <cstring>
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+// 通过volatile函数指针调用，防止编译器把strlen提到循环外，与旧实现中跨编译单元调用length()的行为一致
+static size_t (*volatile s_strlen)(const char*) = strlen;
+
+/**
+ * @brief 模拟旧实现：length()和charAt()的边界检查都会调用strlen
+ */
+static size_t loopWithStrlen(const GiString& str)
+{
+	const char* data = str.c_str();
+	size_t sum = 0;
+	for (size_t i = 0; i < s_strlen(data); ++i)
+	{
+		sum += (i < s_strlen(data)) ? (unsigned char)data[i] : 0;
+	}
+	return sum;
+}
+
+static size_t loopWithCachedLength(const GiString& str)
+{
+	size_t sum = 0;
+	for (size_t i = 0; i < str.length(); ++i)
+	{
+		sum += (unsigned char)str.charAt(i);
+	}
+	return sum;
+}
+
+int main()
+{
+	printf("%-40s %10s %17s\n", "case", "length", "time/loop");
+
+	const size_t sizes[] = { 16, 256, 4096, 65536 };
+	for (size_t size : sizes)
+	{
+		GiString str(std::string(size, 'x').c_str());
+		size_t iterations = size >= 4096 ? 20 : 2000;
+
+		double before = measure([&]() { doNotOptimize(loopWithStrlen(str)); }, iterations);
+		double after = measure([&]() { doNotOptimize(loopWithCachedLength(str)); }, iterations * 20);
+
+		report("charAt loop, strlen per query", size, before);
+		report("charAt loop, cached length", size, after);
+	}
+
+	return 0;
+}
@@ -0,0 +1,111 @@
+﻿/**
+ * @brief lines()的基准测试
+ *
+ * @details 模拟较大的日志文本，对比逐字节扫描、lines()、lineViews()以及只统计行数时的吞吐量。
+ *  同时给出纯换行符分类(Simd::lineBreaks)各指令集实现的吞吐量，以及串行和并行拆分的对比。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gi_string_simd.h"
+#include "gi_string_split.h"
+#include "gi_string_parallel.h"
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	typedef size_t(*LineFn)(const GI_STRING_DATA_TYPE*, size_t, size_t*, size_t, size_t&);
+
+	/**
+	 * @brief 只扫描换行符，统计数量
+	 */
+	size_t countBreaks(LineFn fn, const GI_STRING_DATA_TYPE* data, size_t length)
+	{
+		size_t offsets[256];
+		size_t total = 0;
+		size_t pos = 0;
+		while (pos < length)
+		{
+			size_t count = 0;
+			pos += fn(data + pos, length - pos, offsets, 256, count);
+			total += count;
+		}
+		return total;
+	}
+
+	void run(const char* name, const std::string& text, size_t iterations)
+	{
+		GiString str(text.c_str());
+		const GI_STRING_DATA_TYPE* data = str.c_str();
+		size_t size = text.size();
+
+		printf("%s (%zu lines)\n", name, str.lineViews().size());
+		report("byte loop (count lines)", size, measure([&]() {
+			size_t lines = 0;
+			for (size_t i = 0; i < size; ++i)
+			{
+				if (data[i] == '\n' || (data[i] == '\r' && (i + 1 == size || data[i + 1] != '\n'))) ++lines;
+			}
+			doNotOptimize(lines);
+		}, iterations), size);
+		report("lineBreaks scalar", size, measure([&]() { doNotOptimize(countBreaks(Simd::lineBreaksScalar, data, size)); }, iterations), size);
+#if GI_STRING_SIMD_X86
+		report("lineBreaks sse2", size, measure([&]() { doNotOptimize(countBreaks(Simd::lineBreaksSse2, data, size)); }, iterations), size);
+		if (Simd::detectIsa() >= Simd::ISA_AVX2)
+		{
+			report("lineBreaks avx2", size, measure([&]() { doNotOptimize(countBreaks(Simd::lineBreaksAvx2, data, size)); }, iterations), size);
+		}
+#endif
+		report("Split::lines (count lines)", size, measure([&]() {
+			size_t lines = 0;
+			Split::lines(str.view(), [&](size_t, size_t) { ++lines; });
+			doNotOptimize(lines);
+		}, iterations), size);
+		report("lineViews()", size, measure([&]() { doNotOptimize(str.lineViews().size()); }, iterations), size);
+		report("lines()", size, measure([&]() { doNotOptimize(str.lines().size()); }, iterations), size);
+
+		// 关闭并行后的串行版本作为对照
+		size_t threshold = GiString::parallelThreshold();
+		GiString::setParallelThreshold(SIZE_MAX);
+		report("lineViews() serial", size, measure([&]() { doNotOptimize(str.lineViews().size()); }, iterations), size);
+		report("lines() serial", size, measure([&]() { doNotOptimize(str.lines().size()); }, iterations), size);
+		report("split(\" \") serial", size, measure([&]() { doNotOptimize(str.split(" ").size()); }, iterations), size);
+		GiString::setParallelThreshold(threshold);
+		report("split(\" \")", size, measure([&]() { doNotOptimize(str.split(" ").size()); }, iterations), size);
+		printf("\n");
+	}
+
+	/**
+	 * @brief 生成日志文本，每行长度在[minLength, minLength + 64)之间
+	 */
+	std::string makeLog(size_t size, size_t minLength)
+	{
+		std::string ret;
+		ret.reserve(size + minLength + 128);
+		unsigned int seed = 1;
+		while (ret.size() < size)
+		{
+			seed = seed * 1103515245 + 12345;
+			size_t length = minLength + (seed >> 16) % 64;
+			ret += "2024-10-17 12:00:00 INFO ";
+			ret.append(length, (char)('a' + (seed >> 8) % 26));
+			ret += (seed & 7) == 0 ? "\r\n" : "\n";
+		}
+		return ret;
+	}
+}
+
+int main()
+{
+	printf("parallel: %zu threads, threshold %zu bytes\n", Parallel::ThreadPool::shared().concurrency(), GiString::parallelThreshold());
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/op", "throughput");
+
+	run("short lines, 64 MB", makeLog(64 << 20, 16), 5);
+	run("long lines, 64 MB", makeLog(64 << 20, 400), 5);
+
+	return 0;
+}
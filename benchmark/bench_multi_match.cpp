@@ -0,0 +1,73 @@
+﻿/**
+ * @brief GiMultiMatcher的基准测试
+ *
+ * @details 用数千个关键词标记一组短字符串，对比逐个contains()与两种自动机布局。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_multi_matcher.h"
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/record", "throughput");
+
+	const size_t termCounts[] = { 100, 1000, 10000 };
+	for (size_t termCount : termCounts)
+	{
+		std::vector<GiString> terms;
+		for (size_t i = 0; i < termCount; ++i)
+		{
+			terms.push_back(GiString(("kw" + std::to_string(i * 7919 % 100003)).c_str()));
+		}
+
+		std::vector<GiString> records;
+		for (size_t i = 0; i < 200; ++i)
+		{
+			std::string record = "user=" + std::to_string(i) + " action=view item=kw" + std::to_string(i * 31 % 100003)
+				+ " referrer=https://example.com/search?q=string+library&page=" + std::to_string(i % 7);
+			records.push_back(GiString(record.c_str()));
+		}
+		size_t recordBytes = records[0].length();
+
+		GiMultiMatcher dense(terms, GiMultiMatcher::LAYOUT_DENSE);
+		GiMultiMatcher compact(terms, GiMultiMatcher::LAYOUT_COMPACT);
+		printf("%zu terms, %zu states, dense %zu KB, compact %zu KB\n", termCount, dense.stateCount(),
+			dense.memoryBytes() / 1024, compact.memoryBytes() / 1024);
+
+		size_t iterations = termCount >= 10000 ? 2 : 20;
+		report("GiString::contains x terms", recordBytes, measure([&]() {
+			size_t hits = 0;
+			for (auto& record : records)
+			{
+				for (auto& term : terms) hits += record.contains(term);
+			}
+			doNotOptimize(hits);
+		}, iterations) / records.size(), recordBytes);
+
+		std::vector<GiMatch> matches;
+		report("GiMultiMatcher dense", recordBytes, measure([&]() {
+			for (auto& record : records)
+			{
+				matches.clear();
+				dense.findAll(record, matches);
+			}
+			doNotOptimize(matches.size());
+		}, 2000) / records.size(), recordBytes);
+		report("GiMultiMatcher compact", recordBytes, measure([&]() {
+			for (auto& record : records)
+			{
+				matches.clear();
+				compact.findAll(record, matches);
+			}
+			doNotOptimize(matches.size());
+		}, 2000) / records.size(), recordBytes);
+		printf("\n");
+	}
+
+	return 0;
+}
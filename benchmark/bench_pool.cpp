@@ -0,0 +1,99 @@
+﻿/**
+ * @brief GiPoolAllocator多线程申请释放的基准测试
+ *
+ * @details 多个线程同时通过同一个内存池申请和释放缓冲区，对比默认分配器（全局new/delete）。
+ *  每个线程保留一个小的工作集，模拟请求处理中字符串的创建和销毁。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_allocator.h"
+#include "gikoo/gi_string.h"
+#include <thread>
+#include <vector>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+static const size_t OPERATIONS_PER_THREAD = 2000000;
+static const size_t WORKING_SET = 16;
+static const size_t SIZES[] = { 48, 100, 200, 400 };
+
+/**
+ * @brief 直接调用allocate()/deallocate()
+ */
+static double runRaw(GiAllocator* allocator, size_t threadCount)
+{
+	auto begin = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([allocator]() {
+			void* slots[WORKING_SET] = {};
+			for (size_t i = 0; i < OPERATIONS_PER_THREAD; ++i)
+			{
+				size_t slot = i % WORKING_SET;
+				size_t size = SIZES[slot % 4];
+				if (slots[slot]) allocator->deallocate(slots[slot], size);
+				slots[slot] = allocator->allocate(size);
+				doNotOptimize(slots[slot]);
+			}
+			for (size_t slot = 0; slot < WORKING_SET; ++slot)
+			{
+				allocator->deallocate(slots[slot], SIZES[slot % 4]);
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+/**
+ * @brief 在GiAllocatorScope内构造和析构GiString
+ */
+static double runStrings(GiAllocator* allocator, size_t threadCount)
+{
+	const char* text = "a long lived value that does not fit in the local buffer";
+	auto begin = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([allocator, text]() {
+			GiAllocatorScope scope(allocator);
+			for (size_t i = 0; i < OPERATIONS_PER_THREAD; ++i)
+			{
+				GiString str(opaque(text));
+				doNotOptimize(str);
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+int main()
+{
+	printf("%-40s %10s %17s\n", "case", "threads", "time/op");
+
+	size_t maxThreads = std::thread::hardware_concurrency();
+	if (maxThreads < 4) maxThreads = 4;
+
+	GiPoolAllocator pool;
+	for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		size_t operations = threads * OPERATIONS_PER_THREAD;
+
+		report("allocate/deallocate, new/delete", threads, runRaw(GiAllocator::defaultAllocator(), threads) / operations);
+		report("allocate/deallocate, GiPoolAllocator", threads, runRaw(&pool, threads) / operations);
+		report("GiString, new/delete", threads, runStrings(GiAllocator::defaultAllocator(), threads) / operations);
+		report("GiString, GiPoolAllocator", threads, runStrings(&pool, threads) / operations);
+		printf("\n");
+	}
+
+	return 0;
+}
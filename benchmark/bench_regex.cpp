@@ -0,0 +1,50 @@
+﻿/**
+ * @brief 正则表达式的基准测试
+ *
+ * @details 对比GiString::matches()(LRU缓存 + 惰性DFA)、每次重新编译、Pike VM以及std::regex。
+ *  最后一组为会导致回溯引擎指数级退化的表达式。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_regex.h"
+#include <regex>
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	void run(const char* name, const char* pattern, const std::string& text, size_t iterations)
+	{
+		GiString str(text.c_str());
+		GiRegex regex(pattern);
+		GiRegex pike((std::string("\\A(?:") + pattern + ")").c_str());
+		std::regex stdRegex(pattern);
+		size_t size = text.size();
+
+		printf("%s: %s\n", name, pattern);
+		report("GiString::matches", size, measure([&]() { doNotOptimize(str.matches(pattern)); }, iterations), size);
+		report("GiRegex::matches (DFA)", size, measure([&]() { doNotOptimize(regex.matches(str)); }, iterations), size);
+		report("GiRegex::matches (Pike VM)", size, measure([&]() { doNotOptimize(pike.matches(str)); }, iterations), size);
+		report("GiRegex(pattern).matches", size, measure([&]() { doNotOptimize(GiRegex(pattern).matches(str)); }, iterations), size);
+		report("std::regex_match", size, measure([&]() { doNotOptimize(std::regex_match(text, stdRegex)); }, iterations), size);
+		printf("\n");
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/match", "throughput");
+
+	run("email", "[\\w.]+@[a-z]+\\.(com|org)", "first.last@example.com", 100000);
+	run("date", "\\d{4}-\\d{2}-\\d{2}", "2024-10-17", 100000);
+	run("log line", "\\w+ \\d+ .*(ERROR|WARN).*", "server 42 2024-10-17T08:00:00 worker-3 request failed with ERROR code 500", 100000);
+
+	// (a|aa)*c在回溯引擎中指数级退化，std::regex只测试较短的输入
+	std::string repeated(24, 'a');
+	run("pathological", "(a|aa)*c", repeated, 100);
+
+	return 0;
+}
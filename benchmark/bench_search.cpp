@@ -0,0 +1,85 @@
+﻿/**
+ * @brief indexOf(const GiString&)的基准测试
+ *
+ * @details 分别在普通文本和重复文本(最坏情况)中查找短字符串和长字符串，对比std::string::find与memmem。
+ *  另外在大量短字符串中查找同一个字符串，对比每次预处理与使用GiSearcher预编译。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_searcher.h"
+#include <cstring>
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	void run(const char* name, const std::string& text, const std::string& needle)
+	{
+		GiString haystack(text.c_str());
+		GiString pattern(needle.c_str());
+		size_t size = text.size();
+		size_t iterations = (size_t)(64 << 20) / size;
+
+		printf("%s (needle %zu bytes)\n", name, needle.size());
+		report("GiString::indexOf", size, measure([&]() { doNotOptimize(haystack.indexOf(pattern)); }, iterations), size);
+		report("GiString::lastIndexOf", size, measure([&]() { doNotOptimize(haystack.lastIndexOf(pattern)); }, iterations), size);
+		report("std::string::find", size, measure([&]() { doNotOptimize(opaque(&text)->find(needle)); }, iterations), size);
+#if defined(__GLIBC__)
+		report("memmem", size, measure([&]() { doNotOptimize(memmem(opaque(text.data()), size, needle.data(), needle.size())); }, iterations), size);
+#endif
+		printf("\n");
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/search", "throughput");
+
+	const size_t size = 1 << 20;
+	std::string text;
+	const char* words[] = { "string ", "buffer ", "gikoo ", "search ", "engine ", "view ", "builder ", "allocator " };
+	for (size_t i = 0; text.size() < size; ++i)
+	{
+		text += words[(i * 7 + i / 3) % 8];
+	}
+	text.resize(size);
+
+	run("text/short", text, "gikoo search");
+	run("text/long", text, "builder allocator string buffer gikoo search engine miss");
+
+	// 重复文本中几乎匹配的字符串，朴素算法每个位置都要比较到中间
+	std::string repeated(size, 'a');
+	std::string shortNeedle(12, 'a');
+	shortNeedle[6] = 'b';
+	std::string longNeedle(512, 'a');
+	longNeedle[256] = 'b';
+	run("repeated/short", repeated, shortNeedle);
+	run("repeated/long", repeated, longNeedle);
+
+	// 在大量短字符串中查找同一个长字符串，预处理的开销占主要部分
+	std::vector<GiString> records;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		records.push_back(GiString(text.substr(i * 97, 200).c_str()));
+	}
+	GiString filter = { "allocator string buffer gikoo search engine miss" };
+	GiSearcher searcher(filter.view());
+	size_t recordBytes = 200 * records.size();
+
+	printf("filter (%zu records, needle %zu bytes)\n", records.size(), filter.length());
+	report("GiString::contains", recordBytes, measure([&]() {
+		size_t hits = 0;
+		for (auto& record : records) hits += record.contains(filter);
+		doNotOptimize(hits);
+	}, 2000), recordBytes);
+	report("GiString::contains(GiSearcher)", recordBytes, measure([&]() {
+		size_t hits = 0;
+		for (auto& record : records) hits += record.contains(searcher);
+		doNotOptimize(hits);
+	}, 2000), recordBytes);
+
+	return 0;
+}
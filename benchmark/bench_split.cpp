@@ -0,0 +1,58 @@
+﻿/**
+ * @brief split()的基准测试
+ *
+ * @details 同一个分隔符分别通过快速路径(单个字符，SIMD查找)、GiSearcher、正则引擎([,]形式)拆分，
+ *  结果相同，对比各路径的开销。splitViews()惰性产生GiStringView，对比不生成集合时的开销。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_searcher.h"
+#include "gikoo/gi_regex.h"
+#include "gikoo/gi_split_range.h"
+#include <string>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	void run(const char* name, const std::string& text, size_t iterations)
+	{
+		GiString str(text.c_str());
+		GiSearcher comma(",");
+		GiRegex regex("[,]");
+		size_t size = text.size();
+
+		printf("%s (%zu fields)\n", name, str.split(",").size());
+		report("split(\",\") fast path", size, measure([&]() { doNotOptimize(str.split(",").size()); }, iterations), size);
+		report("split(GiSearcher)", size, measure([&]() { doNotOptimize(str.split(comma).size()); }, iterations), size);
+		report("split(\"[,]\") regex", size, measure([&]() { doNotOptimize(str.split("[,]").size()); }, iterations), size);
+		report("split(GiRegex(\"[,]\"))", size, measure([&]() { doNotOptimize(str.split(regex).size()); }, iterations), size);
+		report("splitViews(\",\") lazy", size, measure([&]() {
+			size_t total = 0;
+			for (GiStringView field : str.splitViews(",")) total += field.length();
+			doNotOptimize(total);
+		}, iterations), size);
+		report("splitViews(\",\") first field", size, measure([&]() {
+			doNotOptimize(str.splitViews(",").begin()->length());
+		}, iterations), size);
+		printf("\n");
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s %13s\n", "case", "length", "time/split", "throughput");
+
+	run("csv line", "1024,alice,alice@example.com,2024-10-17,shanghai,active,42.5", 100000);
+
+	std::string wide;
+	for (int i = 0; i < 1000; ++i)
+	{
+		wide += "field" + std::to_string(i) + "_with_some_longer_content,";
+	}
+	run("wide row", wide, 500);
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+﻿/**
+ * @brief 短字符串优化（SSO）的基准测试
+ *
+ * @details 测量不同长度下构造、拷贝、析构的吞吐量，并以std::string作为参照。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include <string>
+#include <vector>
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+static const size_t BATCH = 1024;
+
+template <typename String>
+static void constructDestroy(const char* text)
+{
+	for (size_t i = 0; i < BATCH; ++i)
+	{
+		String str(text);
+		doNotOptimize(str);
+	}
+}
+
+template <typename String>
+static void copyDestroy(const String& src)
+{
+	for (size_t i = 0; i < BATCH; ++i)
+	{
+		String str(src);
+		doNotOptimize(str);
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s\n", "case", "length", "time/op");
+
+	const size_t sizes[] = { 0, 8, 16, GI_STRING_SSO_CAPACITY, GI_STRING_SSO_CAPACITY + 1, 64, 256 };
+	for (size_t size : sizes)
+	{
+		std::string text(size, 'x');
+		GiString giSrc(text.c_str());
+
+		double giCtor = measure([&]() { constructDestroy<GiString>(text.c_str()); }, 2000) / BATCH;
+		double stdCtor = measure([&]() { constructDestroy<std::string>(text.c_str()); }, 2000) / BATCH;
+		double giCopy = measure([&]() { copyDestroy(giSrc); }, 2000) / BATCH;
+		double stdCopy = measure([&]() { copyDestroy(text); }, 2000) / BATCH;
+
+		report("GiString construct+destroy", size, giCtor);
+		report("std::string construct+destroy", size, stdCtor);
+		report("GiString copy+destroy", size, giCopy);
+		report("std::string copy+destroy", size, stdCopy);
+	}
+
+	return 0;
+}
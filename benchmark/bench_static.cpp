@@ -0,0 +1,53 @@
+﻿/**
+ * @brief 编译期字符串字面量的基准测试
+ *
+ * @details 对比与字面量比较时每次构造临时GiString、使用GiStaticString两种写法的耗时，
+ *  以及由长字面量构造GiString时申请内存与引用静态数据的差别。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gikoo/gi_static_string.h"
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	void compare(size_t iterations)
+	{
+		GiString name("content-type");
+		GiString other("content-tyPE");
+		name.hashCode();
+		other.hashCode();
+
+		report("== GiString(literal), equal", name.length(), measure([&]() { doNotOptimize(*opaque(&name) == GiString("content-type")); }, iterations));
+		report("== literal_gs, equal", name.length(), measure([&]() { doNotOptimize(*opaque(&name) == "content-type"_gs); }, iterations));
+		report("== GiString(literal), different", other.length(), measure([&]() { doNotOptimize(*opaque(&other) == GiString("content-type")); }, iterations));
+		report("== literal_gs, different", other.length(), measure([&]() { doNotOptimize(*opaque(&other) == "content-type"_gs); }, iterations));
+		report("startsWith(GiString(literal))", name.length(), measure([&]() { doNotOptimize(opaque(&name)->startsWith(GiString("content-"))); }, iterations));
+		report("startsWith(literal_gs)", name.length(), measure([&]() { doNotOptimize(opaque(&name)->startsWith("content-"_gs)); }, iterations));
+		printf("\n");
+	}
+
+	void construct(size_t iterations)
+	{
+		const char* literal = "x-request-identifier-header-name";
+		size_t length = GiStringView(literal).length();
+
+		report("GiString(const char*)", length, measure([&]() { doNotOptimize(GiString(opaque(literal))); }, iterations));
+		report("GiString(literal_gs)", length, measure([&]() { doNotOptimize(GiString("x-request-identifier-header-name"_gs)); }, iterations));
+		report("GiString(literal_gs).hashCode()", length, measure([&]() { doNotOptimize(GiString("x-request-identifier-header-name"_gs).hashCode()); }, iterations));
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s\n", "case", "length", "time/op");
+
+	compare(20000000);
+	construct(20000000);
+
+	return 0;
+}
@@ -0,0 +1,51 @@
+﻿/**
+ * @brief 原地修改与返回副本的基准测试
+ *
+ * @details 每次迭代由同一输入构造一个堆上的GiString，再分别调用trim()/replace()返回副本、
+ *  对临时对象调用trim()/replace()、调用InPlace函数，三者的差别即副本额外申请的内存和拷贝。
+ */
+
+#include "gi_benchmark.h"
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+
+using namespace GiKoo;
+using namespace GiKoo::Benchmark;
+
+namespace
+{
+	void trim(size_t iterations)
+	{
+		const char* line = "   \t2024-05-01 12:00:00 INFO request served in 12ms from cache\r\n";
+		size_t length = GiStringView(line).length();
+
+		report("GiString s; s.trim()", length, measure([&]() { GiString s(opaque(line)); doNotOptimize(s.trim()); }, iterations));
+		report("GiString(s).trim() &&", length, measure([&]() { doNotOptimize(GiString(opaque(line)).trim()); }, iterations));
+		report("GiString s; s.trimInPlace()", length, measure([&]() { GiString s(opaque(line)); doNotOptimize(s.trimInPlace().length()); }, iterations));
+		printf("\n");
+	}
+
+	void replace(size_t iterations)
+	{
+		const char* path = "/var/log/../log/./service/../service/./access.log";
+		size_t length = GiStringView(path).length();
+		GiString target("/./");
+		GiString replacement("/");
+
+		report("GiString s; s.replace(str, str)", length, measure([&]() { GiString s(opaque(path)); doNotOptimize(s.replace(target, replacement)); }, iterations));
+		report("GiString(s).replace(str, str) &&", length, measure([&]() { doNotOptimize(GiString(opaque(path)).replace(target, replacement)); }, iterations));
+		report("GiString s; s.replaceInPlace(str, str)", length, measure([&]() { GiString s(opaque(path)); doNotOptimize(s.replaceInPlace(target, replacement).length()); }, iterations));
+		report("GiString s; s.replace(char, char)", length, measure([&]() { GiString s(opaque(path)); doNotOptimize(s.replace('/', '\\')); }, iterations));
+		report("GiString s; s.replaceInPlace(char, char)", length, measure([&]() { GiString s(opaque(path)); doNotOptimize(s.replaceInPlace('/', '\\').length()); }, iterations));
+	}
+}
+
+int main()
+{
+	printf("%-40s %10s %17s\n", "case", "length", "time/op");
+
+	trim(10000000);
+	replace(10000000);
+
+	return 0;
+}
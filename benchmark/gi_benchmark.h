@@ -0,0 +1,96 @@
+﻿/**
+ * @brief GiString基准测试公共工具
+ *
+ * @file gi_benchmark.h
+ *
+ * @details
+ *  每个bench_*.cpp都是独立的可执行程序，与src目录下的全部.cpp一起编译。在benchmark目录下的编译示例:
+ *      g++ -O2 -std=c++14 -pthread -I../include -I../src bench_length.cpp ../src/gi_*.cpp -o bench_length
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+
+namespace GiKoo
+{
+	namespace Benchmark
+	{
+		/**
+		 * @brief 防止被测代码被编译器优化掉
+		 */
+		template <typename T>
+		inline void doNotOptimize(const T& value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			asm volatile("" : : "r,m"(value) : "memory");
+#else
+			static volatile const void* sink;
+			sink = &value;
+#endif
+		}
+
+		/**
+		 * @brief 返回原值，但编译器无法推断其内容，防止纯函数的调用被提到循环外
+		 */
+		template <typename T>
+		inline T opaque(T value)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			asm volatile("" : "+r"(value));
+#else
+			static T volatile sink;
+			sink = value;
+			value = sink;
+#endif
+			return value;
+		}
+
+		/**
+		 * @brief 执行指定次数并返回平均耗时
+		 *
+		 * @param fn 被测函数
+		 * @param iterations 执行次数
+		 *
+		 * @return 单次执行的平均耗时（纳秒）
+		 */
+		template <typename Fn>
+		inline double measure(Fn&& fn, size_t iterations)
+		{
+			// 预热
+			fn();
+
+			auto begin = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				fn();
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			return std::chrono::duration<double, std::nano>(end - begin).count() / (double)iterations;
+		}
+
+		/**
+		 * @brief 输出一行测试结果
+		 *
+		 * @param name 测试项名称
+		 * @param size 数据规模
+		 * @param ns 单次耗时（纳秒）
+		 * @param bytes 单次处理的字节数，为0时不输出吞吐量
+		 */
+		inline void report(const char* name, size_t size, double ns, size_t bytes = 0)
+		{
+			if (bytes == 0)
+			{
+				printf("%-40s %10zu %14.1f ns\n", name, size, ns);
+			}
+			else
+			{
+				printf("%-40s %10zu %14.1f ns %10.2f GB/s\n", name, size, ns, (double)bytes / ns);
+			}
+		}
+	}
+}
@@ -0,0 +1,207 @@
+﻿/**
+ * @brief GiKoo字符串内存分配器
+ *
+ * @file gi_allocator.h
+ *
+ * @details
+ *  1. GiString的堆缓冲区通过当前线程的分配器申请，缓冲区记录自己的分配器，释放时归还给它。
+ *  2. 默认使用全局new/delete。通过GiAllocatorScope可以在一段作用域内切换分配器。
+ *  3. GiArenaAllocator: 单调递增的内存区，适用于请求级的临时字符串，请求结束时一次性释放。
+ *  4. GiPoolAllocator: 按大小分级的内存池，适用于长期存活的字符串。
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace GiKoo
+{
+	/**
+	 * @brief 分配器接口
+	 */
+	class GiAllocator
+	{
+	public:
+		virtual ~GiAllocator();
+
+		/**
+		 * @brief 申请内存
+		 *
+		 * @param size 字节数
+		 *
+		 * @return 按alignof(std::max_align_t)对齐的内存
+		 */
+		virtual void* allocate(size_t size) = 0;
+
+		/**
+		 * @brief 释放内存
+		 *
+		 * @param ptr allocate()返回的指针
+		 * @param size 申请时的字节数
+		 */
+		virtual void deallocate(void* ptr, size_t size) = 0;
+
+		/**
+		 * @brief 内存是否只在一段作用域内有效
+		 *
+		 * @details 为true时内存可能在使用者不知情的情况下被整体释放（如GiArenaAllocator::reset()），
+		 *  GiString的拷贝不共享来自该分配器的缓冲区。默认为false
+		 */
+		virtual bool isScoped() const;
+
+		/**
+		 * @brief 默认分配器，使用全局new/delete
+		 */
+		static GiAllocator* defaultAllocator();
+
+		/**
+		 * @brief 当前线程使用的分配器
+		 *
+		 * @return 最内层GiAllocatorScope指定的分配器，没有时返回默认分配器
+		 */
+		static GiAllocator* current();
+	};
+
+	/**
+	 * @brief 在作用域内切换当前线程的分配器
+	 *
+	 * @details 作用域内新申请的GiString堆缓冲区都来自指定的分配器。可以嵌套。
+	 */
+	class GiAllocatorScope
+	{
+	public:
+		/**
+		 * @param allocator 作用域内使用的分配器
+		 */
+		explicit GiAllocatorScope(GiAllocator* allocator);
+		~GiAllocatorScope();
+
+		GiAllocatorScope(const GiAllocatorScope&) = delete;
+		GiAllocatorScope& operator=(const GiAllocatorScope&) = delete;
+
+	private:
+		GiAllocator* m_previous;	// 进入作用域前的分配器
+	};
+
+	/**
+	 * @brief 单调递增的内存区
+	 *
+	 * @details 按块向系统申请内存，块内顺序分配。deallocate()不做任何事，
+	 *  所有内存在reset()或析构时一次性释放。
+	 *
+	 * @note 非线程安全，适合单个请求内使用
+	 * @note reset()或析构后，从该内存区申请缓冲区的GiString全部失效，不能再使用或析构
+	 */
+	class GiArenaAllocator : public GiAllocator
+	{
+	public:
+		/**
+		 * @param chunkSize 每次向系统申请的块大小
+		 */
+		explicit GiArenaAllocator(size_t chunkSize = 64 * 1024);
+		~GiArenaAllocator() override;
+
+		GiArenaAllocator(const GiArenaAllocator&) = delete;
+		GiArenaAllocator& operator=(const GiArenaAllocator&) = delete;
+
+		void* allocate(size_t size) override;
+		void deallocate(void* ptr, size_t size) override;
+
+		/**
+		 * @brief 内存在reset()或析构时整体释放，返回true
+		 */
+		bool isScoped() const override;
+
+		/**
+		 * @brief 一次性释放所有内存，保留第一个块以便复用
+		 */
+		void reset();
+
+		/**
+		 * @brief 已分配出去的字节数
+		 */
+		size_t bytesUsed() const;
+
+	private:
+		struct Chunk;
+
+		Chunk* m_head;			// 当前块，块之间以链表连接
+		size_t m_chunkSize;		// 默认块大小
+		size_t m_bytesUsed;		// 已分配出去的字节数
+	};
+
+	/**
+	 * @brief 按大小分级的内存池
+	 *
+	 * @details 请求大小向上取整到2的幂（32字节到4096字节），每个级别维护独立的空闲链表和锁，
+	 *  不同大小的申请互不竞争。超过4096字节的申请直接使用默认分配器。
+	 *  每个线程另有各级别的空闲内存缓存，与共享空闲链表之间成批移动，多数申请和释放不加锁。
+	 *  线程退出时缓存归还给共享空闲链表。
+	 *
+	 * @note 线程安全。析构时释放所有内存，之后从该内存池申请缓冲区的GiString全部失效
+	 */
+	class GiPoolAllocator : public GiAllocator
+	{
+	public:
+		GiPoolAllocator();
+		~GiPoolAllocator() override;
+
+		GiPoolAllocator(const GiPoolAllocator&) = delete;
+		GiPoolAllocator& operator=(const GiPoolAllocator&) = delete;
+
+		void* allocate(size_t size) override;
+		void deallocate(void* ptr, size_t size) override;
+
+	private:
+		static const size_t CLASS_COUNT = 8;	// 32, 64, ..., 4096
+
+		struct FreeNode;
+		struct Slab;
+		struct LocalLists;
+		struct ThreadCache;
+
+		struct SizeClass
+		{
+			std::mutex lock;		// 保护本级别的空闲链表
+			FreeNode* freeList;		// 空闲内存
+			Slab* slabs;			// 本级别向系统申请的所有块
+		};
+
+		/**
+		 * @brief 计算级别序号
+		 *
+		 * @return 级别序号。超出范围时返回CLASS_COUNT
+		 */
+		static size_t classOf(size_t size);
+
+		/**
+		 * @brief 线程缓存与共享空闲链表之间每次移动的数量，级别越大数量越少
+		 */
+		static size_t batchOf(size_t index);
+
+		/**
+		 * @brief 从共享空闲链表取出指定数量的内存，不足时申请新块
+		 *
+		 * @return 以FreeNode::next连接的链表
+		 */
+		FreeNode* takeShared(size_t index, size_t count);
+
+		/**
+		 * @brief 把以FreeNode::next连接的count个内存归还给共享空闲链表
+		 */
+		void giveShared(size_t index, FreeNode* head, size_t count);
+
+		/**
+		 * @brief 当前线程中本内存池的缓存
+		 *
+		 * @return 线程同时使用的内存池过多、没有空闲槽位时返回nullptr，直接使用共享空闲链表
+		 */
+		LocalLists* localLists();
+
+		SizeClass m_classes[CLASS_COUNT];
+		uint64_t m_id;			// 进程内唯一的编号，线程缓存据此识别所属的内存池，销毁后不会复用
+	};
+}
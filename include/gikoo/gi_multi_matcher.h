@@ -0,0 +1,168 @@
+﻿/**
+ * @brief GiKoo多模式字符串匹配
+ *
+ * @file gi_multi_matcher.h
+ *
+ * @details
+ *  1. 基于Aho-Corasick自动机，一次构建后可以在任意多个字符串中查找，每次查找只扫描一遍，
+ *     时间复杂度为O(字符串长度 + 匹配数)，与模式数量无关。
+ *  2. 字节按是否出现在模式中压缩为字节类，没有出现的字节共用一个类，缩小转移表。
+ *  3. 两种布局:
+ *      a. 稠密布局: 每个状态保存全部字节类的转移，失败转移已预先展开，每个字节只查一次表。
+ *      b. 紧凑布局: 每个状态只保存实际存在的边(按字节类排序)，失配时沿失败链回退，适用于大型词典。
+ *     状态按广度优先顺序编号，靠近根节点的常用状态在内存中相邻。
+ *  4. 构建完成后不可修改，可以在多个线程中同时使用。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include <cstdint>
+
+namespace GiKoo
+{
+	/**
+	 * @brief 一次匹配
+	 */
+	struct GiMatch
+	{
+		size_t pattern;		// 模式在构建时的下标
+		size_t offset;		// 匹配在字符串中的起点
+	};
+
+	/**
+	 * @brief GiMultiMatcher类
+	 *
+	 * @details 同时查找一组字符串，报告所有匹配(包括相互重叠的匹配)。
+	 */
+	class GiMultiMatcher
+	{
+	public:
+		/**
+		 * @brief 自动机布局
+		 */
+		enum Layout
+		{
+			LAYOUT_AUTO,		// 稠密转移表不超过DENSE_TABLE_LIMIT字节时使用稠密布局，否则使用紧凑布局
+			LAYOUT_DENSE,		// 稠密布局
+			LAYOUT_COMPACT,		// 紧凑布局
+		};
+
+		/**
+		 * @brief LAYOUT_AUTO时稠密转移表的最大字节数
+		 */
+		static const size_t DENSE_TABLE_LIMIT = 1 << 20;
+
+		/**
+		 * @brief 构建自动机
+		 *
+		 * @param patterns 模式集合，下标即匹配结果中的模式编号。空字符串不会被匹配
+		 * @param layout 自动机布局
+		 */
+		explicit GiMultiMatcher(const std::vector<GiString>& patterns, Layout layout = LAYOUT_AUTO);
+
+	public: // 查询类API
+		/**
+		 * @brief 查找所有匹配
+		 *
+		 * @details 按匹配的结束位置排序，结束位置相同时较长的模式在前。
+		 *
+		 * @param str 被查找的字符串
+		 *
+		 * @return 所有匹配
+		 */
+		std::vector<GiMatch> findAll(const GiStringView& str) const;
+
+		/**
+		 * @brief 查找所有匹配，追加到指定集合
+		 *
+		 * @details 可以重复使用同一个集合，避免每次查找都申请内存。
+		 *
+		 * @param str 被查找的字符串
+		 * @param matches 保存结果的集合，原有内容保留
+		 */
+		void findAll(const GiStringView& str, std::vector<GiMatch>& matches) const;
+
+		/**
+		 * @brief 是否包含任意一个模式
+		 *
+		 * @details 找到第一个匹配后立即返回。
+		 *
+		 * @param str 被查找的字符串
+		 *
+		 * @retval true 至少包含一个模式
+		 * @retval false 不包含任何模式
+		 */
+		bool containsAny(const GiStringView& str) const;
+
+		/**
+		 * @brief 获得模式数量
+		 *
+		 * @return 模式数量，包括空字符串
+		 */
+		size_t patternCount() const;
+
+		/**
+		 * @brief 获得自动机的状态数
+		 *
+		 * @return 状态数，包括根状态
+		 */
+		size_t stateCount() const;
+
+		/**
+		 * @brief 获得实际使用的布局
+		 *
+		 * @return LAYOUT_DENSE或LAYOUT_COMPACT
+		 */
+		Layout layout() const;
+
+		/**
+		 * @brief 获得自动机占用的内存
+		 *
+		 * @return 字节数
+		 */
+		size_t memoryBytes() const;
+
+	private:
+		/**
+		 * @brief 紧凑布局中从指定状态读入一个字节类后的状态
+		 */
+		uint32_t step(uint32_t state, uint16_t byteClass) const;
+
+		/**
+		 * @brief 扫描字符串，对每个匹配调用report。report返回false时停止扫描
+		 */
+		template <typename Report>
+		void scan(const GiStringView& str, Report report) const;
+
+		/**
+		 * @brief 报告在指定位置结束的所有模式
+		 *
+		 * @return report返回false时返回false
+		 */
+		template <typename Report>
+		bool reportAt(uint32_t state, size_t end, Report& report) const;
+
+	private:
+		Layout m_layout;
+		uint16_t m_classes[256];					// 字节到字节类的映射，0为没有出现在模式中的字节
+		size_t m_classCount;						// 字节类数量
+		size_t m_stateCount;						// 状态数
+		std::vector<uint32_t> m_lengths;			// 各模式的长度
+
+		std::vector<uint32_t> m_next;				// 稠密布局: 行起点 + 字节类 -> 下一个状态的行起点(状态 * 字节类数量)，最高位标记有输出
+
+		std::vector<uint32_t> m_rootNext;			// 紧凑布局: 根状态的转移，按字节类直接索引
+		std::vector<uint32_t> m_edgeBegin;			// 紧凑布局: 各状态的边在m_edgeClass中的起点，共m_stateCount + 1项
+		std::vector<uint16_t> m_edgeClass;			// 紧凑布局: 边的字节类，同一状态内升序
+		std::vector<uint32_t> m_edgeTarget;			// 紧凑布局: 边的目标状态
+		std::vector<uint32_t> m_fail;				// 紧凑布局: 失败转移
+
+		std::vector<uint32_t> m_match;				// 状态自身或最近的有输出的后缀状态，0表示没有
+		std::vector<uint32_t> m_dictLink;			// 最近的有输出的真后缀状态，0表示没有
+		std::vector<uint32_t> m_outputBegin;		// 各状态输出在m_outputs中的起点，共m_stateCount + 1项
+		std::vector<uint32_t> m_outputs;			// 在各状态结束的模式编号
+	};
+}
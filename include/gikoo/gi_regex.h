@@ -0,0 +1,177 @@
+﻿/**
+ * @brief GiKoo正则表达式
+ *
+ * @file gi_regex.h
+ *
+ * @details
+ *  1. 语法参考Java的Pattern，支持以下子集(按字节匹配):
+ *      a. 字符: 普通字符、\t \n \r \f \a \e \xhh \uhhhh(按UTF-8编码)、\\以及转义的元字符、\Q...\E
+ *      b. 字符类: [abc] [^abc] [a-z] 嵌套的并集[a-c[x-z]]、. \d \D \s \S \w \W
+ *      c. 边界: ^ $ \A \z \Z \b \B (非多行模式)
+ *      d. 分组与选择: (X) (?:X) X|Y，捕获分组按非捕获分组处理
+ *      e. 量词: * + ? {n} {n,} {n,m}，以及对应的非贪婪形式
+ *     不支持反向引用、环视、独占量词、内嵌标志等，编译失败时isValid()返回false。
+ *
+ *  2. 编译为Thompson NFA，匹配时间与字符串长度成线性关系，不会因回溯而退化:
+ *      a. matches()使用惰性DFA，状态在匹配过程中按需生成并缓存，之后的调用直接查表。
+ *         DFA缓存被其他线程占用、表达式包含边界或缓存超过上限时，改用Pike VM。
+ *      b. find()和split()使用Pike VM，与Java一致按最左优先(leftmost-first)的语义选择匹配。
+ *
+ *  3. 不含元字符的表达式直接按普通字符串查找。GiString::split()对单个字符的表达式不经过GiRegex。
+ *  4. GiRegex::cached()通过LRU缓存按表达式文本复用编译结果，GiString::matches()和split()使用该缓存。
+ *  5. 编译结果不可修改(DFA缓存内部加锁)，可以在多个线程中同时使用。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+
+/**
+ * @brief 正则表达式LRU缓存的默认容量
+ */
+#ifndef GI_STRING_REGEX_CACHE_CAPACITY
+#define GI_STRING_REGEX_CACHE_CAPACITY 64
+#endif
+
+namespace GiKoo
+{
+	/**
+	 * @brief 正则表达式缓存统计
+	 */
+	struct GiRegexCacheStats
+	{
+		size_t hits;		// 命中次数
+		size_t misses;		// 未命中(重新编译)次数
+		size_t size;		// 当前缓存的表达式数量
+	};
+
+	/**
+	 * @brief GiRegex类
+	 *
+	 * @details 编译后的正则表达式。拷贝只增加引用计数。
+	 */
+	class GiRegex
+	{
+	public:
+		/**
+		 * @brief 编译正则表达式，不使用缓存
+		 *
+		 * @param pattern 正则表达式
+		 */
+		explicit GiRegex(const GiStringView& pattern);
+
+		/**
+		 * @brief 从LRU缓存中获取编译结果，未命中时编译并加入缓存
+		 *
+		 * @param pattern 正则表达式
+		 *
+		 * @return 编译结果
+		 */
+		static GiRegex cached(const GiStringView& pattern);
+
+		/**
+		 * @brief 设置LRU缓存的容量，超出的表达式按最久未使用的顺序淘汰
+		 *
+		 * @param capacity 最多缓存的表达式数量。为0时不缓存
+		 */
+		static void setCacheCapacity(size_t capacity);
+
+		/**
+		 * @brief 清空LRU缓存及统计
+		 */
+		static void clearCache();
+
+		/**
+		 * @brief 获得LRU缓存统计
+		 *
+		 * @return 缓存统计
+		 */
+		static GiRegexCacheStats cacheStats();
+
+	public: // 查询类API
+		/**
+		 * @brief 编译是否成功
+		 *
+		 * @retval true 编译成功
+		 * @retval false 语法错误或使用了不支持的语法
+		 */
+		bool isValid() const;
+
+		/**
+		 * @brief 获得编译错误
+		 *
+		 * @return 错误说明。编译成功时返回nullptr
+		 */
+		const GI_STRING_DATA_TYPE* error() const;
+
+		/**
+		 * @brief 表达式是否为不含元字符的普通字符串
+		 *
+		 * @details 普通字符串(允许\.等转义)不运行自动机，直接使用GiSearcher查找。
+		 *
+		 * @retval true 普通字符串
+		 * @retval false 需要自动机匹配
+		 */
+		bool isLiteral() const;
+
+		/**
+		 * @brief 获得正则表达式
+		 *
+		 * @return 正则表达式，生命周期与GiRegex相同
+		 */
+		GiStringView pattern() const;
+
+		/**
+		 * @brief 整个字符串是否与正则表达式匹配
+		 *
+		 * @param str 指定字符串
+		 *
+		 * @retval true 匹配成功
+		 * @retval false 匹配失败，或表达式无效
+		 */
+		bool matches(const GiStringView& str) const;
+
+		/**
+		 * @brief 查找下一个匹配
+		 *
+		 * @details ^ \A \b等边界按整个字符串判断，与offset无关。
+		 *
+		 * @param str 指定字符串
+		 * @param offset 起点
+		 * @param start 匹配的起点
+		 * @param end 匹配的终点(不含)
+		 *
+		 * @retval true 找到匹配
+		 * @retval false 没有匹配，或表达式无效
+		 */
+		bool find(const GiStringView& str, size_t offset, size_t& start, size_t& end) const;
+
+		/**
+		 * @brief 根据正则表达式拆分
+		 *
+		 * @details 与Java的String.split(regex, limit)相同:
+		 *  1. limit大于0时最多拆分为limit个，最后一个包含剩余的全部内容。
+		 *  2. limit等于0时不限数量，并去掉末尾的空字符串。
+		 *  3. limit小于0时不限数量，保留末尾的空字符串。
+		 *  4. 开头的零宽匹配不产生空字符串。没有匹配时返回原字符串。
+		 *
+		 * @param str 指定字符串
+		 * @param limit 数量限制
+		 *
+		 * @return 结果集合。表达式无效时返回原字符串
+		 */
+		std::vector<GiString> split(const GiStringView& str, int limit = 0) const;
+
+	private:
+		struct Program;
+		struct Cache;
+
+		explicit GiRegex(const std::shared_ptr<Program>& program);
+
+		static Cache& cache();
+
+		std::shared_ptr<Program> m_program;
+	};
+}
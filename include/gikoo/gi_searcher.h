@@ -0,0 +1,85 @@
+﻿/**
+ * @brief GiKoo预编译的字符串查找模式
+ *
+ * @file gi_searcher.h
+ *
+ * @details
+ *  1. 构造时一次性完成指定字符串的预处理(Two-Way临界分解、末字节移动表)，之后可在任意多个字符串中重复查找。
+ *  2. 构造完成后不可修改，可以在多个线程中同时使用。拷贝只增加引用计数，不重复预处理。
+ *  3. GiString的indexOf、lastIndexOf、contains、split、replace均提供接受GiSearcher的重载。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+
+namespace GiKoo
+{
+	/**
+	 * @brief GiSearcher类
+	 *
+	 * @details 对同一个字符串反复查找时，使用GiSearcher可以省去每次查找的预处理。
+	 */
+	class GiSearcher
+	{
+	public:
+		/**
+		 * @brief 预处理指定字符串
+		 *
+		 * @param pattern 待查找的字符串，内容会被复制
+		 */
+		explicit GiSearcher(const GiStringView& pattern);
+
+	public: // 查询类API
+		/**
+		 * @brief 在指定字符串中查找
+		 *
+		 * @param str 被查找的字符串
+		 * @param offset 起点
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		size_t indexOf(const GiStringView& str, size_t offset = 0) const;
+
+		/**
+		 * @brief 在指定字符串中倒序查找
+		 *
+		 * @param str 被查找的字符串
+		 * @param offset 判断的起点，匹配的起始位置不大于该值。默认从末尾开始
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		size_t lastIndexOf(const GiStringView& str, size_t offset = SIZE_MAX) const;
+
+		/**
+		 * @brief 指定字符串是否包含该模式
+		 *
+		 * @param str 被查找的字符串
+		 *
+		 * @retval true 包含
+		 * @retval false 不包含
+		 */
+		bool contains(const GiStringView& str) const;
+
+		/**
+		 * @brief 获得待查找的字符串
+		 *
+		 * @return 待查找的字符串，生命周期与GiSearcher相同
+		 */
+		GiStringView pattern() const;
+
+		/**
+		 * @brief 获得待查找的字符串长度
+		 *
+		 * @return 字符串长度
+		 */
+		size_t length() const;
+
+	private:
+		struct Plan;
+
+		std::shared_ptr<const Plan> m_plan;
+	};
+}
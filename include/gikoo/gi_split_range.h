@@ -0,0 +1,156 @@
+﻿/**
+ * @brief GiKoo惰性拆分
+ *
+ * @file gi_split_range.h
+ *
+ * @details
+ *  1. 按分隔符逐个产生子串，每个子串是指向原字符串的GiStringView，不复制内容，也不生成集合。
+ *  2. 拆分规则与GiString::split()(即Java的split(regex, limit))相同，包括limit的含义。
+ *     limit为0时，遇到空子串会向后查看是否还有非空子串，确定不是末尾的空子串后再产生。
+ *  3. 可以用于range-for，中途break即停止拆分，不会查找剩余部分。
+ *  4. 单个字符的分隔符以及GiSearcher不申请任何内存。正则表达式在查找时会申请临时内存。
+ *  5. 原字符串、GiSearcher、GiRegex必须在拆分期间保持有效且不被修改。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include <iterator>
+
+namespace GiKoo
+{
+	/**
+	 * @brief GiSplitRange类
+	 *
+	 * @details 惰性拆分的范围，通过begin()/end()遍历。
+	 */
+	class GiSplitRange
+	{
+	private:
+		/**
+		 * @brief 拆分进度，不考虑limit为0时去掉末尾空子串的规则
+		 */
+		struct State
+		{
+			size_t index;		// 下一个子串的起点
+			size_t offset;		// 下一次查找的起点
+			size_t count;		// 已经产生的子串数，不含最后剩余的部分
+			bool done;			// 已经产生了最后剩余的部分
+		};
+
+	public:
+		/**
+		 * @brief GiSplitRange的迭代器
+		 */
+		class Iterator
+		{
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef GiStringView value_type;
+			typedef ptrdiff_t difference_type;
+			typedef const GiStringView* pointer;
+			typedef const GiStringView& reference;
+
+			const GiStringView& operator*() const;
+			const GiStringView* operator->() const;
+			Iterator& operator++();
+			Iterator operator++(int);
+			bool operator==(const Iterator& another) const;
+			bool operator!=(const Iterator& another) const;
+
+		private:
+			friend class GiSplitRange;
+
+			Iterator(const GiSplitRange* range);
+
+			/**
+			 * @brief 产生下一个子串，没有时变为结束迭代器
+			 */
+			void advance();
+
+			const GiSplitRange* m_range;	// 为nullptr时表示结束
+			State m_state;
+			GiStringView m_token;
+			size_t m_confirmedEmpty;		// 已确认后面还有非空子串的空子串数
+		};
+
+		/**
+		 * @brief 按单个字符拆分
+		 *
+		 * @param str 指定字符串
+		 * @param delimiter 分隔符
+		 * @param limit 数量限制。大于0时最多拆分为limit个；等于0时去掉末尾的空字符串；小于0时保留
+		 */
+		GiSplitRange(const GiStringView& str, GI_STRING_DATA_TYPE delimiter, int limit = 0);
+
+		/**
+		 * @brief 按预编译的字符串拆分
+		 *
+		 * @param str 指定字符串
+		 * @param separator 分隔符，拆分期间必须保持有效
+		 * @param limit 数量限制
+		 */
+		GiSplitRange(const GiStringView& str, const GiSearcher& separator, int limit = 0);
+
+		/**
+		 * @brief 按正则表达式拆分
+		 *
+		 * @param str 指定字符串
+		 * @param regex 正则表达式，拆分期间必须保持有效
+		 * @param limit 数量限制
+		 */
+		GiSplitRange(const GiStringView& str, const GiRegex& regex, int limit = 0);
+
+		/**
+		 * @brief 按正则表达式拆分，持有编译结果的引用
+		 *
+		 * @param str 指定字符串
+		 * @param regex 正则表达式
+		 * @param limit 数量限制
+		 */
+		GiSplitRange(const GiStringView& str, const std::shared_ptr<const GiRegex>& regex, int limit = 0);
+
+		/**
+		 * @brief 第一个子串
+		 */
+		Iterator begin() const;
+
+		/**
+		 * @brief 结束迭代器
+		 */
+		Iterator end() const;
+
+	private:
+		/**
+		 * @brief 分隔符类型
+		 */
+		enum Mode
+		{
+			MODE_CHAR,
+			MODE_SEARCHER,
+			MODE_REGEX,
+		};
+
+		/**
+		 * @brief 从offset开始查找下一个分隔符
+		 */
+		bool find(size_t offset, size_t& start, size_t& end) const;
+
+		/**
+		 * @brief 按Java的规则产生下一个子串，不考虑末尾空子串
+		 *
+		 * @retval false 已经没有子串
+		 */
+		bool next(State& state, GiStringView& token) const;
+
+		GiStringView m_str;
+		int m_limit;
+		Mode m_mode;
+		GI_STRING_DATA_TYPE m_delimiter;
+		const GiSearcher* m_searcher;
+		const GiRegex* m_regex;
+		std::shared_ptr<const GiRegex> m_ownedRegex;
+	};
+}
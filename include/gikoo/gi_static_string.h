@@ -0,0 +1,156 @@
+﻿/**
+ * @brief GiKoo编译期字符串字面量
+ *
+ * @file gi_static_string.h
+ *
+ * @details
+ *  1. GiStaticString引用静态存储的字符串字面量，长度和hash数值在编译期求得，可以用作switch的case标签。
+ *  2. 转换为GiString时不申请内存：长字面量以静态数据模式直接引用，短字面量复制到对象内部。
+ *  3. GiString::equals()等重载先比较编译期求得的长度，不同即可快速判定不等。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gikoo/gi_string_constexpr.h"
+
+/**
+ * @brief 能否在编译期求得与运行时一致的hash数值
+ *
+ * @details 编译期实现按小端字节序读取，与运行时的wyhash只在小端平台上一致；开启GI_STRING_HASH_RANDOM_SEED时
+ *  编译期无法得知种子。为0时GiStaticString::hashCode()为0，GiString不会缓存错误的数值。
+ */
+#if GI_STRING_HASH_RANDOM_SEED || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define GI_STATIC_STRING_HASH 0
+#else
+#define GI_STATIC_STRING_HASH 1
+#endif
+
+namespace GiKoo
+{
+	/**
+	 * @brief GiStaticString类
+	 *
+	 * @details 通过字面量后缀_gs或者数组构造，例如"content-type"_gs。
+	 *  GI_STATIC_STRING_HASH为0（开启GI_STRING_HASH_RANDOM_SEED或者大端平台）时hashCode()为0。
+	 */
+	class GiStaticString
+	{
+	public:
+		/**
+		 * @brief 引用字符串字面量
+		 *
+		 * @note 长度按数组大小减1计算，只用于字面量
+		 *
+		 * @param str 字符串字面量
+		 */
+		template <size_t N>
+		constexpr explicit GiStaticString(const GI_STRING_DATA_TYPE (&str)[N])
+			: GiStaticString(str, N - 1)
+		{
+		}
+
+		/**
+		 * @brief 引用静态存储的字符串
+		 *
+		 * @param str 以'\0'结尾、生命周期贯穿整个进程的数据
+		 * @param length 字符数，不含结束符
+		 */
+		constexpr GiStaticString(const GI_STRING_DATA_TYPE* str, size_t length)
+			: m_data(str), m_length(length), m_hash(hashOf(str, length))
+		{
+		}
+
+		/**
+		 * @brief 数据指针，以'\0'结尾
+		 */
+		constexpr const GI_STRING_DATA_TYPE* c_str() const
+		{
+			return m_data;
+		}
+
+		/**
+		 * @brief 获得字符串长度
+		 */
+		constexpr size_t length() const
+		{
+			return m_length;
+		}
+
+		/**
+		 * @brief 获得编译期求得的hash数值
+		 *
+		 * @return 与相同内容的GiString::hashCode()一致。GI_STATIC_STRING_HASH为0时为0
+		 */
+		constexpr size_t hashCode() const
+		{
+			return m_hash;
+		}
+
+		/**
+		 * @brief 获得指向字面量的视图
+		 */
+		constexpr GiStringView view() const
+		{
+			return GiStringView(m_data, m_length);
+		}
+
+	private:
+		static constexpr size_t hashOf(const GI_STRING_DATA_TYPE* str, size_t length)
+		{
+#if GI_STATIC_STRING_HASH
+			return (size_t)Constexpr::hash(str, length, GI_STRING_HASH_SEED);
+#else
+			return (void)str, (void)length, 0;
+#endif
+		}
+
+	private:
+		const GI_STRING_DATA_TYPE* m_data;	// 字面量起点
+		size_t m_length;					// 字符数
+		size_t m_hash;						// 编译期求得的hash数值，0表示未知
+	};
+
+	inline namespace Literals
+	{
+		/**
+		 * @brief 字面量后缀，"content-type"_gs得到GiStaticString
+		 */
+		constexpr GiStaticString operator"" _gs(const GI_STRING_DATA_TYPE* str, size_t length)
+		{
+			return GiStaticString(str, length);
+		}
+	}
+
+	// 返回值和参数类型在此处才完整，因此以下GiString成员定义在本文件中
+
+	inline bool GiString::equals(const GiStaticString& another) const
+	{
+		if (m_length != another.length()) return false;
+
+		// 与equals(const GiString&)相同，不使用可能过期的缓存hash数值
+		return m_data == another.c_str() || view().equals(another.view());
+	}
+
+	inline bool GiString::operator==(const GiStaticString& another) const
+	{
+		return equals(another);
+	}
+
+	inline bool GiString::operator!=(const GiStaticString& another) const
+	{
+		return !equals(another);
+	}
+
+	inline bool GiString::startsWith(const GiStaticString& prefix, size_t offset) const
+	{
+		return view().startsWith(prefix.view(), offset);
+	}
+
+	inline bool GiString::endsWith(const GiStaticString& suffix) const
+	{
+		return view().endsWith(suffix.view());
+	}
+}
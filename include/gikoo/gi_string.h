@@ -13,22 +13,152 @@
  *
  */
 
+#pragma once
+
 #include <cstdlib>
+#include <cassert>
 #include <vector>
 #include <climits>
 #include <memory>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief 短字符串优化（SSO）可内联保存的最大字符数，不含结束符
+ *
+ * @details 长度不超过该值的字符串直接保存在对象内部，不申请堆内存。
+ */
+#ifndef GI_STRING_SSO_CAPACITY
+#define GI_STRING_SSO_CAPACITY 23
+#endif
+
+/**
+ * @brief 写时复制（COW）开关
+ *
+ * @details 开启时，拷贝构造和赋值只增加堆缓冲区的引用计数（原子操作），
+ *  直到通过operator[]等修改类API写入时才复制出独立的缓冲区。
+ *  关闭时，每次拷贝都会复制一份新的缓冲区。短字符串总是直接拷贝。
+ */
+#ifndef GI_STRING_COPY_ON_WRITE
+#define GI_STRING_COPY_ON_WRITE 1
+#endif
+
+/**
+ * @brief 内存统计开关
+ *
+ * @details 开启时记录堆内存的申请、释放以及存活的对象数，可通过GiString::memoryStats()查询。
+ *  计数器按线程分组，每个线程只写自己的分组，查询时加总，因此构造、析构短字符串只增加一次线程局部的加法。
+ *  对性能敏感且不需要统计时可以关闭。
+ */
+#ifndef GI_STRING_MEMORY_STATS
+#define GI_STRING_MEMORY_STATS 1
+#endif
+
+/**
+ * @brief 并行拆分的默认阈值（字节）
+ *
+ * @details 长度达到该值的字符串，lines()、lineViews()以及按普通字符串进行的split()由线程池分块并行处理，
+ *  结果与串行版本相同。运行中可通过GiString::setParallelThreshold()修改。
+ */
+#ifndef GI_STRING_PARALLEL_THRESHOLD
+#define GI_STRING_PARALLEL_THRESHOLD (4 * 1024 * 1024)
+#endif
+
+/**
+ * @brief 并行拆分使用的线程数（包括调用者线程）
+ *
+ * @details 为0时使用CPU核数。线程池在第一次并行拆分时创建。
+ */
+#ifndef GI_STRING_PARALLEL_THREADS
+#define GI_STRING_PARALLEL_THREADS 0
+#endif
+
+/**
+ * @brief hashCode()的种子
+ *
+ * @details 相同的种子下hash数值在不同进程之间一致。
+ */
+#ifndef GI_STRING_HASH_SEED
+#define GI_STRING_HASH_SEED 0
+#endif
+
+/**
+ * @brief hashCode()的随机种子开关
+ *
+ * @details 开启时在GI_STRING_HASH_SEED的基础上混入进程启动后生成的随机数，防止针对hash表的冲突攻击(HashDoS)。
+ *  同一进程内结果仍然一致，但不同进程之间不同，不能持久化保存。
+ */
+#ifndef GI_STRING_HASH_RANDOM_SEED
+#define GI_STRING_HASH_RANDOM_SEED 0
+#endif
+
+/**
+ * @brief 驻留池的分片数
+ *
+ * @details 驻留池按hash数值分片，每个分片独立加锁，分片越多并发intern()时的锁竞争越少。
+ */
+#ifndef GI_STRING_INTERN_SHARDS
+#define GI_STRING_INTERN_SHARDS 64
+#endif
+
+/**
+ * @brief 头文件模式开关
+ *
+ * @details 开启时GiStringView的只读查询函数（构造、length、equals、startsWith、endsWith、indexOf、hashCode）
+ *  定义在头文件中并声明为constexpr，字面量的长度和hash数值可在编译期求得，例如用作switch的case标签。
+ *  分配内存、正则等其余功能仍在gistring库中。CMake中通过同名option开启，库与使用者必须使用相同的设置。
+ *  不能与GI_STRING_HASH_RANDOM_SEED同时开启。
+ */
+#ifndef GI_STRING_HEADER_ONLY
+#define GI_STRING_HEADER_ONLY 0
+#endif
 
 namespace GiKoo
 {
 	typedef char GI_STRING_DATA_TYPE;
 
+	class GiStringView;
+	class GiStringBuilder;
+	class GiSearcher;
+	class GiRegex;
+	class GiSplitRange;
+	class GiStaticString;
+
+	/**
+	 * @brief GiString内存统计
+	 *
+	 * @note 关闭GI_STRING_MEMORY_STATS时各项均为0
+	 * @note 各线程的计数分别加总，其他线程同时构造、析构时得到的是近似值
+	 */
+	struct GiStringMemoryStats
+	{
+		size_t liveBytes;			// 当前持有的堆内存字节数
+		size_t liveObjects;			// 当前存活的GiString对象数
+		size_t totalAllocations;	// 累计申请堆内存的次数
+		size_t totalFrees;			// 累计释放堆内存的次数
+	};
+
+	/**
+	 * @brief 驻留池统计
+	 */
+	struct GiStringInternStats
+	{
+		size_t entries;				// 驻留的字符串个数
+		size_t bytes;				// 驻留字符串占用的堆内存字节数
+	};
+
 	/**
 	 * @brief GiString类
 	 *
 	 * @details 一个开箱即用的字符串类。API模仿Java的String，StringBuffer，StringBuilder等类。
+	 *
+	 * @note 成员函数均不是虚函数，对象中没有虚表指针，length()、c_str()等访问器定义在头文件中可以内联。
+	 *  需要扩展时通过组合或派生包装类实现，不能通过GiString指针删除派生类对象。
 	 */
 	class GiString
 	{
+		friend class GiStringBuilder;
+
 	public:
 		/**
 		 * @brief 创建GiString对象
@@ -38,10 +168,21 @@ namespace GiKoo
 		/**
 		 * @brief 创建GiString对象
 		 *
+		 * @note 开启GI_STRING_COPY_ON_WRITE时与str共享堆缓冲区
+		 *
 		 * @param str 拷贝元
 		 */
 		GiString(const GiString& str);
 
+		/**
+		 * @brief 创建GiString对象，接管str的缓冲区
+		 *
+		 * @details 不申请内存。str变为空字符串。
+		 *
+		 * @param str 移动元
+		 */
+		GiString(GiString&& str) noexcept;
+
 		/**
 		 * @brief 创建GiString对象，指定子串，指定字符集
 		 *
@@ -55,18 +196,60 @@ namespace GiKoo
 			size_t length = SIZE_MAX,
 			const GI_STRING_DATA_TYPE* charsetName = nullptr);
 
-		virtual ~GiString();
+		/**
+		 * @brief 创建GiString对象，拷贝视图的内容
+		 *
+		 * @param str 拷贝元
+		 */
+		explicit GiString(const GiStringView& str);
+
+		/**
+		 * @brief 创建GiString对象，不申请内存
+		 *
+		 * @details 长度超过GI_STRING_SSO_CAPACITY时直接引用字面量的静态数据（只读，写入前先复制），
+		 *  否则复制到对象内部。编译期求得的hash数值一起带入。
+		 *
+		 * @param str 编译期字符串，见gi_static_string.h
+		 */
+		GiString(const GiStaticString& str);
+
+		~GiString();
 
 	public: // 判断类API
+		/**
+		 * @brief 按字典序比较两个字符串
+		 *
+		 * @details 与Java的compareTo()相同，字节按无符号数比较，UTF-8编码时与按码点比较的结果一致。
+		 *  通过SIMD查找第一个不相同的字节。
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @return 第一个不相同的字节之差；一个是另一个的前缀时返回长度之差（超出int范围时取INT_MIN/INT_MAX）
+		 * @retval 0 两个字符串相等
+		 */
+		int compareTo(const GiString& another) const;
+
+		/**
+		 * @brief 查找与另一个字符串第一个不相同的字符
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @retval null 字符串相同
+		 * @retval ptr 本字符串中第一个不相同的字符所在位置。本字符串是another的前缀时指向结束符
+		 */
+		const GI_STRING_DATA_TYPE* mismatch(const GiString& another) const;
+
 		/**
 		 * @brief 比较两个字符串
 		 *
+		 * @details 长度不同时直接返回，否则通过SIMD比较内容。
+		 *
 		 * @param another 待比较的字符串
 		 *
-		 * @retval null 字符串相同相同
-		 * @retval ptr 第一个不相同的字符所在位置
+		 * @retval true 两个字符串相等
+		 * @retval false 两个字符串不等
 		 */
-		virtual const GI_STRING_DATA_TYPE* compareTo(const GiString& another) const;
+		bool equals(const GiString& another) const;
 
 		/**
 		 * @brief 比较两个字符串
@@ -76,27 +259,72 @@ namespace GiKoo
 		 * @retval true 两个字符串相等
 		 * @retval false 两个字符串不等
 		 */
-		virtual bool equals(const GiString& another) const;
+		bool operator==(const GiString& another) const;
 
 		/**
 		 * @brief 比较两个字符串
 		 *
 		 * @param another 待比较的字符串
 		 *
+		 * @retval true 两个字符串不等
+		 * @retval false 两个字符串相等
+		 */
+		bool operator!=(const GiString& another) const;
+
+		/**
+		 * @brief 与编译期字符串比较
+		 *
+		 * @details 先比较编译期求得的长度，不同即可直接返回。
+		 *  定义在gi_static_string.h中。
+		 *
+		 * @param another 待比较的字符串
+		 *
 		 * @retval true 两个字符串相等
 		 * @retval false 两个字符串不等
 		 */
-		virtual bool operator==(const GiString& another) const;
+		bool equals(const GiStaticString& another) const;
+
+		/**
+		 * @brief 与编译期字符串比较，同equals(const GiStaticString&)
+		 */
+		bool operator==(const GiStaticString& another) const;
+
+		/**
+		 * @brief 与编译期字符串比较，同!equals(const GiStaticString&)
+		 */
+		bool operator!=(const GiStaticString& another) const;
+
+		/**
+		 * @brief 按字典序比较两个字符串，用于std::map、std::sort等
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @retval true 本字符串较小
+		 * @retval false 本字符串不小于another
+		 */
+		bool operator<(const GiString& another) const;
 
 		/**
 		 * @brief 是否符合指定正则表达式
 		 *
+		 * @details 整个字符串必须匹配。编译结果通过GiRegex::cached()复用，语法见gi_regex.h。
+		 *
 		 * @param regex 正则表达式
 		 *
 		 * @retval true 正则表达式匹配成功
-		 * @retval false 正则表达式匹配失败
+		 * @retval false 正则表达式匹配失败，或表达式无效
+		 */
+		bool matches(const GI_STRING_DATA_TYPE* regex) const;
+
+		/**
+		 * @brief 是否符合编译后的正则表达式
+		 *
+		 * @param regex 编译后的正则表达式
+		 *
+		 * @retval true 正则表达式匹配成功
+		 * @retval false 正则表达式匹配失败，或表达式无效
 		 */
-		virtual bool matches(const GI_STRING_DATA_TYPE* regex) const;
+		bool matches(const GiRegex& regex) const;
 
 		/**
 		 * @brief 是否包含指定字符串
@@ -106,7 +334,17 @@ namespace GiKoo
 		 * @retval true 包含指定字符串
 		 * @retval false 不包含指定字符串
 		 */
-		virtual bool contains(const GiString& str) const;
+		bool contains(const GiString& str) const;
+
+		/**
+		 * @brief 是否包含预编译的字符串
+		 *
+		 * @param searcher 预编译的字符串
+		 *
+		 * @retval true 包含指定字符串
+		 * @retval false 不包含指定字符串
+		 */
+		bool contains(const GiSearcher& searcher) const;
 
 		/**
 		 * @brief 字符串是否为空，或者只包含空格
@@ -114,7 +352,7 @@ namespace GiKoo
 		 * @retval true 字符串为空，或者只包含空格
 		 * @retval false 字符串包含非空格字符
 		 */
-		virtual bool isBlank() const;
+		bool isBlank() const;
 
 		/**
 		 * @brief 字符串是否为空，即长度为0
@@ -122,7 +360,7 @@ namespace GiKoo
 		 * @retval true 空字符串
 		 * @retval false 非空字符串
 		 */
-		virtual bool isEmpty() const;
+		bool isEmpty() const;
 
 	public: // 返回新GiString
 		/**
@@ -133,7 +371,12 @@ namespace GiKoo
 		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
 		 * @return 修改后的字符串副本
 		 */
-		virtual GiString strip(const GI_STRING_DATA_TYPE* coll = nullptr);
+		GiString strip(const GI_STRING_DATA_TYPE* coll = nullptr) const &;
+
+		/**
+		 * @brief 同strip()，对临时对象原地修改并接管其缓冲区，不申请内存
+		 */
+		GiString strip(const GI_STRING_DATA_TYPE* coll = nullptr) &&;
 
 		/**
 		 * @brief 移除字符串头部的指定符号
@@ -141,7 +384,12 @@ namespace GiKoo
 		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
 		 * @return 修改后的字符串副本
 		 */
-		virtual GiString stripLeading(const GI_STRING_DATA_TYPE* coll = nullptr);
+		GiString stripLeading(const GI_STRING_DATA_TYPE* coll = nullptr) const &;
+
+		/**
+		 * @brief 同stripLeading()，对临时对象原地修改并接管其缓冲区，不申请内存
+		 */
+		GiString stripLeading(const GI_STRING_DATA_TYPE* coll = nullptr) &&;
 
 		/**
 		 * @brief 移除字符串尾部的指定符号
@@ -149,42 +397,62 @@ namespace GiKoo
 		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
 		 * @return 修改后的字符串副本
 		 */
-		virtual GiString stripTrailing(const GI_STRING_DATA_TYPE* coll = nullptr);
+		GiString stripTrailing(const GI_STRING_DATA_TYPE* coll = nullptr) const &;
+
+		/**
+		 * @brief 同stripTrailing()，对临时对象原地修改并接管其缓冲区，不申请内存
+		 */
+		GiString stripTrailing(const GI_STRING_DATA_TYPE* coll = nullptr) &&;
 
 		/**
 		 * @brief 移除字符串头部和尾部的小于等于0x20的字符
 		 *
 		 * @return 修改后的字符串副本
 		 */
-		virtual GiString trim();
+		GiString trim() const &;
+
+		/**
+		 * @brief 同trim()，对临时对象原地修改并接管其缓冲区，不申请内存
+		 */
+		GiString trim() &&;
 
 		/**
 		 * @brief 移除字符串头部的小于等于0x20的字符
 		 *
 		 * @return 修改后的字符串副本
 		 */
-		virtual GiString trimStart();
+		GiString trimStart() const &;
+
+		/**
+		 * @brief 同trimStart()，对临时对象原地修改并接管其缓冲区，不申请内存
+		 */
+		GiString trimStart() &&;
 
 		/**
 		 * @brief 移除字符串尾部的小于等于0x20的字符
 		 *
 		 * @return 修改后的字符串副本
 		 */
-		virtual GiString trimEnd();
+		GiString trimEnd() const &;
+
+		/**
+		 * @brief 同trimEnd()，对临时对象原地修改并接管其缓冲区，不申请内存
+		 */
+		GiString trimEnd() &&;
 
 		/**
 		 * @brief 切换为全小写字符
 		 *
 		 * @return 替换后的字符串副本
 		 */
-		virtual GiString toLowerCase() const;
+		GiString toLowerCase() const;
 
 		/**
 		 * @brief 切换为全大写字符
 		 *
 		 * @return 替换后的字符串副本
 		 */
-		virtual GiString toUpperCase() const;
+		GiString toUpperCase() const;
 
 		/**
 		 * @brief 使用新字符替换旧字符
@@ -194,7 +462,12 @@ namespace GiKoo
 		 *
 		 * @return 替换后的字符串副本
 		 */
-		virtual GiString replace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar) const;
+		GiString replace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar) const &;
+
+		/**
+		 * @brief 同replace(oldChar, newChar)，对临时对象原地修改并接管其缓冲区
+		 */
+		GiString replace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar) &&;
 
 		/**
 		 * @brief 使用新字符串替换旧字符串
@@ -204,7 +477,22 @@ namespace GiKoo
 		 *
 		 * @return 替换后的字符串副本
 		 */
-		virtual GiString replace(const GiString& oldStr, const GiString& newStr) const;
+		GiString replace(const GiString& oldStr, const GiString& newStr) const &;
+
+		/**
+		 * @brief 同replace(oldStr, newStr)，对临时对象原地修改并接管其缓冲区
+		 */
+		GiString replace(const GiString& oldStr, const GiString& newStr) &&;
+
+		/**
+		 * @brief 使用新字符串替换预编译的旧字符串
+		 *
+		 * @param oldStr 预编译的旧字符串
+		 * @param newStr 新字符串
+		 *
+		 * @return 替换后的字符串副本
+		 */
+		GiString replace(const GiSearcher& oldStr, const GiString& newStr) const;
 
 		/**
 		 * @brief 字符串链接，不会改变当前字符串
@@ -213,23 +501,102 @@ namespace GiKoo
 		 *
 		 * @return 新的字符串副本
 		 */
-		virtual GiString concat(const GiString& str) const;
+		GiString concat(const GiString& str) const;
 
 		/**
 		 * @brief 根据指定正则表达式进行拆分
 		 *
+		 * @details 与Java的split(regex, limit)相同，详见GiRegex::split()。编译结果通过GiRegex::cached()复用。
+		 *  表达式为普通字符串、limit不大于0且长度达到parallelThreshold()时分块并行处理。
+		 *
 		 * @param regex 指定正则表达式
+		 * @param limit 数量限制。大于0时最多拆分为limit个；等于0时去掉末尾的空字符串；小于0时保留
+		 *
+		 * @return 结果集合。表达式无效时返回原字符串
+		 */
+		std::vector<GiString> split(const GiString& regex, int limit = 0) const;
+
+		/**
+		 * @brief 根据编译后的正则表达式进行拆分
+		 *
+		 * @param regex 编译后的正则表达式
+		 * @param limit 数量限制，与split(const GiString&, int)相同
+		 *
+		 * @return 结果集合。表达式无效时返回原字符串
+		 */
+		std::vector<GiString> split(const GiRegex& regex, int limit = 0) const;
+
+		/**
+		 * @brief 根据预编译的分隔符进行拆分
+		 *
+		 * @details 与Java的split()相同，末尾的空字符串会被去掉。分隔符为空时拆分为单个字符。
+		 *
+		 * @param separator 预编译的分隔符，按普通字符串匹配
 		 *
 		 * @return 结果集合
 		 */
-		virtual std::vector<GiString> split(const GiString& regex) const;
+		std::vector<GiString> split(const GiSearcher& separator) const;
+
+		/**
+		 * @brief 根据指定正则表达式惰性拆分
+		 *
+		 * @details 规则与split(const GiString&, int)相同，但逐个产生指向本字符串的GiStringView，
+		 *  不复制子串也不生成集合，详见gi_split_range.h。单个字符的分隔符不申请任何内存。
+		 *
+		 * @note 遍历期间本字符串必须保持有效且不被修改
+		 *
+		 * @param regex 指定正则表达式
+		 * @param limit 数量限制，与split(const GiString&, int)相同
+		 *
+		 * @return 可用于range-for的拆分范围
+		 */
+		GiSplitRange splitViews(const GiString& regex, int limit = 0) const;
+
+		/**
+		 * @brief 根据编译后的正则表达式惰性拆分
+		 *
+		 * @note 遍历期间本字符串和regex必须保持有效
+		 *
+		 * @param regex 编译后的正则表达式
+		 * @param limit 数量限制，与split(const GiString&, int)相同
+		 *
+		 * @return 可用于range-for的拆分范围
+		 */
+		GiSplitRange splitViews(const GiRegex& regex, int limit = 0) const;
+
+		/**
+		 * @brief 根据预编译的分隔符惰性拆分
+		 *
+		 * @note 遍历期间本字符串和separator必须保持有效
+		 *
+		 * @param separator 预编译的分隔符，按普通字符串匹配
+		 * @param limit 数量限制，与split(const GiString&, int)相同
+		 *
+		 * @return 可用于range-for的拆分范围
+		 */
+		GiSplitRange splitViews(const GiSearcher& separator, int limit = 0) const;
 
 		/**
 		 * @brief 根据字符串中的换行符进行拆分
 		 *
+		 * @details 与Java的String.lines()相同: \n、\r、\r\n均为行结束符，结果不含结束符，
+		 *  末尾的结束符之后没有空行，空字符串返回空集合。换行符通过SIMD一次扫描找出。
+		 *  长度达到parallelThreshold()时分块并行处理。
+		 *
+		 * @return 结果集合
+		 */
+		std::vector<GiString> lines() const;
+
+		/**
+		 * @brief 根据字符串中的换行符进行拆分，不复制每一行
+		 *
+		 * @details 规则与lines()相同，每一行是指向本字符串的GiStringView，适用于较大的文本。
+		 *
+		 * @note 使用结果期间本字符串必须保持有效且不被修改
+		 *
 		 * @return 结果集合
 		 */
-		virtual std::vector<GiString> lines() const;
+		std::vector<GiStringView> lineViews() const;
 
 		/**
 		 * @brief 根据指定格式构建字符串
@@ -248,27 +615,32 @@ namespace GiKoo
 		 *
 		 * @return 子字符串
 		 */
-		virtual GiString subString(size_t offset, size_t length = SIZE_MAX) const;
+		GiString subString(size_t offset, size_t length = SIZE_MAX) const;
 
 	public: // 修改类API
 
 		/**
 		 * @brief 返回指定位置的字符
 		 *
-		 * @note 如果index是非法数值，将返回0
+		 * @note 如果index是非法数值，将返回第0个字符
+		 * @note 缓冲区被共享时会先复制出独立的缓冲区，之后的拷贝不再共享该缓冲区
 		 *
 		 * @param index 指定位置
 		 *
 		 * @return 字符
 		 */
-		virtual GI_STRING_DATA_TYPE& operator[](size_t index);
+		GI_STRING_DATA_TYPE& operator[](size_t index);
 
 		/**
 		 * @brief 拷贝字符串
 		 *
+		 * @note 开启GI_STRING_COPY_ON_WRITE时与str共享堆缓冲区
+		 * @note 不共享GiAllocator::isScoped()的分配器(如GiArenaAllocator)的缓冲区，复制到默认分配器。
+		 *  其他缓冲区复制时使用str的分配器。拷贝不受GiAllocatorScope影响，可以比作用域内的分配器存活更久
+		 *
 		 * @param str 被拷贝字符串
 		*/
-		virtual GiString& copy(const GiString& str);
+		GiString& copy(const GiString& str);
 
 		/**
 		 * @brief 拷贝字符串
@@ -277,7 +649,7 @@ namespace GiKoo
 		 * @param length 最大拷贝字符数
 		 *
 		*/
-		virtual GiString& copy(const GI_STRING_DATA_TYPE* str, size_t length = SIZE_MAX);
+		GiString& copy(const GI_STRING_DATA_TYPE* str, size_t length = SIZE_MAX);
 
 		/**
 		 * @brief 重载等号操作符
@@ -286,12 +658,92 @@ namespace GiKoo
 		 *
 		 * @return 自身引用
 		*/
-		virtual GiString& operator=(const GiString& str);
+		GiString& operator=(const GiString& str);
+
+		/**
+		 * @brief 重载移动赋值操作符，接管str的缓冲区
+		 *
+		 * @param str 移动元。赋值后变为空字符串
+		 *
+		 * @return 自身引用
+		*/
+		GiString& operator=(GiString&& str) noexcept;
 
 		/**
 		 * @brief 清空字符串
 		*/
-		virtual void empty();
+		void empty();
+
+		/**
+		 * @brief 原地移除字符串头部和尾部的指定符号
+		 *
+		 * @details 在自身缓冲区内移动数据，不申请内存。缓冲区被共享或引用静态数据时先复制。
+		 *  以下InPlace系列函数相同。
+		 *
+		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
+		 * @return 自身引用
+		 */
+		GiString& stripInPlace(const GI_STRING_DATA_TYPE* coll = nullptr);
+
+		/**
+		 * @brief 原地移除字符串头部的指定符号
+		 *
+		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
+		 * @return 自身引用
+		 */
+		GiString& stripLeadingInPlace(const GI_STRING_DATA_TYPE* coll = nullptr);
+
+		/**
+		 * @brief 原地移除字符串尾部的指定符号
+		 *
+		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
+		 * @return 自身引用
+		 */
+		GiString& stripTrailingInPlace(const GI_STRING_DATA_TYPE* coll = nullptr);
+
+		/**
+		 * @brief 原地移除字符串头部和尾部的小于等于0x20的字符
+		 *
+		 * @return 自身引用
+		 */
+		GiString& trimInPlace();
+
+		/**
+		 * @brief 原地移除字符串头部的小于等于0x20的字符
+		 *
+		 * @return 自身引用
+		 */
+		GiString& trimStartInPlace();
+
+		/**
+		 * @brief 原地移除字符串尾部的小于等于0x20的字符
+		 *
+		 * @return 自身引用
+		 */
+		GiString& trimEndInPlace();
+
+		/**
+		 * @brief 原地使用新字符替换旧字符
+		 *
+		 * @param oldChar 旧字符
+		 * @param newChar 新字符
+		 *
+		 * @return 自身引用
+		 */
+		GiString& replaceInPlace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar);
+
+		/**
+		 * @brief 原地使用新字符串替换旧字符串
+		 *
+		 * @details 新字符串不长于旧字符串时在自身缓冲区内从前向后压缩，不申请内存。
+		 *  新字符串较长、旧字符串为空或者参数就是自身时，与replace()相同生成新的缓冲区。
+		 *
+		 * @param oldStr 旧字符串
+		 * @param newStr 新字符串
+		 *
+		 * @return 自身引用
+		 */
+		GiString& replaceInPlace(const GiString& oldStr, const GiString& newStr);
 
 	public: // 查询类API
 
@@ -300,7 +752,16 @@ namespace GiKoo
 		 *
 		 * @return 返回内部数据变量
 		*/
-		virtual const GI_STRING_DATA_TYPE* c_str() const;
+		const GI_STRING_DATA_TYPE* c_str() const;
+
+		/**
+		 * @brief 获得指向自身内容的只读视图
+		 *
+		 * @note 修改或销毁自身后视图失效
+		 *
+		 * @return 视图
+		 */
+		GiStringView view() const;
 
 		/**
 		 * @brief 返回指定位置的字符
@@ -311,7 +772,7 @@ namespace GiKoo
 		 *
 		 * @return 字符
 		 */
-		virtual GI_STRING_DATA_TYPE charAt(size_t index) const;
+		GI_STRING_DATA_TYPE charAt(size_t index) const;
 
 		/**
 		 * @brief 查询指定字符
@@ -321,51 +782,98 @@ namespace GiKoo
 		 *
 		 * @return 查询结果。如果未查询到，返回SIZE_MAX
 		 */
-		virtual size_t indexOf(GI_STRING_DATA_TYPE ch, size_t offset = 0) const;
+		size_t indexOf(GI_STRING_DATA_TYPE ch, size_t offset = 0) const;
 
 		/**
 		 * @brief 查询指定字符串
 		 *
 		 * @param str 指定字符串
-		 * @param offset The specified index
+		 * @param offset 起点
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		size_t indexOf(const GiString& str, size_t offset = 0) const;
+
+		/**
+		 * @brief 查询预编译的字符串
+		 *
+		 * @param searcher 预编译的字符串
+		 * @param offset 起点
 		 *
 		 * @return 查询结果。如果未查询到，返回SIZE_MAX
 		 */
-		virtual size_t indexOf(const GiString& str, size_t offset = 0) const;
+		size_t indexOf(const GiSearcher& searcher, size_t offset = 0) const;
 
 		/**
 		 * @brief 倒序查询指定字符
 		 *
 		 * @param ch 指定字符
-		 * @param offset 判断的起点
+		 * @param offset 判断的起点，从该位置向前查询。默认从末尾开始
 		 *
 		 * @return 查询结果。如果未查询到，返回SIZE_MAX
 		 */
-		virtual size_t lastIndexOf(GI_STRING_DATA_TYPE ch, size_t offset = 0) const;
+		size_t lastIndexOf(GI_STRING_DATA_TYPE ch, size_t offset = SIZE_MAX) const;
 
 		/**
 		 * @brief 倒序查询指定字符串
 		 *
 		 * @param str 指定字符串
-		 * @param offset 判断的起点
+		 * @param offset 判断的起点，匹配的起始位置不大于该值。默认从末尾开始
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		size_t lastIndexOf(const GiString& str, size_t offset = SIZE_MAX) const;
+
+		/**
+		 * @brief 倒序查询预编译的字符串
+		 *
+		 * @param searcher 预编译的字符串
+		 * @param offset 判断的起点，匹配的起始位置不大于该值。默认从末尾开始
 		 *
 		 * @return 查询结果。如果未查询到，返回SIZE_MAX
 		 */
-		virtual size_t lastIndexOf(const GiString& str, size_t offset = 0) const;
+		size_t lastIndexOf(const GiSearcher& searcher, size_t offset = SIZE_MAX) const;
 
 		/**
 		 * @brief 获得字符串长度
 		 *
+		 * @note 长度随内容一起维护，时间复杂度O(1)
+		 *
 		 * @return 字符串长度
 		 */
-		virtual size_t length() const;
+		size_t length() const;
 
 		/**
 		 * @brief 获得字符串的hash数值
 		 *
-		 * @return hash数值
+		 * @details 基于wyhash，种子见GI_STRING_HASH_SEED。与Java的String.hash相同，
+		 *  首次计算后缓存在对象中，修改内容时失效，拷贝时随内容一起复制。
+		 *
+		 * @note 通过operator[]取得的引用在之后写入时不会使缓存失效，写入后需重新调用operator[]或赋值
+		 *
+		 * @return hash数值，与相同内容的GiStringView::hashCode()一致
 		 */
-		virtual size_t hashCode() const;
+		size_t hashCode() const;
+
+		/**
+		 * @brief 获得字符串在驻留池中的规范实例
+		 *
+		 * @details 与Java的String.intern()相同，内容相同的字符串返回同一个实例，共享同一块堆缓冲区，
+		 *  短字符串也不例外。两个驻留字符串之间的equals()只比较缓冲区地址。
+		 *  不论是否开启GI_STRING_COPY_ON_WRITE，驻留字符串的拷贝都共享缓冲区，修改时才复制出独立的缓冲区。
+		 *  驻留池按hash数值分片加锁，可在多个线程中同时调用。
+		 *
+		 * @return 规范实例的拷贝
+		 */
+		GiString intern() const;
+
+		/**
+		 * @brief 是否为驻留池中的规范实例（或其未修改的拷贝）
+		 *
+		 * @retval true 是
+		 * @retval false 否
+		 */
+		bool isInterned() const;
 
 		/**
 		 * @brief 是否包含指定前缀
@@ -376,7 +884,7 @@ namespace GiKoo
 		 * @retval true 包含
 		 * @retval false 不包含
 		 */
-		virtual bool startsWith(const GiString& prefix, size_t offset = SIZE_MAX) const;
+		bool startsWith(const GiString& prefix, size_t offset = 0) const;
 
 		/**
 		 * @brief 是否包含指定后缀
@@ -386,9 +894,224 @@ namespace GiKoo
 		 * @retval true 包含
 		 * @retval false 不包含
 		 */
-		virtual bool endsWith(const GiString& suffix) const;
+		bool endsWith(const GiString& suffix) const;
+
+		/**
+		 * @brief 是否包含指定前缀，前缀为编译期字符串时不需要构造临时对象
+		 *
+		 * @param prefix 前缀
+		 * @param offset 判断的起点
+		 *
+		 * @retval true 包含
+		 * @retval false 不包含
+		 */
+		bool startsWith(const GiStaticString& prefix, size_t offset = 0) const;
+
+		/**
+		 * @brief 是否包含指定后缀，后缀为编译期字符串时不需要构造临时对象
+		 *
+		 * @param suffix 后缀
+		 *
+		 * @retval true 包含
+		 * @retval false 不包含
+		 */
+		bool endsWith(const GiStaticString& suffix) const;
+
+		/**
+		 * @brief 获得全局内存统计
+		 *
+		 * @details 可在运行中随时查询，用于在长时间运行的测试中发现内存泄漏
+		 *
+		 * @return 统计快照
+		 */
+		static GiStringMemoryStats memoryStats();
+
+		/**
+		 * @brief 设置并行拆分的阈值
+		 *
+		 * @details 默认值为GI_STRING_PARALLEL_THRESHOLD。设为SIZE_MAX时总是串行拆分。
+		 *
+		 * @param bytes 使用并行版本的最小字节数
+		 */
+		static void setParallelThreshold(size_t bytes);
+
+		/**
+		 * @brief 获得并行拆分的阈值
+		 *
+		 * @return 使用并行版本的最小字节数
+		 */
+		static size_t parallelThreshold();
+
+		/**
+		 * @brief 获得驻留池统计
+		 *
+		 * @return 统计快照
+		 */
+		static GiStringInternStats internStats();
+
+		/**
+		 * @brief 移除只被驻留池引用的字符串
+		 *
+		 * @details 仍被其他对象引用的字符串保留在池中，因此不影响驻留字符串之间按地址比较的结果
+		 *
+		 * @return 移除的字符串个数
+		 */
+		static size_t purgeInterned();
+
+	private:
+		/**
+		 * @brief 将指定内容写入自身缓冲区
+		 *
+		 * @details 容量足够时复用现有缓冲区，否则重新申请并释放旧缓冲区。
+		 *  str可以指向自身缓冲区内部。
+		 *
+		 * @param str 数据起点
+		 * @param length 字符数（不含结束符）
+		 */
+		void assign(const GI_STRING_DATA_TYPE* str, size_t length);
+
+		/**
+		 * @brief 释放缓冲区
+		 */
+		void release();
+
+		/**
+		 * @brief 接管str的缓冲区，str变为空字符串
+		 *
+		 * @note 调用前自身不能持有堆内存
+		 */
+		void take(GiString& str) noexcept;
+
+		/**
+		 * @brief 如果堆缓冲区被其他对象共享，复制出独立的缓冲区
+		 */
+		void detach();
+
+		/**
+		 * @brief 只保留[offset, offset + length)之间的内容，独占缓冲区时原地移动
+		 *
+		 * @param offset 保留部分的起点
+		 * @param length 保留部分的字符数
+		 */
+		void keep(size_t offset, size_t length);
+
+		/**
+		 * @brief 确保独占缓冲区，且至少可容纳capacity个字符，保留现有内容
+		 *
+		 * @param capacity 字符数，不含结束符
+		 */
+		void reserve(size_t capacity);
+
+		/**
+		 * @brief 堆缓冲区是否被其他对象共享
+		 */
+		bool isShared() const;
+
+		/**
+		 * @brief 数据是否保存在对象内部
+		 */
+		bool isLocal() const;
+
+		/**
+		 * @brief 是否引用静态数据，见GiString(const GiStaticString&)
+		 */
+		bool isStatic() const;
+
+		/**
+		 * @brief 当前缓冲区可容纳的字符数，不含结束符。静态数据不可写，为0
+		 */
+		size_t capacity() const;
+
+		/**
+		 * @brief 计算hash数值并缓存
+		 */
+		size_t computeHashCode() const;
 
 	private:
-		GI_STRING_DATA_TYPE* m_data;
+		GI_STRING_DATA_TYPE* m_data;	// 字符串数据，总是以'\0'结尾。指向m_local或者堆内存
+		size_t m_length;				// 字符串长度，不含结束符
+		mutable std::atomic<size_t> m_hash;	// 缓存的hash数值，0表示尚未计算
+
+		union
+		{
+			size_t m_capacity;			// 堆内存可容纳的字符数，不含结束符，至少为1。为0时m_data指向只读的静态数据
+			GI_STRING_DATA_TYPE m_local[GI_STRING_SSO_CAPACITY + 1];	// 短字符串的内联缓冲区
+		};
+	};
+
+	// 以下成员位于热点路径，定义在头文件中以便在调用处内联。view()定义在gi_string_view.h中
+
+	inline bool GiString::operator==(const GiString& another) const
+	{
+		return equals(another);
+	}
+
+	inline bool GiString::operator!=(const GiString& another) const
+	{
+		return !equals(another);
+	}
+
+	inline bool GiString::operator<(const GiString& another) const
+	{
+		return compareTo(another) < 0;
+	}
+
+	inline bool GiString::isEmpty() const
+	{
+		return m_length == 0;
+	}
+
+	inline const GI_STRING_DATA_TYPE* GiString::c_str() const
+	{
+		return m_data;
+	}
+
+	inline GI_STRING_DATA_TYPE GiString::charAt(size_t index) const
+	{
+		assert(m_data != nullptr);
+		if (index >= m_length) return 0;
+		return m_data[index];
+	}
+
+	inline size_t GiString::length() const
+	{
+		return m_length;
+	}
+
+	inline size_t GiString::hashCode() const
+	{
+		// 与Java相同，0表示尚未计算。多个线程同时计算时得到相同的结果，不需要加锁
+		size_t hash = m_hash.load(std::memory_order_relaxed);
+		return hash != 0 ? hash : computeHashCode();
+	}
+
+	inline bool GiString::isLocal() const
+	{
+		return m_data == m_local;
+	}
+
+	inline bool GiString::isStatic() const
+	{
+		return !isLocal() && m_capacity == 0;
+	}
+
+	inline size_t GiString::capacity() const
+	{
+		return isLocal() ? GI_STRING_SSO_CAPACITY : m_capacity;
+	}
+}
+
+namespace std
+{
+	/**
+	 * @brief 使GiString可以作为std::unordered_map等容器的键
+	 */
+	template <>
+	struct hash<GiKoo::GiString>
+	{
+		size_t operator()(const GiKoo::GiString& str) const
+		{
+			return str.hashCode();
+		}
 	};
 }
\ No newline at end of file
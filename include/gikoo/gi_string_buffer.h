@@ -0,0 +1,209 @@
+﻿/**
+ * @brief GiKoo线程安全的字符串构建类
+ *
+ * @file gi_string_buffer.h
+ *
+ * @details
+ *  1. API参考的Java文档版本:
+ *      a. https://docs.oracle.com/en/java/javase/19/docs/api/java.base/java/lang/StringBuffer.html
+ *
+ *  2. 所有API都可以并发调用。
+ *  3. 追加操作先写入当前线程对应的暂存分片，每个分片有独立的锁，多个线程并发追加时互不等待。
+ *     分片积累到一定大小，或者调用需要完整内容的API时，才合并到主缓冲区。
+ *  4. 每次追加都是原子的，同一线程的追加顺序保持不变；不同线程的追加以批为单位合并，
+ *     彼此之间的先后顺序不保证与调用时间一致。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gikoo/gi_string_builder.h"
+#include <mutex>
+
+namespace GiKoo
+{
+	/**
+	 * @brief GiStringBuffer类
+	 *
+	 * @details 多线程共享的字符串缓冲区，例如多个线程写入同一份日志。
+	 */
+	class GiStringBuffer
+	{
+	public:
+		/**
+		 * @brief 创建空的缓冲区
+		 */
+		GiStringBuffer();
+
+		/**
+		 * @brief 创建空的缓冲区，预留指定容量
+		 *
+		 * @param capacity 预留的字符数
+		 */
+		explicit GiStringBuffer(size_t capacity);
+
+		GiStringBuffer(const GiStringBuffer&) = delete;
+		GiStringBuffer& operator=(const GiStringBuffer&) = delete;
+
+	public: // 修改类API
+		/**
+		 * @brief 追加字符串
+		 *
+		 * @param str 待追加的字符串
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& append(const GiString& str);
+
+		/**
+		 * @brief 追加字符串
+		 *
+		 * @param str 待追加的字符串
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& append(const GiStringView& str);
+
+		/**
+		 * @brief 追加C字符串
+		 *
+		 * @param str 以'\0'结尾的字符串。为nullptr时不追加
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& append(const GI_STRING_DATA_TYPE* str);
+
+		/**
+		 * @brief 追加指定长度的字符
+		 *
+		 * @param str 数据起点
+		 * @param length 字符数
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& append(const GI_STRING_DATA_TYPE* str, size_t length);
+
+		/**
+		 * @brief 追加字符
+		 *
+		 * @param ch 待追加的字符
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& append(GI_STRING_DATA_TYPE ch);
+
+		/**
+		 * @brief 追加整数的十进制表示
+		 *
+		 * @param value 待追加的整数
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& append(int value);
+		GiStringBuffer& append(unsigned int value);
+		GiStringBuffer& append(long value);
+		GiStringBuffer& append(unsigned long value);
+		GiStringBuffer& append(long long value);
+		GiStringBuffer& append(unsigned long long value);
+
+		/**
+		 * @brief 在指定位置插入字符串
+		 *
+		 * @note 需要合并所有分片，会阻塞其他线程
+		 *
+		 * @param offset 插入位置。超出长度时追加到末尾
+		 * @param str 待插入的字符串
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& insert(size_t offset, const GiStringView& str);
+
+		/**
+		 * @brief 在指定位置插入字符
+		 *
+		 * @note 需要合并所有分片，会阻塞其他线程
+		 *
+		 * @param offset 插入位置。超出长度时追加到末尾
+		 * @param ch 待插入的字符
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& insert(size_t offset, GI_STRING_DATA_TYPE ch);
+
+		/**
+		 * @brief 删除指定位置的字符
+		 *
+		 * @note 需要合并所有分片，会阻塞其他线程
+		 *
+		 * @param index 指定位置。非法时不做任何修改
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& deleteCharAt(size_t index);
+
+		/**
+		 * @brief 反转字符顺序
+		 *
+		 * @note 需要合并所有分片，会阻塞其他线程
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuffer& reverse();
+
+		/**
+		 * @brief 清空内容
+		 */
+		void clear();
+
+	public: // 查询类API
+		/**
+		 * @brief 获得当前长度，包含尚未合并的内容
+		 *
+		 * @return 字符数
+		 */
+		size_t length() const;
+
+		/**
+		 * @brief 合并所有分片，获得当前内容
+		 *
+		 * @return 字符串
+		 */
+		GiString toString() const;
+
+	private:
+		static const size_t SHARD_COUNT = 16;			// 暂存分片数
+		static const size_t FLUSH_THRESHOLD = 4096;		// 分片积累到该长度时合并到主缓冲区
+
+		/**
+		 * @brief 暂存分片
+		 */
+		struct Shard
+		{
+			std::mutex lock;			// 保护staging
+			GiStringBuilder staging;	// 尚未合并的内容
+			char padding[64];			// 避免相邻分片的伪共享
+		};
+
+		/**
+		 * @brief 锁定所有分片和主缓冲区，并合并所有分片
+		 */
+		class FlushGuard;
+
+		/**
+		 * @brief 当前线程对应的分片
+		 */
+		Shard& localShard() const;
+
+		/**
+		 * @brief 在当前线程的分片中追加
+		 */
+		GiStringBuffer& appendLocal(const GI_STRING_DATA_TYPE* str, size_t length);
+
+	private:
+		mutable std::mutex m_lock;				// 保护m_merged。加锁顺序: 分片（按序号） -> m_lock
+		mutable GiStringBuilder m_merged;		// 主缓冲区
+		mutable Shard m_shards[SHARD_COUNT];	// 暂存分片
+	};
+}
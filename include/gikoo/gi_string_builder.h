@@ -0,0 +1,230 @@
+﻿/**
+ * @brief GiKoo字符串构建类
+ *
+ * @file gi_string_builder.h
+ *
+ * @details
+ *  1. API参考的Java文档版本:
+ *      a. https://docs.oracle.com/en/java/javase/19/docs/api/java.base/java/lang/StringBuilder.html
+ *
+ *  2. 内部使用GiString的缓冲区，容量不足时按2倍扩容，追加操作的均摊时间复杂度为O(1)。
+ *  3. 非线程安全。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+
+namespace GiKoo
+{
+	/**
+	 * @brief GiStringBuilder类
+	 *
+	 * @details 用于逐步构建字符串，避免每次拼接都申请新的内存。
+	 */
+	class GiStringBuilder
+	{
+	public:
+		/**
+		 * @brief 创建空的构建器
+		 */
+		GiStringBuilder();
+
+		/**
+		 * @brief 创建空的构建器，预留指定容量
+		 *
+		 * @param capacity 预留的字符数
+		 */
+		explicit GiStringBuilder(size_t capacity);
+
+		/**
+		 * @brief 以指定内容创建构建器
+		 *
+		 * @param str 初始内容
+		 */
+		explicit GiStringBuilder(const GiStringView& str);
+
+	public: // 修改类API
+		/**
+		 * @brief 追加字符串
+		 *
+		 * @param str 待追加的字符串
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& append(const GiString& str);
+
+		/**
+		 * @brief 追加字符串
+		 *
+		 * @param str 待追加的字符串
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& append(const GiStringView& str);
+
+		/**
+		 * @brief 追加C字符串
+		 *
+		 * @param str 以'\0'结尾的字符串。为nullptr时不追加
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& append(const GI_STRING_DATA_TYPE* str);
+
+		/**
+		 * @brief 追加指定长度的字符
+		 *
+		 * @param str 数据起点
+		 * @param length 字符数
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& append(const GI_STRING_DATA_TYPE* str, size_t length);
+
+		/**
+		 * @brief 追加字符
+		 *
+		 * @param ch 待追加的字符
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& append(GI_STRING_DATA_TYPE ch);
+
+		/**
+		 * @brief 追加整数的十进制表示
+		 *
+		 * @param value 待追加的整数
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& append(int value);
+		GiStringBuilder& append(unsigned int value);
+		GiStringBuilder& append(long value);
+		GiStringBuilder& append(unsigned long value);
+		GiStringBuilder& append(long long value);
+		GiStringBuilder& append(unsigned long long value);
+
+		/**
+		 * @brief 在指定位置插入字符串
+		 *
+		 * @param offset 插入位置。超出长度时追加到末尾
+		 * @param str 待插入的字符串
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& insert(size_t offset, const GiStringView& str);
+
+		/**
+		 * @brief 在指定位置插入字符
+		 *
+		 * @param offset 插入位置。超出长度时追加到末尾
+		 * @param ch 待插入的字符
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& insert(size_t offset, GI_STRING_DATA_TYPE ch);
+
+		/**
+		 * @brief 删除指定位置的字符
+		 *
+		 * @param index 指定位置。非法时不做任何修改
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& deleteCharAt(size_t index);
+
+		/**
+		 * @brief 反转字符顺序
+		 *
+		 * @return 自身引用
+		 */
+		GiStringBuilder& reverse();
+
+		/**
+		 * @brief 确保至少可容纳指定数量的字符
+		 *
+		 * @param capacity 字符数，不含结束符
+		 */
+		void reserve(size_t capacity);
+
+		/**
+		 * @brief 清空内容，保留容量
+		 */
+		void clear();
+
+	public: // 查询类API
+		/**
+		 * @brief 获得当前长度
+		 *
+		 * @return 字符数
+		 */
+		size_t length() const;
+
+		/**
+		 * @brief 获得当前容量
+		 *
+		 * @return 不扩容时可容纳的字符数
+		 */
+		size_t capacity() const;
+
+		/**
+		 * @brief 返回指定位置的字符
+		 *
+		 * @note 如果index是非法数值，将返回0
+		 *
+		 * @param index 指定位置
+		 *
+		 * @return 字符
+		 */
+		GI_STRING_DATA_TYPE charAt(size_t index) const;
+
+		/**
+		 * @brief 获得指向当前内容的只读视图
+		 *
+		 * @note 修改构建器后视图失效
+		 *
+		 * @return 视图
+		 */
+		GiStringView view() const;
+
+		/**
+		 * @brief 获得当前内容
+		 *
+		 * @note 开启GI_STRING_COPY_ON_WRITE时与构建器共享缓冲区，构建器下次修改时才复制
+		 *
+		 * @return 字符串
+		 */
+		GiString toString() const &;
+
+		/**
+		 * @brief 交出缓冲区，不拷贝
+		 *
+		 * @note 调用后构建器为空
+		 *
+		 * @return 字符串
+		 */
+		GiString toString() &&;
+
+	private:
+		/**
+		 * @brief 确保可以再追加length个字符，容量不足时按2倍扩容
+		 *
+		 * @return 追加位置
+		 */
+		GI_STRING_DATA_TYPE* grow(size_t length);
+
+		/**
+		 * @brief 追加无符号整数的十进制表示
+		 *
+		 * @param value 绝对值
+		 * @param negative 是否为负数
+		 */
+		GiStringBuilder& appendInteger(unsigned long long value, bool negative);
+
+	private:
+		GiString m_str;	// 缓冲区
+	};
+}
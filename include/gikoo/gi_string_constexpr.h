@@ -0,0 +1,221 @@
+﻿/**
+ * @brief GiKoo字符串的编译期算法
+ *
+ * @file gi_string_constexpr.h
+ *
+ * @details
+ *  1. 逐字节实现的长度、比较、查找和hash算法，均为constexpr，可在编译期对字面量求值。
+ *  2. hash()与GiString::hashCode()使用的wyhash逐位一致（小端平台），编译期得到的数值可直接与运行期比较。
+ *  3. GI_STRING_HEADER_ONLY开启时GiStringView的查询函数基于这些算法实现，
+ *     编译器支持时运行期仍调用库中的SIMD实现，见GI_STRING_CONSTANT_EVALUATED()。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include <cstdint>
+
+/**
+ * @brief 当前是否处于常量求值中
+ *
+ * @details 编译器不支持__builtin_is_constant_evaluated时总是为true，即运行期也使用逐字节的实现
+ */
+#if defined(__clang__)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define GI_STRING_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#elif defined(__GNUC__)
+#if __GNUC__ >= 9
+#define GI_STRING_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#elif defined(_MSC_VER)
+#if _MSC_VER >= 1925
+#define GI_STRING_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+
+#ifndef GI_STRING_CONSTANT_EVALUATED
+#define GI_STRING_CONSTANT_EVALUATED() true
+#endif
+
+namespace GiKoo
+{
+	namespace Constexpr
+	{
+		/**
+		 * @brief 计算以'\0'结尾的字符串的长度
+		 */
+		constexpr size_t length(const GI_STRING_DATA_TYPE* str)
+		{
+			size_t i = 0;
+			while (str[i] != 0) ++i;
+			return i;
+		}
+
+		/**
+		 * @brief 比较两段等长的数据
+		 */
+		constexpr bool equal(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length)
+		{
+			for (size_t i = 0; i < length; ++i)
+			{
+				if (a[i] != b[i]) return false;
+			}
+			return true;
+		}
+
+		/**
+		 * @brief 查找指定字符
+		 *
+		 * @return 第一次出现的位置，未找到时返回SIZE_MAX
+		 */
+		constexpr size_t findChar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+		{
+			for (size_t i = 0; i < length; ++i)
+			{
+				if (data[i] == ch) return i;
+			}
+			return SIZE_MAX;
+		}
+
+		/**
+		 * @brief 查找指定字符串
+		 *
+		 * @return 第一次出现的位置。needleLength为0时返回0，未找到时返回SIZE_MAX
+		 */
+		constexpr size_t find(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength)
+		{
+			if (needleLength > length) return SIZE_MAX;
+			for (size_t i = 0; i + needleLength <= length; ++i)
+			{
+				if (equal(data + i, needle, needleLength)) return i;
+			}
+			return SIZE_MAX;
+		}
+
+		/**
+		 * @brief wyhash使用的常量
+		 */
+		constexpr uint64_t secret(size_t index)
+		{
+			return index == 0 ? 0x2d358dccaa6c78a5ull
+				: index == 1 ? 0x8bb84b93962eacc9ull
+				: index == 2 ? 0x4b33a62ed433d4a3ull
+				: 0x4d5a2da51de1aa47ull;
+		}
+
+		/**
+		 * @brief 64位乘法得到的128位乘积
+		 */
+		struct Product
+		{
+			uint64_t low;
+			uint64_t high;
+		};
+
+		constexpr Product multiply(uint64_t a, uint64_t b)
+		{
+#if defined(__SIZEOF_INT128__)
+			__uint128_t product = (__uint128_t)a * b;
+			return Product{ (uint64_t)product, (uint64_t)(product >> 64) };
+#else
+			uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+			uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+			uint64_t t = rl + (rm0 << 32);
+			uint64_t carry = t < rl;
+			uint64_t lo = t + (rm1 << 32);
+			carry += lo < t;
+			return Product{ lo, rh + (rm0 >> 32) + (rm1 >> 32) + carry };
+#endif
+		}
+
+		/**
+		 * @brief 相乘后将高低位异或
+		 */
+		constexpr uint64_t mix(uint64_t a, uint64_t b)
+		{
+			Product product = multiply(a, b);
+			return product.low ^ product.high;
+		}
+
+		/**
+		 * @brief 按小端序读取4个字节
+		 *
+		 * @note 写成逐字节的表达式而不是循环，编译器在运行期可将其合并为一次整字读取
+		 */
+		constexpr uint64_t read4(const GI_STRING_DATA_TYPE* p)
+		{
+			return (uint64_t)(unsigned char)p[0] | ((uint64_t)(unsigned char)p[1] << 8)
+				| ((uint64_t)(unsigned char)p[2] << 16) | ((uint64_t)(unsigned char)p[3] << 24);
+		}
+
+		/**
+		 * @brief 按小端序读取8个字节
+		 */
+		constexpr uint64_t read8(const GI_STRING_DATA_TYPE* p)
+		{
+			return read4(p) | (read4(p + 4) << 32);
+		}
+
+		/**
+		 * @brief 计算hash数值，与运行期的实现结果相同
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param seed 种子
+		 *
+		 * @return hash数值
+		 */
+		constexpr uint64_t hash(const GI_STRING_DATA_TYPE* data, size_t length, uint64_t seed)
+		{
+			const GI_STRING_DATA_TYPE* p = data;
+			seed ^= mix(seed ^ secret(0), secret(1));
+
+			uint64_t a = 0;
+			uint64_t b = 0;
+			if (length <= 16)
+			{
+				if (length >= 4)
+				{
+					size_t shift = (length >> 3) << 2;
+					a = (read4(p) << 32) | read4(p + shift);
+					b = (read4(p + length - 4) << 32) | read4(p + length - 4 - shift);
+				}
+				else if (length > 0)
+				{
+					a = ((uint64_t)(unsigned char)p[0] << 16) | ((uint64_t)(unsigned char)p[length >> 1] << 8) | (unsigned char)p[length - 1];
+				}
+			}
+			else
+			{
+				size_t i = length;
+				if (i > 48)
+				{
+					uint64_t seed1 = seed;
+					uint64_t seed2 = seed;
+					do
+					{
+						seed = mix(read8(p) ^ secret(1), read8(p + 8) ^ seed);
+						seed1 = mix(read8(p + 16) ^ secret(2), read8(p + 24) ^ seed1);
+						seed2 = mix(read8(p + 32) ^ secret(3), read8(p + 40) ^ seed2);
+						p += 48;
+						i -= 48;
+					} while (i > 48);
+					seed ^= seed1 ^ seed2;
+				}
+				while (i > 16)
+				{
+					seed = mix(read8(p) ^ secret(1), read8(p + 8) ^ seed);
+					p += 16;
+					i -= 16;
+				}
+				a = read8(p + i - 16);
+				b = read8(p + i - 8);
+			}
+
+			Product product = multiply(a ^ secret(1), b ^ seed);
+			return mix(product.low ^ secret(0) ^ length, product.high ^ secret(1));
+		}
+	}
+}
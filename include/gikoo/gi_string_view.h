@@ -0,0 +1,455 @@
+﻿/**
+ * @brief GiKoo字符串视图类
+ *
+ * @file gi_string_view.h
+ *
+ * @details
+ *  1. 只保存指针和长度，不持有内存，不申请内存。
+ *  2. 提供GiString的只读查询API，以及返回视图的子串、裁剪API，适用于不需要副本的解析场景。
+ *  3. 视图不保证以'\0'结尾。被引用的数据必须比视图存活得更久。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+
+#if GI_STRING_HEADER_ONLY
+#include "gikoo/gi_string_constexpr.h"
+#include <cstring>
+
+#if GI_STRING_HASH_RANDOM_SEED
+#error "GI_STRING_HEADER_ONLY cannot be combined with GI_STRING_HASH_RANDOM_SEED"
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "GI_STRING_HEADER_ONLY requires a little-endian target"
+#endif
+
+#define GI_STRING_CONSTEXPR constexpr
+#else
+#define GI_STRING_CONSTEXPR
+#endif
+
+namespace GiKoo
+{
+	/**
+	 * @brief GiStringView类
+	 *
+	 * @details 指向一段字符数据的只读视图。
+	 *  data()、length()等访问器总是constexpr，开启GI_STRING_HEADER_ONLY时查询函数也是constexpr。
+	 */
+	class GiStringView
+	{
+	public:
+		/**
+		 * @brief 创建空视图
+		 */
+		constexpr GiStringView();
+
+		/**
+		 * @brief 创建指向C字符串的视图
+		 *
+		 * @param str 以'\0'结尾的字符串。为nullptr时创建空视图
+		 */
+		GI_STRING_CONSTEXPR GiStringView(const GI_STRING_DATA_TYPE* str);
+
+		/**
+		 * @brief 创建指向指定数据的视图
+		 *
+		 * @param str 数据起点
+		 * @param length 字符数
+		 */
+		constexpr GiStringView(const GI_STRING_DATA_TYPE* str, size_t length);
+
+		/**
+		 * @brief 创建指向GiString内容的视图
+		 *
+		 * @note 修改或销毁str后视图失效
+		 *
+		 * @param str 被引用的字符串
+		 */
+		GiStringView(const GiString& str);
+
+	public: // 判断类API
+		/**
+		 * @brief 比较两个字符串
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @retval true 两个字符串相等
+		 * @retval false 两个字符串不等
+		 */
+		GI_STRING_CONSTEXPR bool equals(const GiStringView& another) const;
+
+		/**
+		 * @brief 比较两个字符串
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @retval true 两个字符串相等
+		 * @retval false 两个字符串不等
+		 */
+		GI_STRING_CONSTEXPR bool operator==(const GiStringView& another) const;
+
+		/**
+		 * @brief 比较两个字符串
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @retval true 两个字符串不等
+		 * @retval false 两个字符串相等
+		 */
+		GI_STRING_CONSTEXPR bool operator!=(const GiStringView& another) const;
+
+		/**
+		 * @brief 按字典序比较两个字符串
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @return 与GiString::compareTo()相同
+		 */
+		int compareTo(const GiStringView& another) const;
+
+		/**
+		 * @brief 按字典序比较两个字符串
+		 *
+		 * @param another 待比较的字符串
+		 *
+		 * @retval true 本字符串较小
+		 * @retval false 本字符串不小于another
+		 */
+		bool operator<(const GiStringView& another) const;
+
+		/**
+		 * @brief 是否包含指定字符串
+		 *
+		 * @param str 指定字符串
+		 *
+		 * @retval true 包含指定字符串
+		 * @retval false 不包含指定字符串
+		 */
+		bool contains(const GiStringView& str) const;
+
+		/**
+		 * @brief 字符串是否为空，或者只包含空格
+		 *
+		 * @retval true 字符串为空，或者只包含空格
+		 * @retval false 字符串包含非空格字符
+		 */
+		bool isBlank() const;
+
+		/**
+		 * @brief 字符串是否为空，即长度为0
+		 *
+		 * @retval true 空字符串
+		 * @retval false 非空字符串
+		 */
+		constexpr bool isEmpty() const;
+
+		/**
+		 * @brief 是否包含指定前缀
+		 *
+		 * @param prefix 前缀
+		 * @param offset 判断的起点
+		 *
+		 * @retval true 包含
+		 * @retval false 不包含
+		 */
+		GI_STRING_CONSTEXPR bool startsWith(const GiStringView& prefix, size_t offset = 0) const;
+
+		/**
+		 * @brief 是否包含指定后缀
+		 *
+		 * @param suffix 后缀
+		 *
+		 * @retval true 包含
+		 * @retval false 不包含
+		 */
+		GI_STRING_CONSTEXPR bool endsWith(const GiStringView& suffix) const;
+
+	public: // 返回新视图
+		/**
+		 * @brief 移除头部和尾部的指定符号
+		 *
+		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
+		 * @return 裁剪后的视图
+		 */
+		GiStringView strip(const GI_STRING_DATA_TYPE* coll = nullptr) const;
+
+		/**
+		 * @brief 移除头部的指定符号
+		 *
+		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
+		 * @return 裁剪后的视图
+		 */
+		GiStringView stripLeading(const GI_STRING_DATA_TYPE* coll = nullptr) const;
+
+		/**
+		 * @brief 移除尾部的指定符号
+		 *
+		 * @param coll 需要剔除的符号字符串。默认为" \r\n\t"
+		 * @return 裁剪后的视图
+		 */
+		GiStringView stripTrailing(const GI_STRING_DATA_TYPE* coll = nullptr) const;
+
+		/**
+		 * @brief 移除头部和尾部的小于等于0x20的字符
+		 *
+		 * @return 裁剪后的视图
+		 */
+		GiStringView trim() const;
+
+		/**
+		 * @brief 移除头部的小于等于0x20的字符
+		 *
+		 * @return 裁剪后的视图
+		 */
+		GiStringView trimStart() const;
+
+		/**
+		 * @brief 移除尾部的小于等于0x20的字符
+		 *
+		 * @return 裁剪后的视图
+		 */
+		GiStringView trimEnd() const;
+
+		/**
+		 * @brief 获取子串视图
+		 *
+		 * @param offset 起点。超出范围时返回空视图
+		 * @param length 长度
+		 *
+		 * @return 子串视图
+		 */
+		GiStringView subString(size_t offset, size_t length = SIZE_MAX) const;
+
+		/**
+		 * @brief 拷贝为GiString
+		 *
+		 * @return 新的字符串副本
+		 */
+		GiString toString() const;
+
+	public: // 查询类API
+		/**
+		 * @brief 数据指针
+		 *
+		 * @note 不保证以'\0'结尾
+		 *
+		 * @return 数据起点
+		 */
+		constexpr const GI_STRING_DATA_TYPE* data() const;
+
+		/**
+		 * @brief 返回指定位置的字符
+		 *
+		 * @note 如果index是非法数值，将返回0
+		 *
+		 * @param index 指定位置
+		 *
+		 * @return 字符
+		 */
+		constexpr GI_STRING_DATA_TYPE charAt(size_t index) const;
+
+		/**
+		 * @brief 查询指定字符
+		 *
+		 * @param ch 指定字符
+		 * @param offset 起点
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		GI_STRING_CONSTEXPR size_t indexOf(GI_STRING_DATA_TYPE ch, size_t offset = 0) const;
+
+		/**
+		 * @brief 查询指定字符串
+		 *
+		 * @param str 指定字符串
+		 * @param offset 起点
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		GI_STRING_CONSTEXPR size_t indexOf(const GiStringView& str, size_t offset = 0) const;
+
+		/**
+		 * @brief 倒序查询指定字符
+		 *
+		 * @param ch 指定字符
+		 * @param offset 判断的起点，从该位置向前查询。默认从末尾开始
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		size_t lastIndexOf(GI_STRING_DATA_TYPE ch, size_t offset = SIZE_MAX) const;
+
+		/**
+		 * @brief 倒序查询指定字符串
+		 *
+		 * @param str 指定字符串
+		 * @param offset 判断的起点，匹配的起始位置不大于该值。默认从末尾开始
+		 *
+		 * @return 查询结果。如果未查询到，返回SIZE_MAX
+		 */
+		size_t lastIndexOf(const GiStringView& str, size_t offset = SIZE_MAX) const;
+
+		/**
+		 * @brief 获得字符串长度
+		 *
+		 * @return 字符串长度
+		 */
+		constexpr size_t length() const;
+
+		/**
+		 * @brief 获得字符串的hash数值
+		 *
+		 * @details 算法与GiString::hashCode()相同，但不缓存，每次重新计算
+		 *
+		 * @return hash数值，与相同内容的GiString::hashCode()一致
+		 */
+		GI_STRING_CONSTEXPR size_t hashCode() const;
+
+	private:
+		/**
+		 * @brief 比较两段等长的数据，使用SIMD实现
+		 */
+		static bool equal(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length);
+
+		/**
+		 * @brief 查找指定字符，使用SIMD实现
+		 *
+		 * @return 第一次出现的位置，未找到时返回SIZE_MAX
+		 */
+		static size_t findChar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+
+		/**
+		 * @brief 查找指定字符串，按长度选择算法
+		 *
+		 * @return 第一次出现的位置。needleLength为0时返回0，未找到时返回SIZE_MAX
+		 */
+		static size_t find(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength);
+
+	private:
+		const GI_STRING_DATA_TYPE* m_data;	// 数据起点
+		size_t m_length;					// 字符数
+	};
+
+	// 以下成员位于热点路径，定义在头文件中以便在调用处内联
+
+	constexpr GiStringView::GiStringView()
+		: m_data(""), m_length(0)
+	{
+	}
+
+	constexpr GiStringView::GiStringView(const GI_STRING_DATA_TYPE* str, size_t length)
+		: m_data(str ? str : ""), m_length(str ? length : 0)
+	{
+	}
+
+	inline GiStringView::GiStringView(const GiString& str)
+		: m_data(str.c_str()), m_length(str.length())
+	{
+	}
+
+	constexpr bool GiStringView::isEmpty() const
+	{
+		return m_length == 0;
+	}
+
+	constexpr const GI_STRING_DATA_TYPE* GiStringView::data() const
+	{
+		return m_data;
+	}
+
+	constexpr GI_STRING_DATA_TYPE GiStringView::charAt(size_t index) const
+	{
+		return index < m_length ? m_data[index] : 0;
+	}
+
+	constexpr size_t GiStringView::length() const
+	{
+		return m_length;
+	}
+
+#if GI_STRING_HEADER_ONLY
+	// 常量求值时使用Constexpr中的逐字节实现，运行期调用库中的SIMD实现
+
+	constexpr GiStringView::GiStringView(const GI_STRING_DATA_TYPE* str)
+		: m_data(str ? str : ""), m_length(!str ? 0 : GI_STRING_CONSTANT_EVALUATED() ? Constexpr::length(str) : strlen(str))
+	{
+	}
+
+	constexpr bool GiStringView::equals(const GiStringView& another) const
+	{
+		if (m_length != another.m_length) return false;
+		if (GI_STRING_CONSTANT_EVALUATED()) return Constexpr::equal(m_data, another.m_data, m_length);
+		return m_data == another.m_data || equal(m_data, another.m_data, m_length);
+	}
+
+	constexpr bool GiStringView::operator==(const GiStringView& another) const
+	{
+		return equals(another);
+	}
+
+	constexpr bool GiStringView::operator!=(const GiStringView& another) const
+	{
+		return !equals(another);
+	}
+
+	constexpr bool GiStringView::startsWith(const GiStringView& prefix, size_t offset) const
+	{
+		if (offset > m_length || prefix.m_length > m_length - offset) return false;
+		if (GI_STRING_CONSTANT_EVALUATED()) return Constexpr::equal(m_data + offset, prefix.m_data, prefix.m_length);
+		return equal(m_data + offset, prefix.m_data, prefix.m_length);
+	}
+
+	constexpr bool GiStringView::endsWith(const GiStringView& suffix) const
+	{
+		if (suffix.m_length > m_length) return false;
+		if (GI_STRING_CONSTANT_EVALUATED()) return Constexpr::equal(m_data + m_length - suffix.m_length, suffix.m_data, suffix.m_length);
+		return equal(m_data + m_length - suffix.m_length, suffix.m_data, suffix.m_length);
+	}
+
+	constexpr size_t GiStringView::indexOf(GI_STRING_DATA_TYPE ch, size_t offset) const
+	{
+		if (offset >= m_length) return SIZE_MAX;
+
+		size_t found = GI_STRING_CONSTANT_EVALUATED() ? Constexpr::findChar(m_data + offset, m_length - offset, ch) : findChar(m_data + offset, m_length - offset, ch);
+		return found == SIZE_MAX ? SIZE_MAX : offset + found;
+	}
+
+	constexpr size_t GiStringView::indexOf(const GiStringView& str, size_t offset) const
+	{
+		if (offset > m_length) return SIZE_MAX;
+
+		size_t found = GI_STRING_CONSTANT_EVALUATED() ? Constexpr::find(m_data + offset, m_length - offset, str.m_data, str.m_length) : find(m_data + offset, m_length - offset, str.m_data, str.m_length);
+		return found == SIZE_MAX ? SIZE_MAX : offset + found;
+	}
+
+	constexpr size_t GiStringView::hashCode() const
+	{
+		// Constexpr::read8()等逐字节表达式会被GCC、Clang合并为整字读取，运行期无需另行分派
+		return (size_t)Constexpr::hash(m_data, m_length, GI_STRING_HASH_SEED);
+	}
+#endif
+
+	// 返回值类型在此处才完整，因此GiString::view()定义在本文件中
+	inline GiStringView GiString::view() const
+	{
+		return GiStringView(m_data, m_length);
+	}
+}
+
+namespace std
+{
+	/**
+	 * @brief 使GiStringView可以作为std::unordered_map等容器的键，与std::hash<GiString>一致
+	 */
+	template <>
+	struct hash<GiKoo::GiStringView>
+	{
+		size_t operator()(const GiKoo::GiStringView& str) const
+		{
+			return str.hashCode();
+		}
+	};
+}
@@ -0,0 +1,428 @@
+﻿#include "gikoo/gi_allocator.h"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <unordered_map>
+
+#define MIN(x,y) (x < y ? x : y)
+#define MAX(x,y) (x > y ? x : y)
+
+using namespace GiKoo;
+
+namespace
+{
+	const size_t ALIGNMENT = alignof(std::max_align_t);
+
+	size_t alignUp(size_t size)
+	{
+		return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	/**
+	 * @brief 使用全局new/delete的分配器
+	 */
+	class GiNewAllocator : public GiAllocator
+	{
+	public:
+		void* allocate(size_t size) override
+		{
+			return ::operator new(size);
+		}
+
+		void deallocate(void* ptr, size_t size) override
+		{
+			(void)size;
+			::operator delete(ptr);
+		}
+	};
+
+	thread_local GiAllocator* s_current = nullptr;
+}
+
+GiAllocator::~GiAllocator()
+{
+}
+
+bool GiAllocator::isScoped() const
+{
+	return false;
+}
+
+GiAllocator* GiAllocator::defaultAllocator()
+{
+	static GiNewAllocator allocator;
+	return &allocator;
+}
+
+GiAllocator* GiAllocator::current()
+{
+	return s_current ? s_current : defaultAllocator();
+}
+
+GiAllocatorScope::GiAllocatorScope(GiAllocator* allocator)
+	: m_previous(s_current)
+{
+	s_current = allocator;
+}
+
+GiAllocatorScope::~GiAllocatorScope()
+{
+	s_current = m_previous;
+}
+
+/**
+ * @brief 内存区的块，数据紧跟在头部之后
+ */
+struct GiArenaAllocator::Chunk
+{
+	Chunk* next;	// 上一个块
+	size_t size;	// 数据区字节数
+	size_t used;	// 已使用字节数
+};
+
+GiArenaAllocator::GiArenaAllocator(size_t chunkSize)
+	: m_head(nullptr), m_chunkSize(chunkSize), m_bytesUsed(0)
+{
+}
+
+GiArenaAllocator::~GiArenaAllocator()
+{
+	while (m_head)
+	{
+		Chunk* next = m_head->next;
+		::operator delete(m_head);
+		m_head = next;
+	}
+}
+
+void* GiArenaAllocator::allocate(size_t size)
+{
+	size = alignUp(MAX(size, (size_t)1));
+
+	if (!m_head || m_head->size - m_head->used < size)
+	{
+		// 超大的申请单独占用一个块
+		size_t chunkSize = MAX(m_chunkSize, size);
+		Chunk* chunk = (Chunk*)::operator new(alignUp(sizeof(Chunk)) + chunkSize);
+		chunk->next = m_head;
+		chunk->size = chunkSize;
+		chunk->used = 0;
+		m_head = chunk;
+	}
+
+	char* ptr = (char*)m_head + alignUp(sizeof(Chunk)) + m_head->used;
+	m_head->used += size;
+	m_bytesUsed += size;
+	return ptr;
+}
+
+void GiArenaAllocator::deallocate(void* ptr, size_t size)
+{
+	// 内存在reset()或析构时统一释放
+	(void)ptr;
+	(void)size;
+}
+
+bool GiArenaAllocator::isScoped() const
+{
+	return true;
+}
+
+void GiArenaAllocator::reset()
+{
+	if (!m_head) return;
+
+	// 最早申请的块位于链表末尾，保留它
+	while (m_head->next)
+	{
+		Chunk* next = m_head->next;
+		::operator delete(m_head);
+		m_head = next;
+	}
+	m_head->used = 0;
+	m_bytesUsed = 0;
+}
+
+size_t GiArenaAllocator::bytesUsed() const
+{
+	return m_bytesUsed;
+}
+
+struct GiPoolAllocator::FreeNode
+{
+	FreeNode* next;
+};
+
+/**
+ * @brief 内存池向系统申请的块，按级别大小切分后放入空闲链表
+ */
+struct GiPoolAllocator::Slab
+{
+	Slab* next;
+};
+
+namespace
+{
+	const size_t POOL_MIN_SHIFT = 5;			// 最小级别32字节
+	const size_t POOL_SLAB_SIZE = 64 * 1024;	// 每次向系统申请的块大小
+	const size_t POOL_BATCH = 32;				// 线程缓存与共享空闲链表之间每次最多移动的数量
+	const size_t POOL_BATCH_BYTES = 16 * 1024;	// 每次移动的最大字节数，限制大级别滞留在线程中的内存
+	const size_t POOL_THREAD_SLOTS = 4;			// 每个线程同时缓存的内存池数量
+
+	std::atomic<uint64_t> s_nextPoolId(1);
+
+	/**
+	 * @brief 存活的内存池。线程退出时只把缓存归还给仍然存活的内存池
+	 */
+	struct PoolRegistry
+	{
+		std::mutex lock;
+		std::unordered_map<uint64_t, GiPoolAllocator*> pools;
+	};
+
+	PoolRegistry& poolRegistry()
+	{
+		// 不析构，其他线程在进程退出阶段结束时仍可能访问
+		static PoolRegistry* registry = new PoolRegistry();
+		return *registry;
+	}
+}
+
+/**
+ * @brief 一个线程中某个内存池各级别的空闲内存
+ */
+struct GiPoolAllocator::LocalLists
+{
+	uint64_t owner;						// 所属内存池的编号，0表示槽位空闲
+	GiPoolAllocator* pool;				// 所属内存池，只在其仍然存活时访问
+	FreeNode* heads[CLASS_COUNT];		// 各级别的空闲链表
+	size_t counts[CLASS_COUNT];			// 各级别的空闲数量
+};
+
+/**
+ * @brief 线程缓存，每个线程一份
+ */
+struct GiPoolAllocator::ThreadCache
+{
+	LocalLists slots[POOL_THREAD_SLOTS];
+
+	ThreadCache()
+	{
+		for (auto& slot : slots)
+		{
+			slot.owner = 0;
+		}
+	}
+
+	~ThreadCache()
+	{
+		// 线程退出，缓存的内存归还给仍然存活的内存池。持有注册表的锁，期间内存池不会被销毁
+		PoolRegistry& registry = poolRegistry();
+		std::lock_guard<std::mutex> guard(registry.lock);
+		for (auto& slot : slots)
+		{
+			if (slot.owner == 0 || registry.pools.find(slot.owner) == registry.pools.end()) continue;
+
+			for (size_t index = 0; index < CLASS_COUNT; ++index)
+			{
+				if (slot.counts[index] > 0)
+				{
+					slot.pool->giveShared(index, slot.heads[index], slot.counts[index]);
+				}
+			}
+		}
+	}
+};
+
+GiPoolAllocator::GiPoolAllocator()
+	: m_id(s_nextPoolId.fetch_add(1, std::memory_order_relaxed))
+{
+	for (auto& sizeClass : m_classes)
+	{
+		sizeClass.freeList = nullptr;
+		sizeClass.slabs = nullptr;
+	}
+
+	PoolRegistry& registry = poolRegistry();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	registry.pools[m_id] = this;
+}
+
+GiPoolAllocator::~GiPoolAllocator()
+{
+	// 注销后线程缓存中属于本内存池的槽位不再被访问，其中的内存随块一起释放
+	{
+		PoolRegistry& registry = poolRegistry();
+		std::lock_guard<std::mutex> guard(registry.lock);
+		registry.pools.erase(m_id);
+	}
+
+	for (auto& sizeClass : m_classes)
+	{
+		while (sizeClass.slabs)
+		{
+			Slab* next = sizeClass.slabs->next;
+			::operator delete(sizeClass.slabs);
+			sizeClass.slabs = next;
+		}
+	}
+}
+
+size_t GiPoolAllocator::classOf(size_t size)
+{
+	size_t index = 0;
+	size_t classSize = (size_t)1 << POOL_MIN_SHIFT;
+	while (classSize < size && index < CLASS_COUNT)
+	{
+		classSize <<= 1;
+		++index;
+	}
+	return index;
+}
+
+size_t GiPoolAllocator::batchOf(size_t index)
+{
+	return MIN(POOL_BATCH, POOL_BATCH_BYTES >> (POOL_MIN_SHIFT + index));
+}
+
+GiPoolAllocator::FreeNode* GiPoolAllocator::takeShared(size_t index, size_t count)
+{
+	SizeClass& sizeClass = m_classes[index];
+	std::lock_guard<std::mutex> guard(sizeClass.lock);
+
+	FreeNode* head = nullptr;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!sizeClass.freeList)
+		{
+			// 申请新块并切分
+			size_t classSize = (size_t)1 << (POOL_MIN_SHIFT + index);
+			size_t header = alignUp(sizeof(Slab));
+			char* raw = (char*)::operator new(header + POOL_SLAB_SIZE);
+
+			Slab* slab = (Slab*)raw;
+			slab->next = sizeClass.slabs;
+			sizeClass.slabs = slab;
+
+			for (size_t offset = header; offset + classSize <= header + POOL_SLAB_SIZE; offset += classSize)
+			{
+				FreeNode* node = (FreeNode*)(raw + offset);
+				node->next = sizeClass.freeList;
+				sizeClass.freeList = node;
+			}
+		}
+
+		FreeNode* node = sizeClass.freeList;
+		sizeClass.freeList = node->next;
+		node->next = head;
+		head = node;
+	}
+	return head;
+}
+
+void GiPoolAllocator::giveShared(size_t index, FreeNode* head, size_t count)
+{
+	FreeNode* tail = head;
+	for (size_t i = 1; i < count; ++i)
+	{
+		tail = tail->next;
+	}
+
+	SizeClass& sizeClass = m_classes[index];
+	std::lock_guard<std::mutex> guard(sizeClass.lock);
+	tail->next = sizeClass.freeList;
+	sizeClass.freeList = head;
+}
+
+GiPoolAllocator::LocalLists* GiPoolAllocator::localLists()
+{
+	static thread_local ThreadCache cache;
+	for (auto& slot : cache.slots)
+	{
+		if (slot.owner == m_id) return &slot;
+	}
+
+	// 本线程首次使用该内存池，占用空闲槽位或者已销毁的内存池留下的槽位
+	PoolRegistry& registry = poolRegistry();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	for (auto& slot : cache.slots)
+	{
+		if (slot.owner != 0 && registry.pools.find(slot.owner) != registry.pools.end()) continue;
+
+		slot.owner = m_id;
+		slot.pool = this;
+		for (size_t index = 0; index < CLASS_COUNT; ++index)
+		{
+			slot.heads[index] = nullptr;
+			slot.counts[index] = 0;
+		}
+		return &slot;
+	}
+	return nullptr;
+}
+
+void* GiPoolAllocator::allocate(size_t size)
+{
+	size_t index = classOf(size);
+	if (index >= CLASS_COUNT)
+	{
+		return defaultAllocator()->allocate(size);
+	}
+
+	LocalLists* local = localLists();
+	if (!local)
+	{
+		return takeShared(index, 1);
+	}
+
+	// 线程缓存为空时从共享空闲链表成批取出
+	if (local->counts[index] == 0)
+	{
+		size_t batch = batchOf(index);
+		local->heads[index] = takeShared(index, batch);
+		local->counts[index] = batch;
+	}
+
+	FreeNode* node = local->heads[index];
+	local->heads[index] = node->next;
+	--local->counts[index];
+	return node;
+}
+
+void GiPoolAllocator::deallocate(void* ptr, size_t size)
+{
+	size_t index = classOf(size);
+	if (index >= CLASS_COUNT)
+	{
+		defaultAllocator()->deallocate(ptr, size);
+		return;
+	}
+
+	FreeNode* node = (FreeNode*)ptr;
+	LocalLists* local = localLists();
+	if (!local)
+	{
+		giveShared(index, node, 1);
+		return;
+	}
+
+	node->next = local->heads[index];
+	local->heads[index] = node;
+	++local->counts[index];
+
+	// 缓存过多时成批归还，其他线程可以复用，内存也不会滞留在只释放不申请的线程中
+	size_t batch = batchOf(index);
+	if (local->counts[index] >= 2 * batch)
+	{
+		FreeNode* head = local->heads[index];
+		FreeNode* tail = head;
+		for (size_t i = 1; i < batch; ++i)
+		{
+			tail = tail->next;
+		}
+		local->heads[index] = tail->next;
+		local->counts[index] -= batch;
+		giveShared(index, head, batch);
+	}
+}
@@ -0,0 +1,305 @@
+﻿#include "gikoo/gi_multi_matcher.h"
+#include <algorithm>
+#include <utility>
+
+using namespace GiKoo;
+
+namespace
+{
+	// 稠密布局中转移表的项保存下一个状态的行起点，省去每个字节的乘法；最高位标记该状态有输出
+	const uint32_t DENSE_MATCH_FLAG = 0x80000000u;
+	const uint32_t DENSE_ROW_MASK = 0x7fffffffu;
+
+	/**
+	 * @brief 构建期间使用的字典树节点
+	 */
+	struct TrieNode
+	{
+		std::vector<std::pair<uint16_t, uint32_t>> edges;	// (字节类, 子节点)，构建完成后按字节类排序
+		std::vector<uint32_t> outputs;						// 在该节点结束的模式编号
+	};
+
+	/**
+	 * @brief 查找子节点，edges已排序
+	 *
+	 * @return 子节点。不存在时返回UINT32_MAX
+	 */
+	uint32_t child(const TrieNode& node, uint16_t byteClass)
+	{
+		auto it = std::lower_bound(node.edges.begin(), node.edges.end(), std::make_pair(byteClass, (uint32_t)0));
+		return it != node.edges.end() && it->first == byteClass ? it->second : UINT32_MAX;
+	}
+}
+
+const size_t GiMultiMatcher::DENSE_TABLE_LIMIT;
+
+GiMultiMatcher::GiMultiMatcher(const std::vector<GiString>& patterns, Layout layout)
+	: m_layout(layout), m_classCount(1), m_stateCount(1)
+{
+	// 出现在模式中的字节各自成为一个字节类，其余字节共用类0
+	bool used[256] = { false };
+	for (const GiString& pattern : patterns)
+	{
+		const unsigned char* data = (const unsigned char*)pattern.c_str();
+		for (size_t i = 0; i < pattern.length(); ++i)
+		{
+			used[data[i]] = true;
+		}
+	}
+	for (size_t i = 0; i < 256; ++i)
+	{
+		m_classes[i] = used[i] ? (uint16_t)m_classCount++ : 0;
+	}
+
+	// 构建字典树
+	std::vector<TrieNode> trie(1);
+	m_lengths.reserve(patterns.size());
+	for (size_t id = 0; id < patterns.size(); ++id)
+	{
+		const GiString& pattern = patterns[id];
+		const unsigned char* data = (const unsigned char*)pattern.c_str();
+		m_lengths.push_back((uint32_t)pattern.length());
+		if (pattern.isEmpty()) continue;
+
+		uint32_t node = 0;
+		for (size_t i = 0; i < pattern.length(); ++i)
+		{
+			uint16_t byteClass = m_classes[data[i]];
+			uint32_t next = UINT32_MAX;
+			for (auto& edge : trie[node].edges)
+			{
+				if (edge.first == byteClass)
+				{
+					next = edge.second;
+					break;
+				}
+			}
+			if (next == UINT32_MAX)
+			{
+				next = (uint32_t)trie.size();
+				trie[node].edges.push_back(std::make_pair(byteClass, next));
+				trie.emplace_back();
+			}
+			node = next;
+		}
+		trie[node].outputs.push_back((uint32_t)id);
+	}
+	m_stateCount = trie.size();
+
+	// 广度优先遍历，求失败转移和新的状态编号
+	std::vector<uint32_t> order;
+	std::vector<uint32_t> rank(m_stateCount);
+	std::vector<uint32_t> fail(m_stateCount, 0);
+	order.reserve(m_stateCount);
+	order.push_back(0);
+	for (size_t head = 0; head < order.size(); ++head)
+	{
+		uint32_t node = order[head];
+		rank[node] = (uint32_t)head;
+		std::sort(trie[node].edges.begin(), trie[node].edges.end());
+		for (auto& edge : trie[node].edges)
+		{
+			uint32_t target = 0;
+			if (node != 0)
+			{
+				// 沿父节点的失败链寻找同样字节类的边。失败链上的节点深度更小，边已排序
+				uint32_t f = fail[node];
+				for (;;)
+				{
+					uint32_t next = child(trie[f], edge.first);
+					if (next != UINT32_MAX)
+					{
+						target = next;
+						break;
+					}
+					if (f == 0) break;
+					f = fail[f];
+				}
+			}
+			fail[edge.second] = target;
+			order.push_back(edge.second);
+		}
+	}
+
+	// 按新编号输出各项数组
+	m_match.assign(m_stateCount, 0);
+	m_dictLink.assign(m_stateCount, 0);
+	m_outputBegin.reserve(m_stateCount + 1);
+	for (uint32_t state = 0; state < m_stateCount; ++state)
+	{
+		const TrieNode& node = trie[order[state]];
+		m_outputBegin.push_back((uint32_t)m_outputs.size());
+		m_outputs.insert(m_outputs.end(), node.outputs.begin(), node.outputs.end());
+
+		// 失败状态的编号更小，已经计算完成
+		if (state != 0)
+		{
+			uint32_t f = rank[fail[order[state]]];
+			m_dictLink[state] = m_match[f];
+			m_match[state] = node.outputs.empty() ? m_dictLink[state] : state;
+		}
+	}
+	m_outputBegin.push_back((uint32_t)m_outputs.size());
+
+	if (m_layout == LAYOUT_AUTO)
+	{
+		m_layout = m_stateCount * m_classCount * sizeof(uint32_t) <= DENSE_TABLE_LIMIT ? LAYOUT_DENSE : LAYOUT_COMPACT;
+	}
+	if (m_stateCount * m_classCount > DENSE_ROW_MASK)
+	{
+		// 行起点超出标记位以下的范围
+		m_layout = LAYOUT_COMPACT;
+	}
+
+	if (m_layout == LAYOUT_DENSE)
+	{
+		// 展开失败转移: 没有边时使用失败状态的转移，失败状态编号更小，已经填好
+		m_next.assign(m_stateCount * m_classCount, 0);
+		for (uint32_t state = 0; state < m_stateCount; ++state)
+		{
+			uint32_t* row = &m_next[state * m_classCount];
+			if (state != 0)
+			{
+				const uint32_t* failRow = &m_next[rank[fail[order[state]]] * m_classCount];
+				// 失败状态的行已经填好，复制过来后再覆盖实际存在的边
+				std::copy(failRow, failRow + m_classCount, row);
+			}
+			for (auto& edge : trie[order[state]].edges)
+			{
+				uint32_t target = rank[edge.second];
+				row[edge.first] = (uint32_t)(target * m_classCount) | (m_match[target] ? DENSE_MATCH_FLAG : 0);
+			}
+		}
+	}
+	else
+	{
+		m_rootNext.assign(m_classCount, 0);
+		for (auto& edge : trie[0].edges)
+		{
+			m_rootNext[edge.first] = rank[edge.second];
+		}
+
+		m_fail.resize(m_stateCount);
+		m_edgeBegin.reserve(m_stateCount + 1);
+		m_edgeClass.reserve(m_stateCount - 1);
+		m_edgeTarget.reserve(m_stateCount - 1);
+		for (uint32_t state = 0; state < m_stateCount; ++state)
+		{
+			m_fail[state] = rank[fail[order[state]]];
+			m_edgeBegin.push_back((uint32_t)m_edgeClass.size());
+			for (auto& edge : trie[order[state]].edges)
+			{
+				m_edgeClass.push_back(edge.first);
+				m_edgeTarget.push_back(rank[edge.second]);
+			}
+		}
+		m_edgeBegin.push_back((uint32_t)m_edgeClass.size());
+	}
+}
+
+uint32_t GiMultiMatcher::step(uint32_t state, uint16_t byteClass) const
+{
+	// 没有出现在模式中的字节必然回到根状态
+	if (byteClass == 0) return 0;
+
+	while (state != 0)
+	{
+		const uint16_t* begin = m_edgeClass.data() + m_edgeBegin[state];
+		const uint16_t* end = m_edgeClass.data() + m_edgeBegin[state + 1];
+		const uint16_t* it = std::lower_bound(begin, end, byteClass);
+		if (it != end && *it == byteClass) return m_edgeTarget[it - m_edgeClass.data()];
+		state = m_fail[state];
+	}
+	return m_rootNext[byteClass];
+}
+
+template <typename Report>
+bool GiMultiMatcher::reportAt(uint32_t state, size_t end, Report& report) const
+{
+	// 沿输出链报告，较长的后缀在前
+	for (uint32_t out = m_match[state]; out != 0; out = m_dictLink[out])
+	{
+		for (uint32_t k = m_outputBegin[out]; k < m_outputBegin[out + 1]; ++k)
+		{
+			uint32_t id = m_outputs[k];
+			if (!report(id, end + 1 - m_lengths[id])) return false;
+		}
+	}
+	return true;
+}
+
+template <typename Report>
+void GiMultiMatcher::scan(const GiStringView& str, Report report) const
+{
+	const unsigned char* data = (const unsigned char*)str.data();
+	size_t length = str.length();
+
+	if (m_layout == LAYOUT_DENSE)
+	{
+		const uint32_t* next = m_next.data();
+		uint32_t entry = 0;
+		for (size_t i = 0; i < length; ++i)
+		{
+			entry = next[(entry & DENSE_ROW_MASK) + m_classes[data[i]]];
+			if ((entry & DENSE_MATCH_FLAG) && !reportAt((uint32_t)((entry & DENSE_ROW_MASK) / m_classCount), i, report)) return;
+		}
+	}
+	else
+	{
+		uint32_t state = 0;
+		for (size_t i = 0; i < length; ++i)
+		{
+			state = step(state, m_classes[data[i]]);
+			if (m_match[state] != 0 && !reportAt(state, i, report)) return;
+		}
+	}
+}
+
+std::vector<GiMatch> GiMultiMatcher::findAll(const GiStringView& str) const
+{
+	std::vector<GiMatch> matches;
+	findAll(str, matches);
+	return matches;
+}
+
+void GiMultiMatcher::findAll(const GiStringView& str, std::vector<GiMatch>& matches) const
+{
+	scan(str, [&](size_t pattern, size_t offset) {
+		matches.push_back(GiMatch{ pattern, offset });
+		return true;
+	});
+}
+
+bool GiMultiMatcher::containsAny(const GiStringView& str) const
+{
+	bool found = false;
+	scan(str, [&](size_t, size_t) {
+		found = true;
+		return false;
+	});
+	return found;
+}
+
+size_t GiMultiMatcher::patternCount() const
+{
+	return m_lengths.size();
+}
+
+size_t GiMultiMatcher::stateCount() const
+{
+	return m_stateCount;
+}
+
+GiMultiMatcher::Layout GiMultiMatcher::layout() const
+{
+	return m_layout;
+}
+
+size_t GiMultiMatcher::memoryBytes() const
+{
+	return sizeof(*this)
+		+ sizeof(uint32_t) * (m_lengths.capacity() + m_next.capacity() + m_rootNext.capacity() + m_edgeBegin.capacity()
+			+ m_edgeTarget.capacity() + m_fail.capacity() + m_match.capacity() + m_dictLink.capacity()
+			+ m_outputBegin.capacity() + m_outputs.capacity())
+		+ sizeof(uint16_t) * m_edgeClass.capacity();
+}
@@ -0,0 +1,1326 @@
+﻿#include "gikoo/gi_regex.h"
+#include "gikoo/gi_allocator.h"
+#include "gikoo/gi_searcher.h"
+#include "gikoo/gi_string_builder.h"
+#include "gi_string_split.h"
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+using namespace GiKoo;
+
+namespace
+{
+	const size_t REPEAT_INFINITE = SIZE_MAX;
+	const size_t MAX_REPEAT = 1000;				// {n,m}的上限
+	const size_t MAX_NESTING = 1000;			// 分组和字符类的最大嵌套层数
+	const size_t MAX_PROGRAM_SIZE = 100000;		// 编译后的最大指令数
+	const size_t DFA_MEMORY_LIMIT = 2 << 20;	// DFA缓存的最大字节数
+	const uint32_t DFA_UNKNOWN = UINT32_MAX;	// 尚未计算的转移
+	const uint32_t DFA_DEAD = 0;				// 不可能再匹配的状态
+
+	/**
+	 * @brief 字节集合
+	 */
+	struct ByteSet
+	{
+		uint64_t bits[4];
+
+		ByteSet()
+		{
+			bits[0] = bits[1] = bits[2] = bits[3] = 0;
+		}
+
+		bool has(unsigned char ch) const
+		{
+			return (bits[ch >> 6] >> (ch & 63)) & 1;
+		}
+
+		void add(unsigned char ch)
+		{
+			bits[ch >> 6] |= (uint64_t)1 << (ch & 63);
+		}
+
+		void addRange(unsigned char low, unsigned char high)
+		{
+			for (unsigned int ch = low; ch <= high; ++ch)
+			{
+				add((unsigned char)ch);
+			}
+		}
+
+		void addSet(const ByteSet& other)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				bits[i] |= other.bits[i];
+			}
+		}
+
+		void invert()
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				bits[i] = ~bits[i];
+			}
+		}
+	};
+
+	bool isWordByte(unsigned char ch)
+	{
+		return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+	}
+
+	bool isLineTerminator(unsigned char ch)
+	{
+		return ch == '\n' || ch == '\r';
+	}
+
+	/**
+	 * @brief 是否为正则表达式的元字符。与JDK一致，']'和'}'单独出现时是普通字符
+	 */
+	bool isMetaChar(unsigned char ch)
+	{
+		switch (ch)
+		{
+		case '.': case '$': case '|': case '(': case ')': case '[':
+		case '{': case '^': case '?': case '*': case '+': case '\\':
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * @brief 转义后表示单个字符的字符
+	 *
+	 * @retval true ch转义后表示literal
+	 */
+	bool literalEscape(unsigned char ch, unsigned char& literal)
+	{
+		switch (ch)
+		{
+		case 't': literal = '\t'; return true;
+		case 'n': literal = '\n'; return true;
+		case 'r': literal = '\r'; return true;
+		case 'f': literal = '\f'; return true;
+		default:
+			literal = ch;
+			return !isWordByte(ch);
+		}
+	}
+
+	/**
+	 * @brief 边界
+	 */
+	enum Assertion
+	{
+		ASSERT_BEGIN_TEXT,			// ^ \A
+		ASSERT_END_TEXT,			// \z
+		ASSERT_END_TEXT_LINE,		// $ \Z，末尾或最后一个换行符之前
+		ASSERT_WORD_BOUNDARY,		// \b
+		ASSERT_NOT_WORD_BOUNDARY,	// \B
+	};
+
+	/**
+	 * @brief 语法树节点
+	 */
+	struct Node
+	{
+		enum Type
+		{
+			NODE_EMPTY,
+			NODE_SET,
+			NODE_ASSERT,
+			NODE_CONCAT,
+			NODE_ALTERNATE,
+			NODE_REPEAT,
+		};
+
+		Type type;
+		ByteSet set;					// NODE_SET
+		Assertion assertion;			// NODE_ASSERT
+		std::vector<Node> children;		// NODE_CONCAT、NODE_ALTERNATE的各项，NODE_REPEAT的重复内容
+		size_t min;						// NODE_REPEAT
+		size_t max;						// NODE_REPEAT，REPEAT_INFINITE表示不限
+		bool greedy;					// NODE_REPEAT
+
+		explicit Node(Type t = NODE_EMPTY)
+			: type(t), assertion(ASSERT_BEGIN_TEXT), min(0), max(0), greedy(true)
+		{
+		}
+
+		static Node byte(unsigned char ch)
+		{
+			Node node(NODE_SET);
+			node.set.add(ch);
+			return node;
+		}
+	};
+
+	/**
+	 * @brief 递归下降的语法分析
+	 */
+	class Parser
+	{
+	public:
+		Parser(const GI_STRING_DATA_TYPE* data, size_t length)
+			: m_data((const unsigned char*)data), m_length(length), m_pos(0), m_depth(0), m_error(nullptr)
+		{
+		}
+
+		bool parse(Node& root)
+		{
+			if (!parseAlternation(root)) return false;
+			if (m_pos < m_length) return fail("Unmatched closing ')'");
+			return true;
+		}
+
+		const GI_STRING_DATA_TYPE* error() const
+		{
+			return m_error;
+		}
+
+	private:
+		bool fail(const GI_STRING_DATA_TYPE* message)
+		{
+			if (!m_error) m_error = message;
+			return false;
+		}
+
+		bool more() const
+		{
+			return m_pos < m_length;
+		}
+
+		unsigned char peek() const
+		{
+			return m_data[m_pos];
+		}
+
+		bool parseAlternation(Node& out)
+		{
+			if (++m_depth > MAX_NESTING) return fail("Pattern nested too deeply");
+
+			Node branch;
+			if (!parseConcat(branch)) return false;
+			if (!more() || peek() != '|')
+			{
+				out = std::move(branch);
+				--m_depth;
+				return true;
+			}
+
+			out = Node(Node::NODE_ALTERNATE);
+			out.children.push_back(std::move(branch));
+			while (more() && peek() == '|')
+			{
+				++m_pos;
+				Node next;
+				if (!parseConcat(next)) return false;
+				out.children.push_back(std::move(next));
+			}
+			--m_depth;
+			return true;
+		}
+
+		bool parseConcat(Node& out)
+		{
+			out = Node(Node::NODE_CONCAT);
+			while (more() && peek() != '|' && peek() != ')')
+			{
+				if (!parseRepeat(out)) return false;
+			}
+			if (out.children.size() == 1)
+			{
+				Node single = std::move(out.children[0]);
+				out = std::move(single);
+			}
+			else if (out.children.empty())
+			{
+				out = Node(Node::NODE_EMPTY);
+			}
+			return true;
+		}
+
+		/**
+		 * @brief 解析一项及其后的量词，追加到concat
+		 */
+		bool parseRepeat(Node& concat)
+		{
+			size_t itemBegin = concat.children.size();
+			if (!parseAtom(concat)) return false;
+
+			while (more())
+			{
+				size_t min = 0;
+				size_t max = 0;
+				unsigned char ch = peek();
+				if (ch == '*')
+				{
+					min = 0;
+					max = REPEAT_INFINITE;
+					++m_pos;
+				}
+				else if (ch == '+')
+				{
+					min = 1;
+					max = REPEAT_INFINITE;
+					++m_pos;
+				}
+				else if (ch == '?')
+				{
+					min = 0;
+					max = 1;
+					++m_pos;
+				}
+				else if (ch == '{')
+				{
+					if (!parseBraces(min, max)) return false;
+				}
+				else
+				{
+					break;
+				}
+
+				bool greedy = true;
+				if (more() && peek() == '?')
+				{
+					greedy = false;
+					++m_pos;
+				}
+				else if (more() && peek() == '+')
+				{
+					return fail("Possessive quantifiers are not supported");
+				}
+
+				// \Q...\E可能追加了多个字节，量词只作用于最后一个
+				if (concat.children.size() == itemBegin) return fail("Dangling meta character");
+				Node repeat(Node::NODE_REPEAT);
+				repeat.min = min;
+				repeat.max = max;
+				repeat.greedy = greedy;
+				repeat.children.push_back(std::move(concat.children.back()));
+				concat.children.back() = std::move(repeat);
+			}
+			return true;
+		}
+
+		bool parseNumber(size_t& value)
+		{
+			if (!more() || peek() < '0' || peek() > '9') return false;
+			value = 0;
+			while (more() && peek() >= '0' && peek() <= '9')
+			{
+				value = value * 10 + (peek() - '0');
+				if (value > MAX_REPEAT) return fail("Repetition count too large");
+				++m_pos;
+			}
+			return true;
+		}
+
+		bool parseBraces(size_t& min, size_t& max)
+		{
+			++m_pos;
+			if (!parseNumber(min)) return fail("Illegal repetition");
+			max = min;
+			if (more() && peek() == ',')
+			{
+				++m_pos;
+				max = REPEAT_INFINITE;
+				if (more() && peek() != '}' && !parseNumber(max)) return fail("Illegal repetition");
+			}
+			if (!more() || peek() != '}') return fail("Unclosed counted closure");
+			++m_pos;
+			if (max < min) return fail("Illegal repetition range");
+			return true;
+		}
+
+		bool parseAtom(Node& concat)
+		{
+			unsigned char ch = peek();
+			switch (ch)
+			{
+			case '(':
+			{
+				++m_pos;
+				if (more() && peek() == '?')
+				{
+					if (m_pos + 1 < m_length && m_data[m_pos + 1] == ':')
+					{
+						m_pos += 2;
+					}
+					else
+					{
+						return fail("Lookaround and inline flags are not supported");
+					}
+				}
+				Node group;
+				if (!parseAlternation(group)) return false;
+				if (!more() || peek() != ')') return fail("Unclosed group");
+				++m_pos;
+				concat.children.push_back(std::move(group));
+				return true;
+			}
+			case '[':
+			{
+				Node node(Node::NODE_SET);
+				if (!parseClass(node.set)) return false;
+				concat.children.push_back(std::move(node));
+				return true;
+			}
+			case '.':
+			{
+				Node node(Node::NODE_SET);
+				node.set.invert();
+				node.set.bits[0] &= ~(((uint64_t)1 << '\n') | ((uint64_t)1 << '\r'));
+				concat.children.push_back(std::move(node));
+				++m_pos;
+				return true;
+			}
+			case '^':
+			case '$':
+			{
+				Node node(Node::NODE_ASSERT);
+				node.assertion = ch == '^' ? ASSERT_BEGIN_TEXT : ASSERT_END_TEXT_LINE;
+				concat.children.push_back(std::move(node));
+				++m_pos;
+				return true;
+			}
+			case '*':
+			case '+':
+			case '?':
+			case '{':
+				return fail("Dangling meta character");
+			case '\\':
+				return parseEscape(concat);
+			default:
+				concat.children.push_back(Node::byte(ch));
+				++m_pos;
+				return true;
+			}
+		}
+
+		/**
+		 * @brief 按UTF-8编码追加码点，多字节时作为一项，量词作用于整个字符
+		 */
+		static void appendUtf8(Node& concat, uint32_t code)
+		{
+			unsigned char bytes[4];
+			size_t count;
+			if (code < 0x80)
+			{
+				bytes[0] = (unsigned char)code;
+				count = 1;
+			}
+			else if (code < 0x800)
+			{
+				bytes[0] = (unsigned char)(0xC0 | (code >> 6));
+				bytes[1] = (unsigned char)(0x80 | (code & 0x3F));
+				count = 2;
+			}
+			else
+			{
+				bytes[0] = (unsigned char)(0xE0 | (code >> 12));
+				bytes[1] = (unsigned char)(0x80 | ((code >> 6) & 0x3F));
+				bytes[2] = (unsigned char)(0x80 | (code & 0x3F));
+				count = 3;
+			}
+			if (count == 1)
+			{
+				concat.children.push_back(Node::byte(bytes[0]));
+				return;
+			}
+
+			Node sequence(Node::NODE_CONCAT);
+			for (size_t i = 0; i < count; ++i)
+			{
+				sequence.children.push_back(Node::byte(bytes[i]));
+			}
+			concat.children.push_back(std::move(sequence));
+		}
+
+		bool parseHex(size_t digits, uint32_t& value)
+		{
+			value = 0;
+			for (size_t i = 0; i < digits; ++i)
+			{
+				if (!more()) return fail("Illegal hexadecimal escape sequence");
+				unsigned char ch = peek();
+				uint32_t digit;
+				if (ch >= '0' && ch <= '9') digit = ch - '0';
+				else if (ch >= 'a' && ch <= 'f') digit = ch - 'a' + 10;
+				else if (ch >= 'A' && ch <= 'F') digit = ch - 'A' + 10;
+				else return fail("Illegal hexadecimal escape sequence");
+				value = value * 16 + digit;
+				++m_pos;
+			}
+			return true;
+		}
+
+		/**
+		 * @brief 预定义字符类\d \D \s \S \w \W
+		 *
+		 * @retval true ch是预定义字符类，结果写入set
+		 */
+		static bool predefinedClass(unsigned char ch, ByteSet& set)
+		{
+			switch (ch)
+			{
+			case 'd':
+			case 'D':
+				set.addRange('0', '9');
+				break;
+			case 's':
+			case 'S':
+				set.add(' ');
+				set.addRange('\t', '\r');
+				break;
+			case 'w':
+			case 'W':
+				set.addRange('a', 'z');
+				set.addRange('A', 'Z');
+				set.addRange('0', '9');
+				set.add('_');
+				break;
+			default:
+				return false;
+			}
+			if (ch == 'D' || ch == 'S' || ch == 'W') set.invert();
+			return true;
+		}
+
+		/**
+		 * @brief 单个字符的转义，\后的字符已读取
+		 *
+		 * @retval true 是单个字符的转义，结果写入code
+		 */
+		bool characterEscape(unsigned char ch, uint32_t& code)
+		{
+			switch (ch)
+			{
+			case 't': code = '\t'; return true;
+			case 'n': code = '\n'; return true;
+			case 'r': code = '\r'; return true;
+			case 'f': code = '\f'; return true;
+			case 'a': code = '\a'; return true;
+			case 'e': code = 0x1B; return true;
+			case 'x': return parseHex(2, code);
+			case 'u': return parseHex(4, code);
+			default:
+				// 非字母数字的字符转义后表示自身
+				if (!isWordByte(ch))
+				{
+					code = ch;
+					return true;
+				}
+				return fail("Illegal/unsupported escape sequence");
+			}
+		}
+
+		bool parseEscape(Node& concat)
+		{
+			++m_pos;
+			if (!more()) return fail("Unexpected internal error");
+			unsigned char ch = peek();
+			++m_pos;
+
+			ByteSet set;
+			if (predefinedClass(ch, set))
+			{
+				Node node(Node::NODE_SET);
+				node.set = set;
+				concat.children.push_back(std::move(node));
+				return true;
+			}
+
+			Node node(Node::NODE_ASSERT);
+			switch (ch)
+			{
+			case 'A': node.assertion = ASSERT_BEGIN_TEXT; break;
+			case 'z': node.assertion = ASSERT_END_TEXT; break;
+			case 'Z': node.assertion = ASSERT_END_TEXT_LINE; break;
+			case 'b': node.assertion = ASSERT_WORD_BOUNDARY; break;
+			case 'B': node.assertion = ASSERT_NOT_WORD_BOUNDARY; break;
+			case 'Q':
+			{
+				// \Q...\E之间的内容按普通字符处理
+				while (more())
+				{
+					if (peek() == '\\' && m_pos + 1 < m_length && m_data[m_pos + 1] == 'E')
+					{
+						m_pos += 2;
+						return true;
+					}
+					concat.children.push_back(Node::byte(peek()));
+					++m_pos;
+				}
+				return true;
+			}
+			default:
+			{
+				uint32_t code;
+				if (ch >= '0' && ch <= '9') return fail("Back references are not supported");
+				if (!characterEscape(ch, code)) return false;
+				if (ch == 'u') appendUtf8(concat, code);
+				else concat.children.push_back(Node::byte((unsigned char)code));
+				return true;
+			}
+			}
+			concat.children.push_back(std::move(node));
+			return true;
+		}
+
+		/**
+		 * @brief 解析字符类中的一个字符
+		 *
+		 * @param set 遇到预定义字符类时直接并入
+		 * @param code 单个字符
+		 *
+		 * @retval true 成功。isSingle表示是否为单个字符(可以作为范围的端点)
+		 */
+		bool parseClassAtom(ByteSet& set, uint32_t& code, bool& isSingle)
+		{
+			isSingle = true;
+			unsigned char ch = peek();
+			++m_pos;
+			if (ch != '\\')
+			{
+				code = ch;
+				return true;
+			}
+
+			if (!more()) return fail("Unclosed character class");
+			ch = peek();
+			++m_pos;
+			if (predefinedClass(ch, set))
+			{
+				isSingle = false;
+				return true;
+			}
+			if (!characterEscape(ch, code)) return false;
+			if (code > 0xFF) return fail("Non-ASCII \\u escapes are not supported in character classes");
+			return true;
+		}
+
+		bool parseClass(ByteSet& out)
+		{
+			if (++m_depth > MAX_NESTING) return fail("Pattern nested too deeply");
+			++m_pos;
+
+			bool negate = false;
+			if (more() && peek() == '^')
+			{
+				negate = true;
+				++m_pos;
+			}
+
+			ByteSet set;
+			bool empty = true;
+			while (more() && peek() != ']')
+			{
+				if (peek() == '[')
+				{
+					ByteSet nested;
+					if (!parseClass(nested)) return false;
+					set.addSet(nested);
+					empty = false;
+					continue;
+				}
+				if (peek() == '&' && m_pos + 1 < m_length && m_data[m_pos + 1] == '&')
+				{
+					return fail("Character class intersection is not supported");
+				}
+
+				uint32_t low;
+				bool isSingle;
+				if (!parseClassAtom(set, low, isSingle)) return false;
+				empty = false;
+				if (!isSingle) continue;
+
+				// 范围。'-'位于末尾时按普通字符处理
+				if (m_pos + 1 < m_length && peek() == '-' && m_data[m_pos + 1] != ']')
+				{
+					++m_pos;
+					uint32_t high;
+					if (peek() == '[') return fail("Illegal character range");
+					if (!parseClassAtom(set, high, isSingle)) return false;
+					if (!isSingle || high < low) return fail("Illegal character range");
+					set.addRange((unsigned char)low, (unsigned char)high);
+				}
+				else
+				{
+					set.add((unsigned char)low);
+				}
+			}
+			if (!more()) return fail("Unclosed character class");
+			if (empty) return fail("Empty character class");
+			++m_pos;
+
+			if (negate) set.invert();
+			out = set;
+			--m_depth;
+			return true;
+		}
+
+	private:
+		const unsigned char* m_data;
+		size_t m_length;
+		size_t m_pos;
+		size_t m_depth;
+		const GI_STRING_DATA_TYPE* m_error;
+	};
+
+	/**
+	 * @brief 指令
+	 */
+	struct Inst
+	{
+		enum Op
+		{
+			OP_SET,		// 读入一个属于sets[x]的字节，然后执行下一条指令
+			OP_SPLIT,	// 同时执行x和y，x优先
+			OP_JUMP,	// 跳转到x
+			OP_ASSERT,	// 边界x成立时执行下一条指令
+			OP_MATCH,	// 匹配成功
+		};
+
+		Op op;
+		uint32_t x;
+		uint32_t y;
+	};
+
+	/**
+	 * @brief Pike VM的线程
+	 */
+	struct Thread
+	{
+		uint32_t pc;
+		size_t start;	// 匹配的起点
+	};
+}
+
+/**
+ * @brief 编译结果
+ */
+struct GiRegex::Program
+{
+	GiString pattern;
+	const GI_STRING_DATA_TYPE* error;
+	std::vector<Inst> insts;
+	std::vector<ByteSet> sets;
+	bool hasAssertions;
+
+	uint16_t classes[256];			// 字节到字节类的映射，同一类的字节在所有字节集合中的归属相同
+	size_t classCount;
+	unsigned char classByte[256];	// 各字节类中的一个字节
+
+	/**
+	 * @brief 惰性DFA，状态为NFA的指令集合，只包含OP_SET和OP_MATCH
+	 */
+	struct Dfa
+	{
+		std::map<std::vector<uint32_t>, uint32_t> ids;
+		std::vector<const std::vector<uint32_t>*> states;	// 指向ids中的键
+		std::vector<uint32_t> transitions;					// 状态 * 字节类数量 + 字节类 -> 下一个状态
+		std::vector<char> accepting;
+		size_t memory;
+
+		Dfa()
+			: memory(0)
+		{
+		}
+	};
+
+	std::mutex dfaLock;
+	Dfa dfa;
+
+	std::unique_ptr<GiSearcher> literal;	// 表达式为普通字符串时不运行自动机，直接查找
+
+	explicit Program(const GiStringView& str)
+		: pattern(str), error(nullptr), hasAssertions(false), classCount(1)
+	{
+	}
+
+	bool compile(const Node& node);
+	void computeClasses();
+
+	// Pike VM
+	void addThread(std::vector<Thread>& list, std::vector<uint32_t>& marks, uint32_t generation, std::vector<uint32_t>& stack,
+		uint32_t pc, size_t start, const unsigned char* text, size_t length, size_t pos) const;
+	bool run(const unsigned char* text, size_t length, size_t offset, bool anchored, size_t& start, size_t& end) const;
+
+	// 惰性DFA，需持有dfaLock
+	uint32_t dfaState(std::vector<uint32_t>& pcs);
+	uint32_t dfaNext(uint32_t state, size_t byteClass);
+	int dfaMatches(const unsigned char* text, size_t length);
+
+private:
+	uint32_t emit(Inst::Op op, uint32_t x = 0, uint32_t y = 0)
+	{
+		insts.push_back(Inst{ op, x, y });
+		return (uint32_t)(insts.size() - 1);
+	}
+};
+
+bool GiRegex::Program::compile(const Node& node)
+{
+	if (insts.size() > MAX_PROGRAM_SIZE)
+	{
+		error = "Pattern too large";
+		return false;
+	}
+
+	switch (node.type)
+	{
+	case Node::NODE_EMPTY:
+		return true;
+	case Node::NODE_SET:
+		sets.push_back(node.set);
+		emit(Inst::OP_SET, (uint32_t)(sets.size() - 1));
+		return true;
+	case Node::NODE_ASSERT:
+		hasAssertions = true;
+		emit(Inst::OP_ASSERT, node.assertion);
+		return true;
+	case Node::NODE_CONCAT:
+		for (const Node& child : node.children)
+		{
+			if (!compile(child)) return false;
+		}
+		return true;
+	case Node::NODE_ALTERNATE:
+	{
+		// split L1, next; L1: a; jump end; next: split L2, next2; ...
+		std::vector<uint32_t> jumps;
+		for (size_t i = 0; i < node.children.size(); ++i)
+		{
+			if (i + 1 == node.children.size())
+			{
+				if (!compile(node.children[i])) return false;
+				break;
+			}
+			uint32_t split = emit(Inst::OP_SPLIT);
+			insts[split].x = split + 1;
+			if (!compile(node.children[i])) return false;
+			jumps.push_back(emit(Inst::OP_JUMP));
+			insts[split].y = (uint32_t)insts.size();
+		}
+		for (uint32_t jump : jumps)
+		{
+			insts[jump].x = (uint32_t)insts.size();
+		}
+		return true;
+	}
+	case Node::NODE_REPEAT:
+	{
+		const Node& child = node.children[0];
+		for (size_t i = 0; i < node.min; ++i)
+		{
+			if (!compile(child)) return false;
+		}
+
+		if (node.max == REPEAT_INFINITE)
+		{
+			// loop: split body, out; body; jump loop; out:
+			uint32_t split = emit(Inst::OP_SPLIT);
+			if (!compile(child)) return false;
+			emit(Inst::OP_JUMP, split);
+			uint32_t body = split + 1;
+			uint32_t out = (uint32_t)insts.size();
+			insts[split].x = node.greedy ? body : out;
+			insts[split].y = node.greedy ? out : body;
+			return true;
+		}
+
+		// 可选部分嵌套: (x(x(x)?)?)?，任何一层跳过时直接结束
+		std::vector<uint32_t> splits;
+		for (size_t i = node.min; i < node.max; ++i)
+		{
+			splits.push_back(emit(Inst::OP_SPLIT));
+			if (!compile(child)) return false;
+		}
+		uint32_t out = (uint32_t)insts.size();
+		for (uint32_t split : splits)
+		{
+			insts[split].x = node.greedy ? split + 1 : out;
+			insts[split].y = node.greedy ? out : split + 1;
+		}
+		return true;
+	}
+	}
+	return false;
+}
+
+void GiRegex::Program::computeClasses()
+{
+	// 逐个字节集合细分字节类: 同一类中属于该集合的字节分出新类
+	std::vector<uint32_t> current(256, 0);
+	uint32_t count = 1;
+	for (const ByteSet& set : sets)
+	{
+		std::vector<uint32_t> remap(count, UINT32_MAX);
+		for (size_t ch = 0; ch < 256; ++ch)
+		{
+			if (!set.has((unsigned char)ch)) continue;
+			uint32_t& target = remap[current[ch]];
+			if (target == UINT32_MAX) target = count++;
+			current[ch] = target;
+		}
+	}
+
+	// 重新紧凑编号
+	std::vector<uint32_t> compact(count, UINT32_MAX);
+	classCount = 0;
+	for (size_t ch = 0; ch < 256; ++ch)
+	{
+		uint32_t& id = compact[current[ch]];
+		if (id == UINT32_MAX)
+		{
+			id = (uint32_t)classCount++;
+			classByte[id] = (unsigned char)ch;
+		}
+		classes[ch] = (uint16_t)id;
+	}
+}
+
+void GiRegex::Program::addThread(std::vector<Thread>& list, std::vector<uint32_t>& marks, uint32_t generation, std::vector<uint32_t>& stack,
+	uint32_t pc, size_t start, const unsigned char* text, size_t length, size_t pos) const
+{
+	// 按优先级深度优先展开空转移，同一指令只加入一次
+	stack.push_back(pc);
+	while (!stack.empty())
+	{
+		pc = stack.back();
+		stack.pop_back();
+		if (marks[pc] == generation) continue;
+		marks[pc] = generation;
+
+		const Inst& inst = insts[pc];
+		switch (inst.op)
+		{
+		case Inst::OP_JUMP:
+			stack.push_back(inst.x);
+			break;
+		case Inst::OP_SPLIT:
+			stack.push_back(inst.y);
+			stack.push_back(inst.x);
+			break;
+		case Inst::OP_ASSERT:
+		{
+			bool holds = false;
+			switch ((Assertion)inst.x)
+			{
+			case ASSERT_BEGIN_TEXT:
+				holds = pos == 0;
+				break;
+			case ASSERT_END_TEXT:
+				holds = pos == length;
+				break;
+			case ASSERT_END_TEXT_LINE:
+				holds = pos == length
+					|| (pos + 1 == length && isLineTerminator(text[pos]))
+					|| (pos + 2 == length && text[pos] == '\r' && text[pos + 1] == '\n');
+				break;
+			case ASSERT_WORD_BOUNDARY:
+			case ASSERT_NOT_WORD_BOUNDARY:
+			{
+				bool before = pos > 0 && isWordByte(text[pos - 1]);
+				bool after = pos < length && isWordByte(text[pos]);
+				holds = (before != after) == (inst.x == ASSERT_WORD_BOUNDARY);
+				break;
+			}
+			}
+			if (holds) stack.push_back(pc + 1);
+			break;
+		}
+		default:
+			list.push_back(Thread{ pc, start });
+			break;
+		}
+	}
+}
+
+bool GiRegex::Program::run(const unsigned char* text, size_t length, size_t offset, bool anchored, size_t& start, size_t& end) const
+{
+	// anchored为true时整个字符串必须匹配，否则查找从offset开始的最左优先匹配
+	std::vector<Thread> current;
+	std::vector<Thread> next;
+	std::vector<uint32_t> marks(insts.size(), 0);
+	std::vector<uint32_t> stack;
+	uint32_t generation = 1;
+	bool matched = false;
+
+	for (size_t pos = offset; ; ++pos)
+	{
+		// 新的起点优先级最低
+		if (!matched && (!anchored || pos == offset))
+		{
+			addThread(current, marks, generation, stack, 0, pos, text, length, pos);
+		}
+		if (current.empty() && (matched || anchored)) break;
+
+		++generation;
+		for (const Thread& thread : current)
+		{
+			const Inst& inst = insts[thread.pc];
+			if (inst.op == Inst::OP_MATCH)
+			{
+				if (anchored && pos != length) continue;
+
+				// 优先级更低的线程不再需要
+				matched = true;
+				start = thread.start;
+				end = pos;
+				break;
+			}
+			if (pos < length && sets[inst.x].has(text[pos]))
+			{
+				addThread(next, marks, generation, stack, thread.pc + 1, thread.start, text, length, pos + 1);
+			}
+		}
+		current.swap(next);
+		next.clear();
+		if (pos >= length) break;
+	}
+	return matched;
+}
+
+uint32_t GiRegex::Program::dfaState(std::vector<uint32_t>& pcs)
+{
+	std::sort(pcs.begin(), pcs.end());
+	auto it = dfa.ids.find(pcs);
+	if (it != dfa.ids.end()) return it->second;
+
+	size_t bytes = sizeof(uint32_t) * (pcs.size() + classCount) + 64;
+	if (dfa.memory + bytes > DFA_MEMORY_LIMIT) return DFA_UNKNOWN;
+	dfa.memory += bytes;
+
+	uint32_t id = (uint32_t)dfa.states.size();
+	it = dfa.ids.insert(std::make_pair(pcs, id)).first;
+	dfa.states.push_back(&it->first);
+	dfa.transitions.resize(dfa.transitions.size() + classCount, DFA_UNKNOWN);
+
+	bool accepting = false;
+	for (uint32_t pc : pcs)
+	{
+		if (insts[pc].op == Inst::OP_MATCH) accepting = true;
+	}
+	dfa.accepting.push_back(accepting);
+	return id;
+}
+
+uint32_t GiRegex::Program::dfaNext(uint32_t state, size_t byteClass)
+{
+	// 没有边界指令，空转移的展开与位置无关
+	std::vector<Thread> list;
+	std::vector<uint32_t> marks(insts.size(), 0);
+	std::vector<uint32_t> stack;
+	unsigned char ch = classByte[byteClass];
+	for (uint32_t pc : *dfa.states[state])
+	{
+		const Inst& inst = insts[pc];
+		if (inst.op == Inst::OP_SET && sets[inst.x].has(ch))
+		{
+			addThread(list, marks, 1, stack, pc + 1, 0, nullptr, 0, 0);
+		}
+	}
+
+	std::vector<uint32_t> pcs;
+	pcs.reserve(list.size());
+	for (const Thread& thread : list)
+	{
+		pcs.push_back(thread.pc);
+	}
+	return dfaState(pcs);
+}
+
+int GiRegex::Program::dfaMatches(const unsigned char* text, size_t length)
+{
+	if (dfa.states.size() < 2)
+	{
+		// 状态0为空集合，状态1为起始状态
+		std::vector<uint32_t> pcs;
+		if (dfaState(pcs) == DFA_UNKNOWN) return -1;
+
+		std::vector<Thread> list;
+		std::vector<uint32_t> marks(insts.size(), 0);
+		std::vector<uint32_t> stack;
+		addThread(list, marks, 1, stack, 0, 0, nullptr, 0, 0);
+		for (const Thread& thread : list)
+		{
+			pcs.push_back(thread.pc);
+		}
+		if (dfaState(pcs) == DFA_UNKNOWN) return -1;
+	}
+
+	uint32_t state = 1;
+	for (size_t i = 0; i < length; ++i)
+	{
+		size_t byteClass = classes[text[i]];
+		uint32_t next = dfa.transitions[state * classCount + byteClass];
+		if (next == DFA_UNKNOWN)
+		{
+			next = dfaNext(state, byteClass);
+			if (next == DFA_UNKNOWN) return -1;
+			dfa.transitions[state * classCount + byteClass] = next;
+		}
+		if (next == DFA_DEAD) return 0;
+		state = next;
+	}
+	return dfa.accepting[state] ? 1 : 0;
+}
+
+/**
+ * @brief 按表达式文本索引的LRU缓存
+ */
+struct GiRegex::Cache
+{
+	typedef std::list<std::shared_ptr<Program>> List;
+
+	std::mutex lock;
+	List entries;	// 最近使用的在前
+	std::unordered_multimap<size_t, List::iterator> index;	// 表达式的hash -> 缓存项，查找时不需要复制表达式
+	size_t capacity;
+	size_t hits;
+	size_t misses;
+
+	Cache()
+		: capacity(GI_STRING_REGEX_CACHE_CAPACITY), hits(0), misses(0)
+	{
+	}
+
+	List::iterator find(const GiStringView& pattern, size_t hash)
+	{
+		auto range = index.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if ((*it->second)->pattern.view() == pattern) return it->second;
+		}
+		return entries.end();
+	}
+
+	void evict()
+	{
+		while (entries.size() > capacity)
+		{
+			auto range = index.equal_range(entries.back()->pattern.view().hashCode());
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (*it->second == entries.back())
+				{
+					index.erase(it);
+					break;
+				}
+			}
+			entries.pop_back();
+		}
+	}
+};
+
+GiRegex::GiRegex(const GiStringView& pattern)
+	: m_program(std::make_shared<Program>(pattern))
+{
+	Program& program = *m_program;
+	Node root;
+	Parser parser(program.pattern.c_str(), program.pattern.length());
+	if (!parser.parse(root))
+	{
+		program.error = parser.error();
+		return;
+	}
+
+	// 起点为指令0
+	if (!program.compile(root)) return;
+	program.insts.push_back(Inst{ Inst::OP_MATCH, 0, 0 });
+	program.computeClasses();
+
+	GiString text;
+	if (Split::literalText(program.pattern.view(), text))
+	{
+		program.literal.reset(new GiSearcher(text.view()));
+	}
+}
+
+GiRegex::GiRegex(const std::shared_ptr<Program>& program)
+	: m_program(program)
+{
+}
+
+GiRegex::Cache& GiRegex::cache()
+{
+	static Cache s_cache;
+	return s_cache;
+}
+
+GiRegex GiRegex::cached(const GiStringView& pattern)
+{
+	Cache& c = cache();
+	size_t hash = pattern.hashCode();
+	{
+		std::lock_guard<std::mutex> guard(c.lock);
+		auto it = c.find(pattern, hash);
+		if (it != c.entries.end())
+		{
+			++c.hits;
+			c.entries.splice(c.entries.begin(), c.entries, it);
+			return GiRegex(*it);
+		}
+		++c.misses;
+	}
+
+	// 编译时不持有锁。缓存全局共享，表达式和字面量查找器的字符串
+	// 不能来自调用者作用域内的分配器(如GiArenaAllocator)，固定使用默认分配器
+	GiAllocatorScope scope(GiAllocator::defaultAllocator());
+	GiRegex regex(pattern);
+
+	std::lock_guard<std::mutex> guard(c.lock);
+	if (c.capacity == 0 || c.find(pattern, hash) != c.entries.end()) return regex;
+	c.entries.push_front(regex.m_program);
+	c.index.insert(std::make_pair(hash, c.entries.begin()));
+	c.evict();
+	return regex;
+}
+
+void GiRegex::setCacheCapacity(size_t capacity)
+{
+	Cache& c = cache();
+	std::lock_guard<std::mutex> guard(c.lock);
+	c.capacity = capacity;
+	c.evict();
+}
+
+void GiRegex::clearCache()
+{
+	Cache& c = cache();
+	std::lock_guard<std::mutex> guard(c.lock);
+	c.index.clear();
+	c.entries.clear();
+	c.hits = 0;
+	c.misses = 0;
+}
+
+GiRegexCacheStats GiRegex::cacheStats()
+{
+	Cache& c = cache();
+	std::lock_guard<std::mutex> guard(c.lock);
+	return GiRegexCacheStats{ c.hits, c.misses, c.entries.size() };
+}
+
+bool GiRegex::isValid() const
+{
+	return m_program->error == nullptr;
+}
+
+const GI_STRING_DATA_TYPE* GiRegex::error() const
+{
+	return m_program->error;
+}
+
+bool GiRegex::isLiteral() const
+{
+	return m_program->literal != nullptr;
+}
+
+GiStringView GiRegex::pattern() const
+{
+	return m_program->pattern.view();
+}
+
+bool GiRegex::matches(const GiStringView& str) const
+{
+	if (!isValid()) return false;
+
+	Program& program = *m_program;
+	if (program.literal) return str == program.literal->pattern();
+
+	const unsigned char* text = (const unsigned char*)str.data();
+	if (!program.hasAssertions)
+	{
+		// DFA缓存被占用时不等待
+		std::unique_lock<std::mutex> guard(program.dfaLock, std::try_to_lock);
+		if (guard.owns_lock())
+		{
+			int result = program.dfaMatches(text, str.length());
+			if (result >= 0) return result == 1;
+		}
+	}
+
+	size_t start;
+	size_t end;
+	return program.run(text, str.length(), 0, true, start, end);
+}
+
+bool GiRegex::find(const GiStringView& str, size_t offset, size_t& start, size_t& end) const
+{
+	if (!isValid() || offset > str.length()) return false;
+
+	const GiSearcher* literal = m_program->literal.get();
+	if (literal)
+	{
+		start = literal->indexOf(str, offset);
+		end = start + literal->length();
+		return start != SIZE_MAX;
+	}
+
+	return m_program->run((const unsigned char*)str.data(), str.length(), offset, false, start, end);
+}
+
+std::vector<GiString> GiRegex::split(const GiStringView& str, int limit) const
+{
+	return Split::collect(str, limit, [&](size_t offset, size_t& start, size_t& end) {
+		return find(str, offset, start, end);
+	});
+}
+
+bool Split::literalChar(const GiStringView& regex, GI_STRING_DATA_TYPE& ch)
+{
+	const unsigned char* data = (const unsigned char*)regex.data();
+	unsigned char literal;
+	if (regex.length() == 1 && !isMetaChar(data[0]))
+	{
+		ch = (GI_STRING_DATA_TYPE)data[0];
+		return true;
+	}
+	if (regex.length() == 2 && data[0] == '\\' && literalEscape(data[1], literal))
+	{
+		ch = (GI_STRING_DATA_TYPE)literal;
+		return true;
+	}
+	return false;
+}
+
+bool Split::literalText(const GiStringView& regex, GiString& text)
+{
+	const unsigned char* data = (const unsigned char*)regex.data();
+	size_t length = regex.length();
+	if (length == 0) return false;
+
+	// 大多数表达式没有转义，可以直接使用原字符串
+	size_t i = 0;
+	while (i < length && !isMetaChar(data[i])) ++i;
+	if (i == length)
+	{
+		text = GiString(regex);
+		return true;
+	}
+
+	GiStringBuilder builder(length);
+	builder.append(regex.data(), i);
+	for (; i < length; ++i)
+	{
+		unsigned char literal = data[i];
+		if (isMetaChar(data[i]))
+		{
+			if (data[i] != '\\' || i + 1 == length || !literalEscape(data[i + 1], literal)) return false;
+			++i;
+		}
+		builder.append((GI_STRING_DATA_TYPE)literal);
+	}
+	text = std::move(builder).toString();
+	return true;
+}
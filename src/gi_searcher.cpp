@@ -0,0 +1,64 @@
+﻿#include "gikoo/gi_searcher.h"
+#include "gi_string_search.h"
+
+#define MIN(x,y) (x > y ? y : x)
+
+using namespace GiKoo;
+
+/**
+ * @brief 预处理结果，构造后只读
+ */
+struct GiSearcher::Plan
+{
+	GiString pattern;
+	Search::TwoWayPlan forward;
+	Search::TwoWayPlan backward;
+
+	explicit Plan(const GiStringView& str)
+		: pattern(str)
+	{
+		// 短字符串的正序查找使用SIMD首尾字节过滤，不需要移动表
+		const GI_STRING_DATA_TYPE* data = pattern.c_str();
+		size_t length = pattern.length();
+		if (length > Search::SHORT_NEEDLE_LENGTH) Search::prepare(forward, data, length, false);
+		if (length > 1) Search::prepare(backward, data, length, true);
+	}
+};
+
+GiSearcher::GiSearcher(const GiStringView& pattern)
+	: m_plan(std::make_shared<const Plan>(pattern))
+{
+}
+
+size_t GiSearcher::indexOf(const GiStringView& str, size_t offset) const
+{
+	if (offset > str.length()) return SIZE_MAX;
+
+	const GiString& pattern = m_plan->pattern;
+	size_t found = Search::find(str.data() + offset, str.length() - offset, pattern.c_str(), pattern.length(), &m_plan->forward);
+	return found == SIZE_MAX ? SIZE_MAX : offset + found;
+}
+
+size_t GiSearcher::lastIndexOf(const GiStringView& str, size_t offset) const
+{
+	const GiString& pattern = m_plan->pattern;
+	if (pattern.length() > str.length()) return SIZE_MAX;
+
+	size_t limit = MIN(offset, str.length() - pattern.length()) + pattern.length();
+	return Search::findLast(str.data(), limit, pattern.c_str(), pattern.length(), &m_plan->backward);
+}
+
+bool GiSearcher::contains(const GiStringView& str) const
+{
+	return indexOf(str) != SIZE_MAX;
+}
+
+GiStringView GiSearcher::pattern() const
+{
+	return m_plan->pattern.view();
+}
+
+size_t GiSearcher::length() const
+{
+	return m_plan->pattern.length();
+}
@@ -0,0 +1,168 @@
+﻿#include "gikoo/gi_split_range.h"
+#include "gikoo/gi_searcher.h"
+#include "gikoo/gi_regex.h"
+
+using namespace GiKoo;
+
+GiSplitRange::GiSplitRange(const GiStringView& str, GI_STRING_DATA_TYPE delimiter, int limit)
+	: m_str(str), m_limit(limit), m_mode(MODE_CHAR), m_delimiter(delimiter), m_searcher(nullptr), m_regex(nullptr)
+{
+}
+
+GiSplitRange::GiSplitRange(const GiStringView& str, const GiSearcher& separator, int limit)
+	: m_str(str), m_limit(limit), m_mode(MODE_SEARCHER), m_delimiter(0), m_searcher(&separator), m_regex(nullptr)
+{
+}
+
+GiSplitRange::GiSplitRange(const GiStringView& str, const GiRegex& regex, int limit)
+	: m_str(str), m_limit(limit), m_mode(MODE_REGEX), m_delimiter(0), m_searcher(nullptr), m_regex(&regex)
+{
+}
+
+GiSplitRange::GiSplitRange(const GiStringView& str, const std::shared_ptr<const GiRegex>& regex, int limit)
+	: m_str(str), m_limit(limit), m_mode(MODE_REGEX), m_delimiter(0), m_searcher(nullptr), m_regex(regex.get()), m_ownedRegex(regex)
+{
+}
+
+GiSplitRange::Iterator GiSplitRange::begin() const
+{
+	return Iterator(this);
+}
+
+GiSplitRange::Iterator GiSplitRange::end() const
+{
+	return Iterator(nullptr);
+}
+
+bool GiSplitRange::find(size_t offset, size_t& start, size_t& end) const
+{
+	switch (m_mode)
+	{
+	case MODE_CHAR:
+		start = m_str.indexOf(m_delimiter, offset);
+		end = start + 1;
+		return start != SIZE_MAX;
+	case MODE_SEARCHER:
+		start = m_searcher->indexOf(m_str, offset);
+		end = start + m_searcher->length();
+		return start != SIZE_MAX;
+	default:
+		return m_regex->find(m_str, offset, start, end);
+	}
+}
+
+bool GiSplitRange::next(State& state, GiStringView& token) const
+{
+	if (state.done) return false;
+
+	// 达到limit后剩余部分作为最后一个子串
+	size_t start;
+	size_t end;
+	bool limited = m_limit > 0;
+	while ((!limited || state.count < (size_t)m_limit - 1) && state.offset <= m_str.length() && find(state.offset, start, end))
+	{
+		// 空匹配之后从下一个字节继续查找
+		state.offset = end == start ? end + 1 : end;
+
+		// 开头的零宽匹配不产生空字符串
+		if (state.index == 0 && start == 0 && end == 0) continue;
+
+		token = m_str.subString(state.index, start - state.index);
+		state.index = end;
+		++state.count;
+		return true;
+	}
+
+	token = m_str.subString(state.index);
+	state.done = true;
+	return true;
+}
+
+GiSplitRange::Iterator::Iterator(const GiSplitRange* range)
+	: m_range(range), m_confirmedEmpty(0)
+{
+	m_state.index = 0;
+	m_state.offset = 0;
+	m_state.count = 0;
+	m_state.done = false;
+	if (m_range) advance();
+}
+
+void GiSplitRange::Iterator::advance()
+{
+	GiStringView token;
+	if (!m_range->next(m_state, token))
+	{
+		m_range = nullptr;
+		return;
+	}
+
+	// 没有任何匹配时(index为0的剩余部分)与Java一致返回原字符串，即使为空
+	bool whole = m_state.done && m_state.count == 0;
+	if (token.isEmpty() && m_range->m_limit == 0 && !whole)
+	{
+		if (m_confirmedEmpty > 0)
+		{
+			--m_confirmedEmpty;
+		}
+		else
+		{
+			// 向后查看，之后全是空子串时在此结束
+			State probe = m_state;
+			GiStringView ahead;
+			size_t empty = 0;
+			bool found = false;
+			while (m_range->next(probe, ahead))
+			{
+				if (!ahead.isEmpty())
+				{
+					found = true;
+					break;
+				}
+				++empty;
+			}
+			if (!found)
+			{
+				m_range = nullptr;
+				return;
+			}
+			m_confirmedEmpty = empty;
+		}
+	}
+	m_token = token;
+}
+
+const GiStringView& GiSplitRange::Iterator::operator*() const
+{
+	return m_token;
+}
+
+const GiStringView* GiSplitRange::Iterator::operator->() const
+{
+	return &m_token;
+}
+
+GiSplitRange::Iterator& GiSplitRange::Iterator::operator++()
+{
+	advance();
+	return *this;
+}
+
+GiSplitRange::Iterator GiSplitRange::Iterator::operator++(int)
+{
+	Iterator ret = *this;
+	advance();
+	return ret;
+}
+
+bool GiSplitRange::Iterator::operator==(const Iterator& another) const
+{
+	if (m_range != another.m_range) return false;
+	if (!m_range) return true;
+	return m_state.count == another.m_state.count && m_state.done == another.m_state.done && m_confirmedEmpty == another.m_confirmedEmpty;
+}
+
+bool GiSplitRange::Iterator::operator!=(const Iterator& another) const
+{
+	return !(*this == another);
+}
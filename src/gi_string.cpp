@@ -1,8 +1,23 @@
 ﻿#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gikoo/gi_allocator.h"
+#include "gikoo/gi_string_builder.h"
+#include "gikoo/gi_searcher.h"
+#include "gikoo/gi_regex.h"
+#include "gikoo/gi_split_range.h"
+#include "gikoo/gi_static_string.h"
+#include "gi_string_hash.h"
+#include "gi_string_search.h"
+#include "gi_string_simd.h"
+#include "gi_string_split.h"
+#include "gi_string_parallel.h"
 #include <cstring>
 #include <cmath>
 #include <cassert>
-#include <unordered_set>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <new>
 
 #define MIN(x,y) (x > y ? y : x)
 #define MAX(x,y) (x > y ? x : y)
@@ -11,19 +26,309 @@
 
 using namespace GiKoo;
 
+namespace
+{
+#if GI_STRING_MEMORY_STATS
+	enum StatsCounter
+	{
+		s_liveBytes,
+		s_liveObjects,
+		s_totalAllocations,
+		s_totalFrees,
+		STATS_COUNT
+	};
+
+	/**
+	 * @brief 一组统计计数器
+	 *
+	 * @details 每个线程独占一组，只由该线程写入，写入不需要原子的读改写指令，也不与其他线程争用缓存行。
+	 *  查询时加总所有分组。对象在一个线程构造、在另一个线程析构时，单个分组的数值可能"为负"，
+	 *  按无符号数回绕，加总后仍然正确。
+	 */
+	struct StatsShard
+	{
+		std::atomic<size_t> counters[STATS_COUNT];
+		StatsShard* next;		// 注册表中的下一组
+		bool inUse;				// 是否被某个线程占用，由注册表的锁保护
+		char padding[64];		// 与相邻分配的其他分组隔开，避免伪共享
+	};
+
+	/**
+	 * @brief 所有分组。线程退出后分组保留数值，由之后的线程复用
+	 */
+	struct StatsRegistry
+	{
+		std::mutex lock;
+		StatsShard* shards = nullptr;
+		StatsShard shared = {};		// 线程退出阶段的计数，多个线程可能同时写入，使用原子的读改写
+	};
+
+	StatsRegistry& statsRegistry()
+	{
+		// 不析构，其他线程在进程退出阶段仍可能计数
+		static StatsRegistry* registry = new StatsRegistry();
+		return *registry;
+	}
+
+	thread_local StatsShard* t_stats = nullptr;
+	thread_local bool t_statsReleased = false;
+
+	/**
+	 * @brief 线程退出时归还分组
+	 */
+	struct StatsOwner
+	{
+		~StatsOwner()
+		{
+			StatsRegistry& registry = statsRegistry();
+			std::lock_guard<std::mutex> guard(registry.lock);
+			t_stats->inUse = false;
+			t_stats = nullptr;
+			t_statsReleased = true;
+		}
+	};
+
+	void statsAddSlow(size_t counter, size_t value)
+	{
+		StatsRegistry& registry = statsRegistry();
+		if (t_statsReleased)
+		{
+			registry.shared.counters[counter].fetch_add(value, std::memory_order_relaxed);
+			return;
+		}
+
+		// 本线程首次计数，占用空闲的分组或者新建一组
+		static thread_local StatsOwner owner;
+		(void)owner;
+		{
+			std::lock_guard<std::mutex> guard(registry.lock);
+			StatsShard* shard = registry.shards;
+			while (shard && shard->inUse)
+			{
+				shard = shard->next;
+			}
+			if (!shard)
+			{
+				shard = new StatsShard();
+				shard->next = registry.shards;
+				registry.shards = shard;
+			}
+			shard->inUse = true;
+			t_stats = shard;
+		}
+		t_stats->counters[counter].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	inline void statsAdd(size_t counter, size_t value)
+	{
+		StatsShard* shard = t_stats;
+		if (!shard)
+		{
+			statsAddSlow(counter, value);
+			return;
+		}
+
+		// 只有本线程写入，读取和写入分开进行即可
+		std::atomic<size_t>& target = shard->counters[counter];
+		target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+#define STATS_ADD(counter, value) statsAdd(counter, value)
+#define STATS_SUB(counter, value) statsAdd(counter, (size_t)0 - (size_t)(value))
+#else
+#define STATS_ADD(counter, value) ((void)0)
+#define STATS_SUB(counter, value) ((void)0)
+#endif
+
+	/**
+	 * @brief 堆缓冲区头部，紧挨在字符数据之前
+	 */
+	struct GiStringBlock
+	{
+		std::atomic<size_t> refs;	// 引用计数
+		GiAllocator* allocator;		// 申请该缓冲区的分配器
+		size_t bytes;				// 整块内存的字节数，包含头部
+		bool shareable;				// 是否允许共享。operator[]交出可写引用后不再共享
+		bool interned;				// 是否属于驻留池。驻留池持有一份引用，因此内容不会被原地修改
+	};
+
+	GiStringBlock* blockOf(const GI_STRING_DATA_TYPE* data)
+	{
+		return (GiStringBlock*)((char*)data - sizeof(GiStringBlock));
+	}
+
+	/**
+	 * @brief 从当前线程的分配器申请堆缓冲区，引用计数为1
+	 *
+	 * @param capacity 可容纳的字符数，不含结束符
+	 * @param allocator 使用的分配器
+	 *
+	 * @return 字符数据起点
+	 */
+	GI_STRING_DATA_TYPE* allocateBlock(size_t capacity, GiAllocator* allocator = GiAllocator::current())
+	{
+		size_t bytes = sizeof(GiStringBlock) + sizeof(GI_STRING_DATA_TYPE) * (capacity + 1);
+		char* raw = (char*)allocator->allocate(bytes);
+		assert(raw != nullptr);
+
+		STATS_ADD(s_liveBytes, bytes);
+		STATS_ADD(s_totalAllocations, 1);
+
+		GiStringBlock* block = new (raw) GiStringBlock();
+		block->refs.store(1, std::memory_order_relaxed);
+		block->allocator = allocator;
+		block->bytes = bytes;
+		block->shareable = true;
+		block->interned = false;
+		return (GI_STRING_DATA_TYPE*)(raw + sizeof(GiStringBlock));
+	}
+
+	/**
+	 * @brief 引用计数减一，归零时将堆缓冲区归还给申请它的分配器
+	 */
+	void releaseBlock(GI_STRING_DATA_TYPE* data)
+	{
+		GiStringBlock* block = blockOf(data);
+		if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			STATS_SUB(s_liveBytes, block->bytes);
+			STATS_ADD(s_totalFrees, 1);
+
+			GiAllocator* allocator = block->allocator;
+			size_t bytes = block->bytes;
+			block->~GiStringBlock();
+			allocator->deallocate(block, bytes);
+		}
+	}
+
+	/**
+	 * @brief 驻留池的一个分片，以hash数值为键，冲突时逐个比较内容
+	 */
+	struct InternShard
+	{
+		std::mutex lock;
+		std::unordered_multimap<size_t, GiString> entries;
+		size_t bytes = 0;			// 分片内驻留字符串占用的堆内存字节数
+	};
+
+	/**
+	 * @brief 获得hash数值所属的分片
+	 */
+	InternShard& internShard(size_t hash)
+	{
+		static InternShard s_shards[GI_STRING_INTERN_SHARDS];
+		return s_shards[hash % GI_STRING_INTERN_SHARDS];
+	}
+
+	/**
+	 * @brief 替换所有不重叠的匹配
+	 *
+	 * @param source 原字符串
+	 * @param targetLength 旧字符串的长度。为0时与Java一致，在每个字符前后各替换一次
+	 * @param replacement 新字符串
+	 * @param find 从指定位置开始查找旧字符串，未找到时返回SIZE_MAX
+	 *
+	 * @return 替换后的字符串。没有匹配时共享原字符串
+	 */
+	template <typename Find>
+	GiString replaceAll(const GiString& source, size_t targetLength, const GiString& replacement, Find find)
+	{
+		size_t length = source.length();
+		const GI_STRING_DATA_TYPE* data = source.c_str();
+
+		if (targetLength == 0)
+		{
+			GiStringBuilder builder;
+			builder.reserve(length + replacement.length() * (length + 1));
+			builder.append(replacement);
+			for (size_t i = 0; i < length; ++i)
+			{
+				builder.append(data[i]);
+				builder.append(replacement);
+			}
+			return std::move(builder).toString();
+		}
+
+		size_t pos = find(0);
+		if (pos == SIZE_MAX) return source;
+
+		GiStringBuilder builder;
+		builder.reserve(length);
+		size_t start = 0;
+		while (pos != SIZE_MAX)
+		{
+			builder.append(data + start, pos - start);
+			builder.append(replacement);
+			start = pos + targetLength;
+			pos = find(start);
+		}
+		builder.append(data + start, length - start);
+		return std::move(builder).toString();
+	}
+
+	/**
+	 * @brief 生成GiString结果时能否并行拆分
+	 *
+	 * @details GiAllocatorScope只对当前线程生效，且分配器(如GiArenaAllocator)不一定线程安全，
+	 *  因此只有使用默认分配器时才交给线程池。
+	 */
+	bool parallelAllocation(size_t length)
+	{
+		return GiAllocator::current() == GiAllocator::defaultAllocator() && Parallel::enabled(length);
+	}
+
+	/**
+	 * @brief 按普通字符串并行拆分，规则与Split::collect()相同
+	 *
+	 * @param source 原字符串
+	 * @param separatorLength 分隔符长度，至少为1
+	 * @param limit 不大于0
+	 * @param find 查找函数，见Parallel::split()
+	 *
+	 * @return 结果集合。没有匹配时共享原字符串
+	 */
+	template <typename Find>
+	std::vector<GiString> splitParallel(const GiString& source, size_t separatorLength, int limit, Find find)
+	{
+		GiStringView view = source.view();
+		std::vector<GiString> ret;
+		bool matched = Parallel::split(view, separatorLength, limit, find, ret, [&](size_t start, size_t length) {
+			return GiString(view.subString(start, length));
+		}, Parallel::ThreadPool::shared());
+		if (!matched) ret.push_back(source);
+		return ret;
+	}
+}
+
 
 GiString::GiString()
+	: m_data(m_local), m_length(0), m_hash(0)
 {
-	empty();
+	m_local[0] = 0;
+	STATS_ADD(s_liveObjects, 1);
 }
 
 GiString::GiString(const GiString& str)
+	: m_data(m_local), m_length(0), m_hash(0)
 {
+	m_local[0] = 0;
+	STATS_ADD(s_liveObjects, 1);
 	copy(str);
 }
 
+GiString::GiString(GiString&& str) noexcept
+	: m_data(m_local), m_length(0), m_hash(0)
+{
+	STATS_ADD(s_liveObjects, 1);
+	take(str);
+}
+
 GiString::GiString(const GI_STRING_DATA_TYPE* str, size_t offset, size_t length, const GI_STRING_DATA_TYPE* charsetName)
+	: m_data(m_local), m_length(0), m_hash(0)
 {
+	m_local[0] = 0;
+	STATS_ADD(s_liveObjects, 1);
+
 	// TODO: 未使用的变量
 	UNUSED_VAR(charsetName);
 
@@ -43,152 +348,153 @@ GiString::GiString(const GI_STRING_DATA_TYPE* str, size_t offset, size_t length,
 	}
 
 	// 字符串拷贝处理
-	copy(str + offset, length);
+	assign(str + offset, MIN(strLen - offset, length));
 }
 
-GiString::~GiString()
+GiString::GiString(const GiStringView& str)
+	: m_data(m_local), m_length(0), m_hash(0)
 {
-	if (m_data)
+	m_local[0] = 0;
+	STATS_ADD(s_liveObjects, 1);
+
+	assign(str.data(), str.length());
+}
+
+GiString::GiString(const GiStaticString& str)
+	: m_data(m_local), m_length(str.length()), m_hash(str.hashCode())
+{
+	STATS_ADD(s_liveObjects, 1);
+
+	if (m_length <= GI_STRING_SSO_CAPACITY)
 	{
-		delete[] m_data;
+		memcpy(m_local, str.c_str(), sizeof(GI_STRING_DATA_TYPE) * m_length);
+		m_local[m_length] = 0;
+		return;
 	}
+
+	// 静态数据只读，isShared()对其返回true，任何写入都会先复制
+	m_data = const_cast<GI_STRING_DATA_TYPE*>(str.c_str());
+	m_capacity = 0;
 }
 
-const GI_STRING_DATA_TYPE* GiString::compareTo(const GiString& another) const
+GiString::~GiString()
 {
-	if (isEmpty() && another.isEmpty()) return nullptr;
-	if (isEmpty() || another.isEmpty()) return m_data;
+	release();
+	STATS_SUB(s_liveObjects, 1);
+}
 
-	const GI_STRING_DATA_TYPE* cur = m_data;
-	const GI_STRING_DATA_TYPE* anotherCur = another.m_data;
-	while (*cur != '\0' && *anotherCur != '\0')
-	{
-		if (*cur != *anotherCur) break;
+int GiString::compareTo(const GiString& another) const
+{
+	return GiStringView(m_data, m_length).compareTo(GiStringView(another.m_data, another.m_length));
+}
 
-		++cur;
-		++anotherCur;
-	}
-	
-	if (*cur == '\0' && *anotherCur == '\0') return nullptr;
+const GI_STRING_DATA_TYPE* GiString::mismatch(const GiString& another) const
+{
+	// 共享同一块缓冲区
+	if (m_data == another.m_data && m_length == another.m_length) return nullptr;
 
-	return cur;
+	size_t index = Simd::mismatch(m_data, another.m_data, MIN(m_length, another.m_length));
+	if (index == m_length && index == another.m_length) return nullptr;
+	return m_data + index;
 }
 
 bool GiString::equals(const GiString& another) const
 {
-	return compareTo(another) == nullptr;
+	if (m_length != another.m_length) return false;
+	if (m_data == another.m_data) return true;
+
+	// 驻留池中内容相同的字符串只有一份，两个驻留字符串地址不同即内容不同
+	if (isInterned() && another.isInterned()) return false;
+
+	// 不使用缓存的hash数值判定不等：通过operator[]取得的引用写入后缓存可能已经过期
+	return Simd::equal(m_data, another.m_data, m_length);
 }
 
-bool GiString::operator==(const GiString& another) const
+bool GiString::matches(const GI_STRING_DATA_TYPE* regex) const
 {
-	return compareTo(another) == nullptr;
+	if (!regex) return false;
+
+	return GiRegex::cached(regex).matches(view());
 }
 
-bool GiString::matches(const GI_STRING_DATA_TYPE* regex) const
+bool GiString::matches(const GiRegex& regex) const
 {
-	// TODO: Not Implements
-	return false;
+	return regex.matches(view());
 }
 
 bool GiString::contains(const GiString& str) const
 {
-	return strstr(m_data, str.m_data) != nullptr;
+	return view().contains(str.view());
+}
+
+bool GiString::contains(const GiSearcher& searcher) const
+{
+	return searcher.contains(view());
 }
 
 bool GiString::isBlank() const
 {
-	auto cur = m_data;
-	while (*cur != '\0')
-	{
-		if (*cur != ' ') return false;
-		++cur;
-	}
-	return true;
+	return view().isBlank();
 }
 
-bool GiString::isEmpty() const
+GiString GiString::strip(const GI_STRING_DATA_TYPE* coll) const &
 {
-	return length() == 0;
+	return GiString(view().strip(coll));
 }
 
-GiString GiString::strip(const GI_STRING_DATA_TYPE* coll)
+GiString GiString::strip(const GI_STRING_DATA_TYPE* coll) &&
 {
-	return stripLeading(coll).stripTrailing(coll);
+	return std::move(stripInPlace(coll));
 }
 
-GiString GiString::stripLeading(const GI_STRING_DATA_TYPE* coll)
+GiString GiString::stripLeading(const GI_STRING_DATA_TYPE* coll) const &
 {
-	if (coll == nullptr) coll = " \r\n\t";
+	return GiString(view().stripLeading(coll));
+}
 
-	std::unordered_set<GI_STRING_DATA_TYPE> set;
-	while (*coll != '\0')
-	{
-		set.emplace(*coll++);
-	}
+GiString GiString::stripLeading(const GI_STRING_DATA_TYPE* coll) &&
+{
+	return std::move(stripLeadingInPlace(coll));
+}
 
-	char* cur = m_data;
-	while (*cur != '\0')
-	{
-		if (set.find(*cur) != set.end())
-			++cur;
-		else
-			break;
-	}
-	
-	return cur;
+GiString GiString::stripTrailing(const GI_STRING_DATA_TYPE* coll) const &
+{
+	return GiString(view().stripTrailing(coll));
 }
 
-GiString GiString::stripTrailing(const GI_STRING_DATA_TYPE* coll)
+GiString GiString::stripTrailing(const GI_STRING_DATA_TYPE* coll) &&
 {
-	if (coll == nullptr) coll = " \r\n\t";
-	std::unordered_set<GI_STRING_DATA_TYPE> set;
-	while (*coll != '\0')
-	{
-		set.emplace(*coll++);
-	}
-	set.emplace('\0');
+	return std::move(stripTrailingInPlace(coll));
+}
 
-	char* cur = m_data + length();
-	while (cur >= m_data)
-	{
-		if (set.find(*cur) != set.end())
-			--cur;
-		else
-			break;
-	}
+GiString GiString::trim() const &
+{
+	return GiString(view().trim());
+}
 
-	return subString(0, cur - m_data + 1);
+GiString GiString::trim() &&
+{
+	return std::move(trimInPlace());
 }
 
-GiString GiString::trim()
+GiString GiString::trimStart() const &
 {
-	return trimStart().trimEnd();
+	return GiString(view().trimStart());
 }
 
-GiString GiString::trimStart()
+GiString GiString::trimStart() &&
 {
-	char* cur = m_data;
-	while (*cur != '\0')
-	{
-		if (*cur <= 0x20)
-			++cur;
-		else
-			break;
-	}
-	return cur;
+	return std::move(trimStartInPlace());
 }
 
-GiString GiString::trimEnd()
+GiString GiString::trimEnd() const &
 {
-	char* cur = m_data + length();
-	while (cur >= m_data)
-	{
-		if (*cur <= 0x20)
-			--cur;
-		else
-			break;
-	}
-	return subString(0, cur - m_data + 1);
+	return GiString(view().trimEnd());
+}
+
+GiString GiString::trimEnd() &&
+{
+	return std::move(trimEndInPlace());
 }
 
 GiString GiString::toLowerCase() const
@@ -203,64 +509,257 @@ GiString GiString::toUpperCase() const
 	return "";
 }
 
-GiString GiString::replace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar) const
+GiString GiString::replace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar) const &
 {
-	// TODO: Not Implements
-	return "";
+	size_t pos = oldChar == newChar ? SIZE_MAX : view().indexOf(oldChar);
+	if (pos == SIZE_MAX) return *this;
+
+	GiString ret;
+	ret.assign(m_data, m_length);
+	while (pos != SIZE_MAX)
+	{
+		ret.m_data[pos] = newChar;
+		pos = ret.view().indexOf(oldChar, pos + 1);
+	}
+	return ret;
 }
 
-GiString GiString::replace(const GiString& oldStr, const GiString& newStr) const
+GiString GiString::replace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar) &&
 {
-	// TODO: Not Implements
-	return "";
+	return std::move(replaceInPlace(oldChar, newChar));
 }
 
-GiString GiString::concat(const GiString& str) const
+GiString GiString::replace(const GiString& oldStr, const GiString& newStr) const &
 {
-	// TODO: Not Implements
-	return "";
+	GiStringView source = view();
+	GiStringView target = oldStr.view();
+
+	// 长字符串只预处理一次，所有匹配共用
+	Search::TwoWayPlan plan;
+	const Search::TwoWayPlan* prepared = nullptr;
+	if (target.length() > Search::SHORT_NEEDLE_LENGTH)
+	{
+		Search::prepare(plan, target.data(), target.length(), false);
+		prepared = &plan;
+	}
+
+	return replaceAll(*this, target.length(), newStr, [&](size_t offset) {
+		size_t found = Search::find(source.data() + offset, source.length() - offset, target.data(), target.length(), prepared);
+		return found == SIZE_MAX ? SIZE_MAX : offset + found;
+	});
 }
 
-std::vector<GiString> GiString::split(const GiString& regex) const
+GiString GiString::replace(const GiString& oldStr, const GiString& newStr) &&
 {
-	// TODO: Not Implements
-	std::vector<GiString> ret;
+	return std::move(replaceInPlace(oldStr, newStr));
+}
+
+GiString GiString::replace(const GiSearcher& oldStr, const GiString& newStr) const
+{
+	GiStringView source = view();
+	return replaceAll(*this, oldStr.length(), newStr, [&](size_t offset) { return oldStr.indexOf(source, offset); });
+}
+
+GiString GiString::concat(const GiString& str) const
+{
+	GiString ret;
+	ret.reserve(m_length + str.m_length);
+	memcpy(ret.m_data, m_data, sizeof(GI_STRING_DATA_TYPE) * m_length);
+	memcpy(ret.m_data + m_length, str.m_data, sizeof(GI_STRING_DATA_TYPE) * (str.m_length + 1));
+	ret.m_length = m_length + str.m_length;
 	return ret;
 }
 
+std::vector<GiString> GiString::split(const GiString& regex, int limit) const
+{
+	GiStringView source = view();
+
+	// 与JDK相同的快速路径: 单个字符的分隔符直接用SIMD查找，不经过正则引擎和缓存
+	GI_STRING_DATA_TYPE delimiter;
+	bool parallel = limit <= 0 && parallelAllocation(m_length);
+	if (Split::literalChar(regex.view(), delimiter))
+	{
+		if (parallel)
+		{
+			return splitParallel(*this, 1, limit, [&](const GiStringView& window, size_t offset) {
+				return window.indexOf(delimiter, offset);
+			});
+		}
+		return Split::collect(source, limit, [&](size_t offset, size_t& start, size_t& end) {
+			start = source.indexOf(delimiter, offset);
+			end = start + 1;
+			return start != SIZE_MAX;
+		}, this);
+	}
+
+	// 较长的字符串按普通字符串并行拆分
+	GiString text;
+	if (parallel && Split::literalText(regex.view(), text))
+	{
+		GiSearcher separator(text.view());
+		return splitParallel(*this, separator.length(), limit, [&](const GiStringView& window, size_t offset) {
+			return separator.indexOf(window, offset);
+		});
+	}
+
+	// 多个字符的普通字符串由GiRegex识别，同样不运行自动机
+	return split(GiRegex::cached(regex.view()), limit);
+}
+
+std::vector<GiString> GiString::split(const GiRegex& regex, int limit) const
+{
+	GiStringView source = view();
+	return Split::collect(source, limit, [&](size_t offset, size_t& start, size_t& end) {
+		return regex.find(source, offset, start, end);
+	}, this);
+}
+
+std::vector<GiString> GiString::split(const GiSearcher& separator) const
+{
+	if (separator.length() > 0 && parallelAllocation(m_length))
+	{
+		return splitParallel(*this, separator.length(), 0, [&](const GiStringView& window, size_t offset) {
+			return separator.indexOf(window, offset);
+		});
+	}
+
+	// 与Java一致，空分隔符在每个字符之间匹配，拆分为单个字符
+	GiStringView source = view();
+	return Split::collect(source, 0, [&](size_t offset, size_t& start, size_t& end) {
+		start = separator.indexOf(source, offset);
+		end = start + separator.length();
+		return start != SIZE_MAX;
+	}, this);
+}
+
+GiSplitRange GiString::splitViews(const GiString& regex, int limit) const
+{
+	GI_STRING_DATA_TYPE delimiter;
+	if (Split::literalChar(regex.view(), delimiter))
+	{
+		return GiSplitRange(view(), delimiter, limit);
+	}
+
+	// 拆分范围可能比调用者的表达式活得更久，因此持有缓存中编译结果的副本
+	return GiSplitRange(view(), std::make_shared<const GiRegex>(GiRegex::cached(regex.view())), limit);
+}
+
+GiSplitRange GiString::splitViews(const GiRegex& regex, int limit) const
+{
+	return GiSplitRange(view(), regex, limit);
+}
+
+GiSplitRange GiString::splitViews(const GiSearcher& separator, int limit) const
+{
+	return GiSplitRange(view(), separator, limit);
+}
+
 std::vector<GiString> GiString::lines() const
 {
-	// TODO: Not Implements
+	GiStringView source = view();
 	std::vector<GiString> ret;
+	if (parallelAllocation(m_length))
+	{
+		Parallel::lines(source, ret, [&](size_t start, size_t length) {
+			return GiString(source.subString(start, length));
+		}, Parallel::ThreadPool::shared());
+		return ret;
+	}
+
+	Split::lines(source, [&](size_t start, size_t length) {
+		ret.push_back(GiString(source.subString(start, length)));
+	});
+	return ret;
+}
+
+std::vector<GiStringView> GiString::lineViews() const
+{
+	GiStringView source = view();
+	std::vector<GiStringView> ret;
+	if (Parallel::enabled(m_length))
+	{
+		Parallel::lines(source, ret, [&](size_t start, size_t length) {
+			return source.subString(start, length);
+		}, Parallel::ThreadPool::shared());
+		return ret;
+	}
+
+	Split::lines(source, [&](size_t start, size_t length) {
+		ret.push_back(source.subString(start, length));
+	});
 	return ret;
 }
 
 GiString GiString::subString(size_t offset, size_t length) const
 {
-	return { m_data, 0, length };
+	return GiString(view().subString(offset, length));
 }
 
 GI_STRING_DATA_TYPE& GiString::operator[](size_t index)
 {
-	if (index >= length())
+	if (index >= m_length)
 	{
 		index = 0;
 	}
+
+	// 交出可写引用前独占缓冲区，并禁止之后的拷贝共享该缓冲区
+	detach();
+	m_hash.store(0, std::memory_order_relaxed);
+	if (!isLocal())
+	{
+		blockOf(m_data)->shareable = false;
+	}
 	return m_data[index];
 }
 
 GiString& GiString::copy(const GiString& str)
 {
-	size_t realLen = str.length() + 1;
-	m_data = new GI_STRING_DATA_TYPE[realLen];
-	assert(m_data != nullptr);
+	if (this == &str) return *this;
 
-	// 内存拷贝
-	memcpy(m_data, str.m_data, sizeof(GI_STRING_DATA_TYPE) * realLen);
+	// 静态数据总是共享，不需要引用计数
+	bool share = str.isStatic();
+	GiAllocator* allocator = GiAllocator::defaultAllocator();
+	if (!share && !str.isLocal())
+	{
+		GiStringBlock* block = blockOf(str.m_data);
+#if GI_STRING_COPY_ON_WRITE
+		share = block->shareable;
+#endif
+		// 驻留字符串总是共享缓冲区，驻留池持有引用，写入前一定会先复制
+		share = share || block->interned;
+
+		// 作用域内有效的分配器(如GiArenaAllocator)可能先于拷贝被整体释放，不共享，复制到默认分配器。
+		// 其他分配器(如GiPoolAllocator)的缓冲区照常共享，复制时也留在原分配器
+		if (block->allocator->isScoped())
+		{
+			share = false;
+		}
+		else
+		{
+			allocator = block->allocator;
+		}
+	}
 
-	// 字符串结束符补位
-	m_data[realLen - 1] = 0;
+	// 共享对方的缓冲区，先增加计数再释放自身，两者共享同一块缓冲区时也安全
+	if (share)
+	{
+		if (!str.isStatic())
+		{
+			blockOf(str.m_data)->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+		release();
+		m_data = str.m_data;
+		m_length = str.m_length;
+		m_capacity = str.m_capacity;
+		m_hash.store(str.m_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		return *this;
+	}
 
+	// 内容相同，已计算的hash数值一起复制。
+	// 无法确定拷贝是否比当前作用域的分配器存活更久，因此不使用GiAllocator::current()
+	GiAllocatorScope scope(allocator);
+	assign(str.m_data, str.m_length);
+	m_hash.store(str.m_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	return *this;
 }
 
@@ -272,16 +771,7 @@ GiString& GiString::copy(const GI_STRING_DATA_TYPE* str, size_t length)
 		return *this;
 	}
 
-	size_t realLen = MIN(strlen(str), length) + 1;
-	m_data = new GI_STRING_DATA_TYPE[realLen];
-	assert(m_data != nullptr);
-
-	// 内存拷贝
-	memcpy(m_data, str, sizeof(GI_STRING_DATA_TYPE) * (realLen));
-
-	// 字符串结束符补位
-	m_data[realLen - 1] = 0;
-
+	assign(str, MIN(strlen(str), length));
 	return *this;
 }
 
@@ -291,72 +781,438 @@ GiString& GiString::operator=(const GiString& str)
 	return *this;
 }
 
+GiString& GiString::operator=(GiString&& str) noexcept
+{
+	if (this == &str) return *this;
+
+	release();
+	take(str);
+	return *this;
+}
+
 void GiString::empty()
 {
-	m_data = new GI_STRING_DATA_TYPE[1];
-	assert(m_data != nullptr);
+	if (isShared())
+	{
+		release();
+		return;
+	}
 
 	m_data[0] = 0;
+	m_length = 0;
+	m_hash.store(0, std::memory_order_relaxed);
 }
 
-const GI_STRING_DATA_TYPE* GiString::c_str() const
+GiString& GiString::stripInPlace(const GI_STRING_DATA_TYPE* coll)
 {
-	return m_data;
+	GiStringView stripped = view().strip(coll);
+	keep(stripped.data() - m_data, stripped.length());
+	return *this;
 }
 
-GI_STRING_DATA_TYPE GiString::charAt(size_t index) const
+GiString& GiString::stripLeadingInPlace(const GI_STRING_DATA_TYPE* coll)
 {
-	assert(m_data != nullptr);
-	if (index >= length()) return 0;
-	return m_data[index];
+	GiStringView stripped = view().stripLeading(coll);
+	keep(stripped.data() - m_data, stripped.length());
+	return *this;
+}
+
+GiString& GiString::stripTrailingInPlace(const GI_STRING_DATA_TYPE* coll)
+{
+	keep(0, view().stripTrailing(coll).length());
+	return *this;
+}
+
+GiString& GiString::trimInPlace()
+{
+	GiStringView trimmed = view().trim();
+	keep(trimmed.data() - m_data, trimmed.length());
+	return *this;
+}
+
+GiString& GiString::trimStartInPlace()
+{
+	GiStringView trimmed = view().trimStart();
+	keep(trimmed.data() - m_data, trimmed.length());
+	return *this;
+}
+
+GiString& GiString::trimEndInPlace()
+{
+	keep(0, view().trimEnd().length());
+	return *this;
+}
+
+GiString& GiString::replaceInPlace(GI_STRING_DATA_TYPE oldChar, GI_STRING_DATA_TYPE newChar)
+{
+	size_t pos = oldChar == newChar ? SIZE_MAX : view().indexOf(oldChar);
+	if (pos == SIZE_MAX) return *this;
+
+	detach();
+	m_hash.store(0, std::memory_order_relaxed);
+	while (pos != SIZE_MAX)
+	{
+		m_data[pos] = newChar;
+		pos = view().indexOf(oldChar, pos + 1);
+	}
+	return *this;
+}
+
+GiString& GiString::replaceInPlace(const GiString& oldStr, const GiString& newStr)
+{
+	size_t targetLength = oldStr.m_length;
+	size_t replacementLength = newStr.m_length;
+	if (targetLength == 0 || replacementLength > targetLength || &oldStr == this || &newStr == this)
+	{
+		*this = replace(oldStr, newStr);
+		return *this;
+	}
+
+	// 长字符串只预处理一次，所有匹配共用
+	Search::TwoWayPlan plan;
+	const Search::TwoWayPlan* prepared = nullptr;
+	if (targetLength > Search::SHORT_NEEDLE_LENGTH)
+	{
+		Search::prepare(plan, oldStr.m_data, targetLength, false);
+		prepared = &plan;
+	}
+	auto find = [&](size_t offset) {
+		size_t found = Search::find(m_data + offset, m_length - offset, oldStr.m_data, targetLength, prepared);
+		return found == SIZE_MAX ? SIZE_MAX : offset + found;
+	};
+
+	size_t pos = find(0);
+	if (pos == SIZE_MAX) return *this;
+
+	// 共享时先复制，newStr与自身共享缓冲区时也因此不受影响
+	detach();
+	m_hash.store(0, std::memory_order_relaxed);
+
+	// 新字符串不长于旧字符串，写入位置总在读取位置之前，尚未读取的部分不会被覆盖
+	size_t read = 0;
+	size_t write = 0;
+	while (pos != SIZE_MAX)
+	{
+		memmove(m_data + write, m_data + read, sizeof(GI_STRING_DATA_TYPE) * (pos - read));
+		write += pos - read;
+		memcpy(m_data + write, newStr.m_data, sizeof(GI_STRING_DATA_TYPE) * replacementLength);
+		write += replacementLength;
+		read = pos + targetLength;
+		pos = find(read);
+	}
+	memmove(m_data + write, m_data + read, sizeof(GI_STRING_DATA_TYPE) * (m_length - read));
+	write += m_length - read;
+
+	m_data[write] = 0;
+	m_length = write;
+	return *this;
+}
+
+void GiString::assign(const GI_STRING_DATA_TYPE* str, size_t length)
+{
+	m_hash.store(0, std::memory_order_relaxed);
+
+	// 共享的缓冲区不能原地修改。str可能指向该缓冲区，释放自身的引用后，
+	// 其他线程随时可能释放最后一份引用，因此复制完成前额外持有一份引用
+	GI_STRING_DATA_TYPE* pinned = nullptr;
+	if (isShared())
+	{
+		if (!isStatic() && str >= m_data && str <= m_data + m_length)
+		{
+			pinned = m_data;
+			blockOf(pinned)->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+		release();
+	}
+
+	// 容量足够时直接复用，str可能指向自身缓冲区，因此使用memmove
+	if (length <= capacity())
+	{
+		memmove(m_data, str, sizeof(GI_STRING_DATA_TYPE) * length);
+		m_data[length] = 0;
+		m_length = length;
+
+		// 内容整体被替换，之前交出的可写引用视为失效
+		if (!isLocal())
+		{
+			blockOf(m_data)->shareable = true;
+		}
+	}
+	else
+	{
+		// 先拷贝再释放，防止str指向旧缓冲区
+		GI_STRING_DATA_TYPE* data = allocateBlock(length);
+		memcpy(data, str, sizeof(GI_STRING_DATA_TYPE) * length);
+		data[length] = 0;
+
+		release();
+		m_data = data;
+		m_length = length;
+		m_capacity = length;
+	}
+
+	if (pinned)
+	{
+		releaseBlock(pinned);
+	}
+}
+
+void GiString::release()
+{
+	if (!isLocal() && !isStatic())
+	{
+		releaseBlock(m_data);
+	}
+	m_data = m_local;
+	m_local[0] = 0;
+	m_length = 0;
+	m_hash.store(0, std::memory_order_relaxed);
+}
+
+void GiString::detach()
+{
+	if (!isShared()) return;
+
+	// 静态数据的容量记为0，按实际长度复制
+	size_t capacity = isStatic() ? m_length : m_capacity;
+	GI_STRING_DATA_TYPE* data = allocateBlock(capacity);
+	memcpy(data, m_data, sizeof(GI_STRING_DATA_TYPE) * (m_length + 1));
+
+	if (!isStatic())
+	{
+		releaseBlock(m_data);
+	}
+	m_data = data;
+	m_capacity = capacity;
+}
+
+void GiString::keep(size_t offset, size_t length)
+{
+	if (offset == 0 && length == m_length) return;
+
+	// 共享的缓冲区不能原地修改，由assign()复制到新的存储，复制期间原缓冲区保持有效
+	if (isShared())
+	{
+		assign(m_data + offset, length);
+		return;
+	}
+
+	if (offset > 0)
+	{
+		memmove(m_data, m_data + offset, sizeof(GI_STRING_DATA_TYPE) * length);
+	}
+	m_data[length] = 0;
+	m_length = length;
+	m_hash.store(0, std::memory_order_relaxed);
+}
+
+void GiString::reserve(size_t capacity)
+{
+
+	if (capacity <= this->capacity())
+	{
+		detach();
+		return;
+	}
+
+	GI_STRING_DATA_TYPE* data = allocateBlock(capacity);
+	memcpy(data, m_data, sizeof(GI_STRING_DATA_TYPE) * (m_length + 1));
+
+	if (!isLocal() && !isStatic())
+	{
+		releaseBlock(m_data);
+	}
+	m_data = data;
+	m_capacity = capacity;
+}
+
+bool GiString::isShared() const
+{
+	if (isLocal()) return false;
+
+	// 静态数据不可写，与共享的缓冲区一样需要先复制
+	return isStatic() || blockOf(m_data)->refs.load(std::memory_order_acquire) > 1;
+}
+
+void GiString::take(GiString& str) noexcept
+{
+	if (str.isLocal())
+	{
+		memcpy(m_local, str.m_local, sizeof(GI_STRING_DATA_TYPE) * (str.m_length + 1));
+		m_data = m_local;
+	}
+	else
+	{
+		m_data = str.m_data;
+		m_capacity = str.m_capacity;
+	}
+	m_length = str.m_length;
+	m_hash.store(str.m_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	str.m_data = str.m_local;
+	str.m_local[0] = 0;
+	str.m_length = 0;
+	str.m_hash.store(0, std::memory_order_relaxed);
 }
 
 size_t GiString::indexOf(GI_STRING_DATA_TYPE ch, size_t offset) const
 {
-	// TODO: Not Implements
-	return 0;
+	return view().indexOf(ch, offset);
 }
 
 size_t GiString::indexOf(const GiString& str, size_t offset) const
 {
-	// TODO: Not Implements
-	return 0;
+	return view().indexOf(str.view(), offset);
+}
+
+size_t GiString::indexOf(const GiSearcher& searcher, size_t offset) const
+{
+	return searcher.indexOf(view(), offset);
 }
 
 size_t GiString::lastIndexOf(GI_STRING_DATA_TYPE ch, size_t offset) const
 {
-	// TODO: Not Implements
-	return 0;
+	return view().lastIndexOf(ch, offset);
 }
 
 size_t GiString::lastIndexOf(const GiString& str, size_t offset) const
 {
-	// TODO: Not Implements
-	return 0;
+	return view().lastIndexOf(str.view(), offset);
 }
 
-size_t GiString::length() const
+size_t GiString::lastIndexOf(const GiSearcher& searcher, size_t offset) const
 {
-	if (!m_data) return 0;
-	return strlen(m_data);
+	return searcher.lastIndexOf(view(), offset);
 }
 
-size_t GiString::hashCode() const
+size_t GiString::computeHashCode() const
 {
-	// TODO: Not Implements
-	return 0;
+	size_t hash = Hash::hash(m_data, m_length);
+	m_hash.store(hash, std::memory_order_relaxed);
+	return hash;
 }
 
 bool GiString::startsWith(const GiString& prefix, size_t offset) const
 {
-	// TODO: Not Implements
-	return false;
+	return view().startsWith(prefix.view(), offset);
 }
 
 bool GiString::endsWith(const GiString& suffix) const
 {
-	// TODO: Not Implements
-	return false;
+	return view().endsWith(suffix.view());
+}
+
+GiStringMemoryStats GiString::memoryStats()
+{
+	GiStringMemoryStats stats = {};
+#if GI_STRING_MEMORY_STATS
+	size_t totals[STATS_COUNT] = {};
+	StatsRegistry& registry = statsRegistry();
+	{
+		std::lock_guard<std::mutex> guard(registry.lock);
+		for (size_t counter = 0; counter < STATS_COUNT; ++counter)
+		{
+			totals[counter] = registry.shared.counters[counter].load(std::memory_order_relaxed);
+		}
+		for (StatsShard* shard = registry.shards; shard; shard = shard->next)
+		{
+			for (size_t counter = 0; counter < STATS_COUNT; ++counter)
+			{
+				totals[counter] += shard->counters[counter].load(std::memory_order_relaxed);
+			}
+		}
+	}
+	stats.liveBytes = totals[s_liveBytes];
+	stats.liveObjects = totals[s_liveObjects];
+	stats.totalAllocations = totals[s_totalAllocations];
+	stats.totalFrees = totals[s_totalFrees];
+#endif
+	return stats;
+}
+
+void GiString::setParallelThreshold(size_t bytes)
+{
+	Parallel::setThreshold(bytes);
+}
+
+size_t GiString::parallelThreshold()
+{
+	return Parallel::threshold();
+}
+
+GiString GiString::intern() const
+{
+	if (isInterned()) return *this;
+
+	size_t hash = hashCode();
+	InternShard& shard = internShard(hash);
+	std::lock_guard<std::mutex> guard(shard.lock);
+
+	auto range = shard.entries.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second.m_length == m_length && Simd::equal(it->second.m_data, m_data, m_length)) return it->second;
+	}
+
+	// 规范实例总是放在堆上，短字符串也一样，拷贝时才能共享同一块缓冲区。
+	// 驻留字符串的生命周期不受线程当前分配器的作用域限制，因此使用默认分配器
+	// 容量为0表示静态数据，空字符串也至少申请1个字符
+	GiString canonical;
+	canonical.m_capacity = m_length == 0 ? 1 : m_length;
+	canonical.m_data = allocateBlock(canonical.m_capacity, GiAllocator::defaultAllocator());
+	memcpy(canonical.m_data, m_data, sizeof(GI_STRING_DATA_TYPE) * (m_length + 1));
+	canonical.m_length = m_length;
+	canonical.m_hash.store(hash, std::memory_order_relaxed);
+
+	GiStringBlock* block = blockOf(canonical.m_data);
+	block->interned = true;
+	shard.bytes += block->bytes;
+	shard.entries.insert(std::make_pair(hash, canonical));
+	return canonical;
+}
+
+bool GiString::isInterned() const
+{
+	return !isLocal() && !isStatic() && blockOf(m_data)->interned;
+}
+
+GiStringInternStats GiString::internStats()
+{
+	GiStringInternStats stats = {};
+	for (size_t i = 0; i < GI_STRING_INTERN_SHARDS; ++i)
+	{
+		InternShard& shard = internShard(i);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		stats.entries += shard.entries.size();
+		stats.bytes += shard.bytes;
+	}
+	return stats;
+}
+
+size_t GiString::purgeInterned()
+{
+	size_t count = 0;
+	for (size_t i = 0; i < GI_STRING_INTERN_SHARDS; ++i)
+	{
+		InternShard& shard = internShard(i);
+		std::lock_guard<std::mutex> guard(shard.lock);
+		for (auto it = shard.entries.begin(); it != shard.entries.end();)
+		{
+			// 只有池持有引用时，其他线程无法再拷贝它，移除是安全的
+			GiStringBlock* block = blockOf(it->second.m_data);
+			if (block->refs.load(std::memory_order_acquire) == 1)
+			{
+				shard.bytes -= block->bytes;
+				it = shard.entries.erase(it);
+				++count;
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+	return count;
 }
 
 GiString GiString::format(const GiString& fmt, ...)
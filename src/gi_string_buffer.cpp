@@ -0,0 +1,184 @@
+﻿#include "gikoo/gi_string_buffer.h"
+#include "gikoo/gi_allocator.h"
+#include <atomic>
+#include <cstring>
+
+using namespace GiKoo;
+
+namespace
+{
+	std::atomic<size_t> s_nextSlot(0);
+}
+
+/**
+ * @brief 锁住所有分片和主缓冲区，并把暂存内容合并到主缓冲区
+ *
+ * @details 缓冲区被多个线程长期共享，分配器(如GiArenaAllocator)只在调用线程的作用域内有效且不一定线程安全，
+ *  因此持有期间固定使用默认分配器。
+ */
+class GiStringBuffer::FlushGuard
+{
+public:
+	explicit FlushGuard(const GiStringBuffer& buffer)
+		: m_buffer(buffer), m_scope(GiAllocator::defaultAllocator())
+	{
+		for (auto& shard : m_buffer.m_shards)
+		{
+			shard.lock.lock();
+		}
+		m_buffer.m_lock.lock();
+
+		for (auto& shard : m_buffer.m_shards)
+		{
+			m_buffer.m_merged.append(shard.staging.view());
+			shard.staging.clear();
+		}
+	}
+
+	~FlushGuard()
+	{
+		m_buffer.m_lock.unlock();
+		for (auto& shard : m_buffer.m_shards)
+		{
+			shard.lock.unlock();
+		}
+	}
+
+private:
+	const GiStringBuffer& m_buffer;
+	GiAllocatorScope m_scope;		// 合并和修改主缓冲区时使用默认分配器
+};
+
+GiStringBuffer::GiStringBuffer()
+{
+}
+
+GiStringBuffer::GiStringBuffer(size_t capacity)
+{
+	GiAllocatorScope scope(GiAllocator::defaultAllocator());
+	m_merged.reserve(capacity);
+}
+
+GiStringBuffer& GiStringBuffer::append(const GiString& str)
+{
+	return appendLocal(str.c_str(), str.length());
+}
+
+GiStringBuffer& GiStringBuffer::append(const GiStringView& str)
+{
+	return appendLocal(str.data(), str.length());
+}
+
+GiStringBuffer& GiStringBuffer::append(const GI_STRING_DATA_TYPE* str)
+{
+	if (!str) return *this;
+	return appendLocal(str, strlen(str));
+}
+
+GiStringBuffer& GiStringBuffer::append(const GI_STRING_DATA_TYPE* str, size_t length)
+{
+	return appendLocal(str, length);
+}
+
+GiStringBuffer& GiStringBuffer::append(GI_STRING_DATA_TYPE ch)
+{
+	return appendLocal(&ch, 1);
+}
+
+// 整数先在栈上格式化（短字符串不申请内存），再整体追加，保证原子性
+#define GI_STRING_BUFFER_APPEND_INTEGER(type) \
+	GiStringBuffer& GiStringBuffer::append(type value) \
+	{ \
+		GiStringBuilder digits; \
+		digits.append(value); \
+		return appendLocal(digits.view().data(), digits.length()); \
+	}
+
+GI_STRING_BUFFER_APPEND_INTEGER(int)
+GI_STRING_BUFFER_APPEND_INTEGER(unsigned int)
+GI_STRING_BUFFER_APPEND_INTEGER(long)
+GI_STRING_BUFFER_APPEND_INTEGER(unsigned long)
+GI_STRING_BUFFER_APPEND_INTEGER(long long)
+GI_STRING_BUFFER_APPEND_INTEGER(unsigned long long)
+
+#undef GI_STRING_BUFFER_APPEND_INTEGER
+
+GiStringBuffer& GiStringBuffer::insert(size_t offset, const GiStringView& str)
+{
+	FlushGuard guard(*this);
+	m_merged.insert(offset, str);
+	return *this;
+}
+
+GiStringBuffer& GiStringBuffer::insert(size_t offset, GI_STRING_DATA_TYPE ch)
+{
+	FlushGuard guard(*this);
+	m_merged.insert(offset, ch);
+	return *this;
+}
+
+GiStringBuffer& GiStringBuffer::deleteCharAt(size_t index)
+{
+	FlushGuard guard(*this);
+	m_merged.deleteCharAt(index);
+	return *this;
+}
+
+GiStringBuffer& GiStringBuffer::reverse()
+{
+	FlushGuard guard(*this);
+	m_merged.reverse();
+	return *this;
+}
+
+void GiStringBuffer::clear()
+{
+	FlushGuard guard(*this);
+	m_merged.clear();
+}
+
+size_t GiStringBuffer::length() const
+{
+	FlushGuard guard(*this);
+	return m_merged.length();
+}
+
+GiString GiStringBuffer::toString() const
+{
+	FlushGuard guard(*this);
+	return m_merged.toString();
+}
+
+GiStringBuffer::Shard& GiStringBuffer::localShard() const
+{
+	// 每个线程第一次使用时分配一个序号，线程之间轮流使用不同的分片
+	thread_local size_t slot = s_nextSlot.fetch_add(1, std::memory_order_relaxed);
+	return m_shards[slot % SHARD_COUNT];
+}
+
+GiStringBuffer& GiStringBuffer::appendLocal(const GI_STRING_DATA_TYPE* str, size_t length)
+{
+	if (length == 0) return *this;
+
+	// 分片和主缓冲区都比调用者的分配器作用域存活更久，见FlushGuard
+	GiAllocatorScope scope(GiAllocator::defaultAllocator());
+	Shard& shard = localShard();
+	std::lock_guard<std::mutex> guard(shard.lock);
+
+	// 大块内容直接合并，省去一次拷贝
+	if (shard.staging.length() == 0 && length >= FLUSH_THRESHOLD)
+	{
+		std::lock_guard<std::mutex> mergeGuard(m_lock);
+		m_merged.append(str, length);
+		return *this;
+	}
+
+	shard.staging.append(str, length);
+	if (shard.staging.length() >= FLUSH_THRESHOLD)
+	{
+		std::lock_guard<std::mutex> mergeGuard(m_lock);
+		m_merged.append(shard.staging.view());
+		shard.staging.clear();
+	}
+	return *this;
+}
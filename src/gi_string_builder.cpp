@@ -0,0 +1,228 @@
+﻿#include "gikoo/gi_string_builder.h"
+#include <cstring>
+#include <utility>
+
+#define MAX(x,y) (x > y ? x : y)
+
+using namespace GiKoo;
+
+GiStringBuilder::GiStringBuilder()
+{
+}
+
+GiStringBuilder::GiStringBuilder(size_t capacity)
+{
+	reserve(capacity);
+}
+
+GiStringBuilder::GiStringBuilder(const GiStringView& str)
+{
+	append(str);
+}
+
+GiStringBuilder& GiStringBuilder::append(const GiString& str)
+{
+	return append(str.c_str(), str.length());
+}
+
+GiStringBuilder& GiStringBuilder::append(const GiStringView& str)
+{
+	return append(str.data(), str.length());
+}
+
+GiStringBuilder& GiStringBuilder::append(const GI_STRING_DATA_TYPE* str)
+{
+	if (!str) return *this;
+	return append(str, strlen(str));
+}
+
+GiStringBuilder& GiStringBuilder::append(const GI_STRING_DATA_TYPE* str, size_t length)
+{
+	if (length == 0) return *this;
+
+	// str可能指向自身缓冲区，扩容前记录偏移
+	const GI_STRING_DATA_TYPE* begin = m_str.m_data;
+	bool inside = str >= begin && str < begin + m_str.m_length;
+	size_t offset = inside ? (size_t)(str - begin) : 0;
+
+	GI_STRING_DATA_TYPE* dest = grow(length);
+	if (inside) str = m_str.m_data + offset;
+
+	memcpy(dest, str, sizeof(GI_STRING_DATA_TYPE) * length);
+	m_str.m_length += length;
+	m_str.m_data[m_str.m_length] = 0;
+	return *this;
+}
+
+GiStringBuilder& GiStringBuilder::append(GI_STRING_DATA_TYPE ch)
+{
+	GI_STRING_DATA_TYPE* dest = grow(1);
+	dest[0] = ch;
+	dest[1] = 0;
+	++m_str.m_length;
+	return *this;
+}
+
+GiStringBuilder& GiStringBuilder::append(int value)
+{
+	return append((long long)value);
+}
+
+GiStringBuilder& GiStringBuilder::append(unsigned int value)
+{
+	return appendInteger(value, false);
+}
+
+GiStringBuilder& GiStringBuilder::append(long value)
+{
+	return append((long long)value);
+}
+
+GiStringBuilder& GiStringBuilder::append(unsigned long value)
+{
+	return appendInteger(value, false);
+}
+
+GiStringBuilder& GiStringBuilder::append(long long value)
+{
+	// 取绝对值时避免LLONG_MIN溢出
+	if (value < 0) return appendInteger(0ULL - (unsigned long long)value, true);
+	return appendInteger((unsigned long long)value, false);
+}
+
+GiStringBuilder& GiStringBuilder::append(unsigned long long value)
+{
+	return appendInteger(value, false);
+}
+
+GiStringBuilder& GiStringBuilder::insert(size_t offset, const GiStringView& str)
+{
+	if (offset >= m_str.m_length) return append(str);
+	if (str.isEmpty()) return *this;
+
+	// 插入内容可能来自自身，先拷贝出来
+	GiString copy;
+	const GI_STRING_DATA_TYPE* src = str.data();
+	if (src >= m_str.m_data && src < m_str.m_data + m_str.m_length)
+	{
+		copy = GiString(str);
+		src = copy.c_str();
+	}
+
+	size_t length = str.length();
+	grow(length);
+	GI_STRING_DATA_TYPE* data = m_str.m_data;
+	memmove(data + offset + length, data + offset, sizeof(GI_STRING_DATA_TYPE) * (m_str.m_length - offset + 1));
+	memcpy(data + offset, src, sizeof(GI_STRING_DATA_TYPE) * length);
+	m_str.m_length += length;
+	return *this;
+}
+
+GiStringBuilder& GiStringBuilder::insert(size_t offset, GI_STRING_DATA_TYPE ch)
+{
+	return insert(offset, GiStringView(&ch, 1));
+}
+
+GiStringBuilder& GiStringBuilder::deleteCharAt(size_t index)
+{
+	if (index >= m_str.m_length) return *this;
+
+	m_str.detach();
+	GI_STRING_DATA_TYPE* data = m_str.m_data;
+	memmove(data + index, data + index + 1, sizeof(GI_STRING_DATA_TYPE) * (m_str.m_length - index));
+	--m_str.m_length;
+	return *this;
+}
+
+GiStringBuilder& GiStringBuilder::reverse()
+{
+	m_str.detach();
+
+	GI_STRING_DATA_TYPE* data = m_str.m_data;
+	size_t left = 0;
+	size_t right = m_str.m_length;
+	while (left + 1 < right)
+	{
+		--right;
+		GI_STRING_DATA_TYPE ch = data[left];
+		data[left] = data[right];
+		data[right] = ch;
+		++left;
+	}
+	return *this;
+}
+
+void GiStringBuilder::reserve(size_t capacity)
+{
+	m_str.reserve(capacity);
+}
+
+void GiStringBuilder::clear()
+{
+	m_str.empty();
+}
+
+size_t GiStringBuilder::length() const
+{
+	return m_str.m_length;
+}
+
+size_t GiStringBuilder::capacity() const
+{
+	return m_str.capacity();
+}
+
+GI_STRING_DATA_TYPE GiStringBuilder::charAt(size_t index) const
+{
+	return m_str.charAt(index);
+}
+
+GiStringView GiStringBuilder::view() const
+{
+	return m_str.view();
+}
+
+GiString GiStringBuilder::toString() const &
+{
+	return m_str;
+}
+
+GiString GiStringBuilder::toString() &&
+{
+	return std::move(m_str);
+}
+
+GI_STRING_DATA_TYPE* GiStringBuilder::grow(size_t length)
+{
+	size_t required = m_str.m_length + length;
+	size_t capacity = m_str.capacity();
+	if (required > capacity)
+	{
+		m_str.reserve(MAX(required, capacity * 2));
+	}
+	else
+	{
+		// 缓冲区可能通过toString()与其他对象共享
+		m_str.detach();
+	}
+	return m_str.m_data + m_str.m_length;
+}
+
+GiStringBuilder& GiStringBuilder::appendInteger(unsigned long long value, bool negative)
+{
+	// 从低位到高位写入临时缓冲区
+	GI_STRING_DATA_TYPE digits[24];
+	size_t count = 0;
+	do
+	{
+		digits[sizeof(digits) - 1 - count++] = (GI_STRING_DATA_TYPE)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	if (negative)
+	{
+		digits[sizeof(digits) - 1 - count++] = '-';
+	}
+
+	return append(digits + sizeof(digits) - count, count);
+}
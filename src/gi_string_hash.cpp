@@ -0,0 +1,148 @@
+﻿#include "gi_string_hash.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+using namespace GiKoo;
+
+namespace
+{
+	const uint64_t SECRET[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+	/**
+	 * @brief 64位乘法，a、b分别得到128位乘积的低位和高位
+	 */
+	inline void multiply(uint64_t& a, uint64_t& b)
+	{
+#if defined(__SIZEOF_INT128__)
+		__uint128_t product = (__uint128_t)a * b;
+		a = (uint64_t)product;
+		b = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		a = _umul128(a, b, &b);
+#else
+		uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+		uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+		uint64_t t = rl + (rm0 << 32);
+		uint64_t carry = t < rl;
+		uint64_t lo = t + (rm1 << 32);
+		carry += lo < t;
+		a = lo;
+		b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+	}
+
+	/**
+	 * @brief 相乘后将高低位异或
+	 */
+	inline uint64_t mix(uint64_t a, uint64_t b)
+	{
+		multiply(a, b);
+		return a ^ b;
+	}
+
+	inline uint64_t read8(const GI_STRING_DATA_TYPE* p)
+	{
+		uint64_t v;
+		memcpy(&v, p, 8);
+		return v;
+	}
+
+	inline uint64_t read4(const GI_STRING_DATA_TYPE* p)
+	{
+		uint32_t v;
+		memcpy(&v, p, 4);
+		return v;
+	}
+
+	/**
+	 * @brief 读取1~3个字节
+	 */
+	inline uint64_t read3(const GI_STRING_DATA_TYPE* p, size_t k)
+	{
+		return ((uint64_t)(unsigned char)p[0] << 16) | ((uint64_t)(unsigned char)p[k >> 1] << 8) | (unsigned char)p[k - 1];
+	}
+
+	uint64_t makeSeed()
+	{
+		uint64_t seed = (uint64_t)GI_STRING_HASH_SEED;
+#if GI_STRING_HASH_RANDOM_SEED
+		std::random_device device;
+		uint64_t random = ((uint64_t)device() << 32) ^ device();
+		random ^= (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		seed ^= mix(random ^ SECRET[0], SECRET[2]);
+#endif
+		return seed;
+	}
+}
+
+uint64_t Hash::seed()
+{
+	static const uint64_t value = makeSeed();
+	return value;
+}
+
+uint64_t Hash::hash(const GI_STRING_DATA_TYPE* data, size_t length, uint64_t seed)
+{
+	const GI_STRING_DATA_TYPE* p = data;
+	seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+
+	uint64_t a;
+	uint64_t b;
+	if (length <= 16)
+	{
+		if (length >= 4)
+		{
+			// 首尾各取两个可能重叠的4字节
+			size_t shift = (length >> 3) << 2;
+			a = (read4(p) << 32) | read4(p + shift);
+			b = (read4(p + length - 4) << 32) | read4(p + length - 4 - shift);
+		}
+		else if (length > 0)
+		{
+			a = read3(p, length);
+			b = 0;
+		}
+		else
+		{
+			a = 0;
+			b = 0;
+		}
+	}
+	else
+	{
+		size_t i = length;
+		if (i > 48)
+		{
+			// 三条独立的乘法链，便于流水线并行
+			uint64_t seed1 = seed;
+			uint64_t seed2 = seed;
+			do
+			{
+				seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+				seed1 = mix(read8(p + 16) ^ SECRET[2], read8(p + 24) ^ seed1);
+				seed2 = mix(read8(p + 32) ^ SECRET[3], read8(p + 40) ^ seed2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (i > 16)
+		{
+			seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = read8(p + i - 16);
+		b = read8(p + i - 8);
+	}
+
+	a ^= SECRET[1];
+	b ^= seed;
+	multiply(a, b);
+	return mix(a ^ SECRET[0] ^ length, b ^ SECRET[1]);
+}
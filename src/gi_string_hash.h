@@ -0,0 +1,47 @@
+﻿/**
+ * @brief GiString内部使用的hash算法
+ *
+ * @file gi_string_hash.h
+ *
+ * @details
+ *  1. 基于wyhash(公有领域)，每次处理48字节，短字符串只需一到两次64位乘法。
+ *  2. 种子由GI_STRING_HASH_SEED指定，开启GI_STRING_HASH_RANDOM_SEED时再混入进程启动后生成的随机数，
+ *     使外部无法构造大量hash冲突的输入(HashDoS)。同一进程内结果始终一致。
+ *  3. 仅供库内部使用，不属于公开API。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include <cstdint>
+
+namespace GiKoo
+{
+	namespace Hash
+	{
+		/**
+		 * @brief 本进程使用的种子
+		 */
+		uint64_t seed();
+
+		/**
+		 * @brief 计算hash数值
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param seed 种子
+		 *
+		 * @return hash数值
+		 */
+		uint64_t hash(const GI_STRING_DATA_TYPE* data, size_t length, uint64_t seed);
+
+		/**
+		 * @brief 使用本进程的种子计算hash数值
+		 */
+		inline size_t hash(const GI_STRING_DATA_TYPE* data, size_t length)
+		{
+			return (size_t)hash(data, length, seed());
+		}
+	}
+}
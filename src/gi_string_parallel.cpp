@@ -0,0 +1,144 @@
+﻿#include "gi_string_parallel.h"
+#include <algorithm>
+
+using namespace GiKoo;
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+namespace
+{
+	/**
+	 * @brief 每块的最小字节数，块太小时调度开销大于并行的收益
+	 */
+	const size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+	/**
+	 * @brief 每个线程分到的块数，多分几块以平衡各块处理速度的差异
+	 */
+	const size_t CHUNKS_PER_THREAD = 4;
+
+	std::atomic<size_t> s_threshold(GI_STRING_PARALLEL_THRESHOLD);
+}
+
+Parallel::ThreadPool::ThreadPool(size_t concurrency)
+	: m_stop(false)
+{
+	if (concurrency == 0) concurrency = std::thread::hardware_concurrency();
+	for (size_t i = 1; i < concurrency; ++i)
+	{
+		m_threads.emplace_back([this]() { loop(); });
+	}
+}
+
+Parallel::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+Parallel::ThreadPool& Parallel::ThreadPool::shared()
+{
+	static ThreadPool pool(GI_STRING_PARALLEL_THREADS);
+	return pool;
+}
+
+size_t Parallel::ThreadPool::concurrency() const
+{
+	return m_threads.size() + 1;
+}
+
+void Parallel::ThreadPool::run(size_t count, const std::function<void(size_t)>& task)
+{
+	if (m_threads.empty() || count <= 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			task(i);
+		}
+		return;
+	}
+
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->task = &task;
+	job->count = count;
+	job->next = 0;
+	job->done = 0;
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_jobs.push_back(job);
+	}
+	m_wake.notify_all();
+
+	// 调用者线程同样领取任务，之后等待其他线程完成已领取的部分
+	work(*job);
+
+	std::unique_lock<std::mutex> lock(m_lock);
+	m_finished.wait(lock, [&]() { return job->done == job->count; });
+	auto it = std::find(m_jobs.begin(), m_jobs.end(), job);
+	if (it != m_jobs.end()) m_jobs.erase(it);
+}
+
+void Parallel::ThreadPool::work(Job& job)
+{
+	size_t index;
+	while ((index = job.next++) < job.count)
+	{
+		(*job.task)(index);
+		if (++job.done == job.count)
+		{
+			std::lock_guard<std::mutex> guard(m_lock);
+			m_finished.notify_all();
+		}
+	}
+}
+
+void Parallel::ThreadPool::loop()
+{
+	for (;;)
+	{
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_wake.wait(lock, [&]() { return m_stop || !m_jobs.empty(); });
+			if (m_stop) return;
+
+			// 任务已全部被领取的作业移出队列，等待它的调用者不再需要工作线程
+			job = m_jobs.front();
+			if (job->next >= job->count)
+			{
+				m_jobs.pop_front();
+				continue;
+			}
+		}
+		work(*job);
+	}
+}
+
+size_t Parallel::threshold()
+{
+	return s_threshold.load(std::memory_order_relaxed);
+}
+
+void Parallel::setThreshold(size_t bytes)
+{
+	s_threshold.store(bytes, std::memory_order_relaxed);
+}
+
+bool Parallel::enabled(size_t length)
+{
+	return length >= threshold() && ThreadPool::shared().concurrency() > 1;
+}
+
+size_t Parallel::chunkCount(size_t length, const ThreadPool& pool)
+{
+	size_t chunks = MIN(pool.concurrency() * CHUNKS_PER_THREAD, length / MIN_CHUNK_SIZE);
+	return MAX(chunks, (size_t)1);
+}
@@ -0,0 +1,243 @@
+﻿/**
+ * @brief GiString内部使用的并行拆分
+ *
+ * @file gi_string_parallel.h
+ *
+ * @details
+ *  1. 字符串长度达到阈值(GiString::setParallelThreshold())时，lines()和split()把缓冲区分成若干块，
+ *     由线程池并行扫描，结果与串行版本完全相同。
+ *  2. 第一遍各块独立查找分隔符，之后串行修正跨越块边界的分隔符，第二遍各块并行写入各自的结果区间。
+ *  3. 仅供库内部及测试使用，不属于公开API。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gi_string_split.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace GiKoo
+{
+	namespace Parallel
+	{
+		/**
+		 * @brief 线程池
+		 *
+		 * @details 调用run()的线程也参与执行，run()返回时所有任务均已完成。多个线程可以同时调用run()。
+		 */
+		class ThreadPool
+		{
+		public:
+			/**
+			 * @param concurrency 并发数，包括调用者线程。为0时使用CPU核数
+			 */
+			explicit ThreadPool(size_t concurrency);
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			/**
+			 * @brief 全局线程池，并发数由GI_STRING_PARALLEL_THREADS指定，首次使用时创建
+			 */
+			static ThreadPool& shared();
+
+			/**
+			 * @brief 并发数，包括调用者线程
+			 */
+			size_t concurrency() const;
+
+			/**
+			 * @brief 执行task(0) ... task(count - 1)，全部完成后返回
+			 */
+			void run(size_t count, const std::function<void(size_t)>& task);
+
+		private:
+			struct Job
+			{
+				const std::function<void(size_t)>* task;
+				size_t count;
+				std::atomic<size_t> next;
+				std::atomic<size_t> done;
+			};
+
+			/**
+			 * @brief 执行job中尚未领取的任务
+			 */
+			void work(Job& job);
+
+			/**
+			 * @brief 工作线程入口
+			 */
+			void loop();
+
+			std::vector<std::thread> m_threads;
+			std::deque<std::shared_ptr<Job>> m_jobs;
+			std::mutex m_lock;
+			std::condition_variable m_wake;
+			std::condition_variable m_finished;
+			bool m_stop;
+		};
+
+		/**
+		 * @brief 并行的最小长度
+		 */
+		size_t threshold();
+
+		/**
+		 * @brief 设置并行的最小长度，SIZE_MAX表示关闭
+		 */
+		void setThreshold(size_t bytes);
+
+		/**
+		 * @brief 指定长度是否使用并行版本
+		 */
+		bool enabled(size_t length);
+
+		/**
+		 * @brief 指定长度分成的块数
+		 */
+		size_t chunkCount(size_t length, const ThreadPool& pool);
+
+		/**
+		 * @brief 按Java的String.lines()规则并行拆分
+		 *
+		 * @param str 指定字符串
+		 * @param ret 结果集合，原有内容被替换
+		 * @param make 生成元素的函数Out(size_t start, size_t length)
+		 * @param pool 线程池
+		 */
+		template <typename Out, typename Make>
+		void lines(const GiStringView& str, std::vector<Out>& ret, Make make, ThreadPool& pool)
+		{
+			size_t length = str.length();
+			size_t chunks = chunkCount(length, pool);
+			std::vector<size_t> counts(chunks, 0);
+			std::vector<size_t> lastNext(chunks, 0);
+
+			// 第一遍: 各块的行数以及最后一个结束符之后的位置
+			pool.run(chunks, [&](size_t i) {
+				Split::lineBreaks(str, length * i / chunks, length * (i + 1) / chunks, [&](size_t, size_t next) {
+					++counts[i];
+					lastNext[i] = next;
+				});
+			});
+
+			// 每块第一行的序号和起点，由之前的块决定
+			std::vector<size_t> first(chunks);
+			std::vector<size_t> lineStart(chunks);
+			size_t total = 0;
+			size_t start = 0;
+			for (size_t i = 0; i < chunks; ++i)
+			{
+				first[i] = total;
+				lineStart[i] = start;
+				total += counts[i];
+				if (counts[i]) start = lastNext[i];
+			}
+
+			ret.clear();
+			ret.resize(total + (start < length ? 1 : 0));
+
+			// 第二遍: 各块写入自己的区间
+			pool.run(chunks, [&](size_t i) {
+				size_t slot = first[i];
+				size_t from = lineStart[i];
+				Split::lineBreaks(str, length * i / chunks, length * (i + 1) / chunks, [&](size_t at, size_t next) {
+					ret[slot++] = make(from, at - from);
+					from = next;
+				});
+			});
+			if (start < length) ret[total] = make(start, length - start);
+		}
+
+		/**
+		 * @brief 按固定长度的普通字符串并行拆分
+		 *
+		 * @details 结果与Split::collect()相同，limit不大于0。分隔符可以与自身重叠(如"aa")，
+		 *  此时跨越块边界的匹配会使下一块的结果失效，由修正步骤从上一个匹配的末尾重新扫描该块。
+		 *
+		 * @param str 指定字符串
+		 * @param separatorLength 分隔符长度，至少为1
+		 * @param limit 等于0时去掉末尾的空字符串；小于0时保留
+		 * @param find 查找函数size_t(const GiStringView& window, size_t offset)，返回window中从offset开始的第一个匹配，
+		 *  没有时返回SIZE_MAX
+		 * @param ret 结果集合，原有内容被替换
+		 * @param make 生成元素的函数Out(size_t start, size_t length)
+		 * @param pool 线程池
+		 *
+		 * @retval true 拆分完成
+		 * @retval false 没有匹配，ret为空，由调用者返回原字符串
+		 */
+		template <typename Out, typename Find, typename Make>
+		bool split(const GiStringView& str, size_t separatorLength, int limit, Find find, std::vector<Out>& ret, Make make, ThreadPool& pool)
+		{
+			size_t length = str.length();
+			size_t chunks = chunkCount(length, pool);
+			std::vector<std::vector<size_t>> starts(chunks);
+
+			// 只查找起点在[from, to)内的匹配，窗口只多读分隔符长度减1个字节
+			auto scan = [&](size_t i, size_t offset) {
+				size_t to = length * (i + 1) / chunks;
+				GiStringView window = str.subString(0, to + separatorLength - 1);
+				std::vector<size_t>& found = starts[i];
+				found.clear();
+				size_t pos;
+				while (offset < to && (pos = find(window, offset)) != SIZE_MAX && pos < to)
+				{
+					found.push_back(pos);
+					offset = pos + separatorLength;
+				}
+			};
+
+			pool.run(chunks, [&](size_t i) {
+				scan(i, length * i / chunks);
+			});
+
+			// 上一块的最后一个匹配越过边界时，本块从该匹配的末尾重新扫描
+			std::vector<size_t> prevEnd(chunks);
+			std::vector<size_t> first(chunks);
+			size_t lastEnd = 0;
+			size_t total = 0;
+			for (size_t i = 0; i < chunks; ++i)
+			{
+				if (!starts[i].empty() && starts[i][0] < lastEnd) scan(i, lastEnd);
+				prevEnd[i] = lastEnd;
+				first[i] = total;
+				total += starts[i].size();
+				if (!starts[i].empty()) lastEnd = starts[i].back() + separatorLength;
+			}
+
+			ret.clear();
+			if (total == 0) return false;
+			ret.resize(total + 1);
+
+			pool.run(chunks, [&](size_t i) {
+				size_t slot = first[i];
+				size_t from = prevEnd[i];
+				for (size_t pos : starts[i])
+				{
+					ret[slot++] = make(from, pos - from);
+					from = pos + separatorLength;
+				}
+			});
+			ret[total] = make(lastEnd, length - lastEnd);
+
+			if (limit == 0)
+			{
+				while (!ret.empty() && ret.back().isEmpty())
+				{
+					ret.pop_back();
+				}
+			}
+			return true;
+		}
+	}
+}
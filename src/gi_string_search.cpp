@@ -0,0 +1,276 @@
+﻿#include "gi_string_search.h"
+#include "gi_string_simd.h"
+
+#define MAX(x,y) (x > y ? x : y)
+
+using namespace GiKoo;
+
+namespace
+{
+	/**
+	 * @brief 正序访问字节
+	 */
+	struct Forward
+	{
+		const unsigned char* data;
+
+		unsigned char operator[](size_t index) const
+		{
+			return data[index];
+		}
+	};
+
+	/**
+	 * @brief 逆序访问字节，下标0对应最后一个字节
+	 */
+	struct Backward
+	{
+		const unsigned char* end;
+
+		unsigned char operator[](size_t index) const
+		{
+			return *(end - 1 - index);
+		}
+	};
+
+	/**
+	 * @brief 临界分解
+	 *
+	 * @details 分别按正常字典序和逆字典序求最大后缀，取较靠后的一个作为临界位置(Crochemore-Perrin)。
+	 *
+	 * @param needle 指定字符串
+	 * @param length 字节数
+	 * @param period 输出右半部分的周期
+	 *
+	 * @return 临界位置
+	 */
+	template <typename Text>
+	size_t criticalFactorization(const Text& needle, size_t length, size_t& period)
+	{
+		if (length < 3)
+		{
+			period = 1;
+			return length - 1;
+		}
+
+		// maxSuffix从SIZE_MAX开始，maxSuffix + k按无符号数回绕到k - 1
+		size_t maxSuffix = SIZE_MAX;
+		size_t j = 0;
+		size_t k = 1;
+		size_t p = 1;
+		while (j + k < length)
+		{
+			unsigned char a = needle[j + k];
+			unsigned char b = needle[maxSuffix + k];
+			if (a < b)
+			{
+				j += k;
+				k = 1;
+				p = j - maxSuffix;
+			}
+			else if (a == b)
+			{
+				if (k != p)
+				{
+					++k;
+				}
+				else
+				{
+					j += p;
+					k = 1;
+				}
+			}
+			else
+			{
+				maxSuffix = j++;
+				k = p = 1;
+			}
+		}
+		period = p;
+
+		size_t maxSuffixRev = SIZE_MAX;
+		j = 0;
+		k = p = 1;
+		while (j + k < length)
+		{
+			unsigned char a = needle[j + k];
+			unsigned char b = needle[maxSuffixRev + k];
+			if (b < a)
+			{
+				j += k;
+				k = 1;
+				p = j - maxSuffixRev;
+			}
+			else if (a == b)
+			{
+				if (k != p)
+				{
+					++k;
+				}
+				else
+				{
+					j += p;
+					k = 1;
+				}
+			}
+			else
+			{
+				maxSuffixRev = j++;
+				k = p = 1;
+			}
+		}
+
+		if (maxSuffixRev + 1 < maxSuffix + 1) return maxSuffix + 1;
+		period = p;
+		return maxSuffixRev + 1;
+	}
+
+	template <typename Text>
+	void prepareText(Search::TwoWayPlan& plan, const Text& needle, size_t length)
+	{
+		plan.suffix = criticalFactorization(needle, length, plan.period);
+
+		plan.periodic = plan.suffix + plan.period <= length;
+		for (size_t i = 0; plan.periodic && i < plan.suffix; ++i)
+		{
+			if (needle[i] != needle[i + plan.period]) plan.periodic = false;
+		}
+		if (!plan.periodic)
+		{
+			// 非周期时两半部分不会重叠，可以移动较长一半的长度
+			plan.period = MAX(plan.suffix, length - plan.suffix) + 1;
+		}
+
+		for (size_t i = 0; i < 256; ++i)
+		{
+			plan.shift[i] = length;
+		}
+		for (size_t i = 0; i < length; ++i)
+		{
+			plan.shift[needle[i]] = length - i - 1;
+		}
+	}
+
+	/**
+	 * @brief Two-Way查找
+	 *
+	 * @details 先用窗口末字节查移动表跳跃，末字节相同时从临界位置向右比较，再向左比较。
+	 *  周期字符串记录已匹配的前缀长度(memory)，避免重复比较，保证线性时间。
+	 */
+	template <typename Text>
+	size_t twoWay(const Text& data, size_t length, const Text& needle, size_t needleLength, const Search::TwoWayPlan& plan)
+	{
+		const size_t last = needleLength - 1;
+		const size_t suffix = plan.suffix;
+		const size_t period = plan.period;
+		size_t j = 0;
+
+		if (plan.periodic)
+		{
+			size_t memory = 0;
+			while (j + needleLength <= length)
+			{
+				size_t shift = plan.shift[data[j + last]];
+				if (shift > 0)
+				{
+					if (memory && shift < period) shift = needleLength - period;
+					memory = 0;
+					j += shift;
+					continue;
+				}
+
+				size_t i = MAX(suffix, memory);
+				while (i < last && needle[i] == data[i + j]) ++i;
+				if (i >= last)
+				{
+					i = suffix - 1;
+					while (memory < i + 1 && needle[i] == data[i + j]) --i;
+					if (i + 1 < memory + 1) return j;
+
+					j += period;
+					memory = needleLength - period;
+				}
+				else
+				{
+					j += i - suffix + 1;
+					memory = 0;
+				}
+			}
+		}
+		else
+		{
+			while (j + needleLength <= length)
+			{
+				size_t shift = plan.shift[data[j + last]];
+				if (shift > 0)
+				{
+					j += shift;
+					continue;
+				}
+
+				size_t i = suffix;
+				while (i < last && needle[i] == data[i + j]) ++i;
+				if (i >= last)
+				{
+					i = suffix - 1;
+					while (i != SIZE_MAX && needle[i] == data[i + j]) --i;
+					if (i == SIZE_MAX) return j;
+
+					j += period;
+				}
+				else
+				{
+					j += i - suffix + 1;
+				}
+			}
+		}
+		return SIZE_MAX;
+	}
+}
+
+void Search::prepare(TwoWayPlan& plan, const GI_STRING_DATA_TYPE* needle, size_t needleLength, bool reverse)
+{
+	const unsigned char* bytes = (const unsigned char*)needle;
+	if (reverse)
+	{
+		prepareText(plan, Backward{ bytes + needleLength }, needleLength);
+	}
+	else
+	{
+		prepareText(plan, Forward{ bytes }, needleLength);
+	}
+}
+
+size_t Search::find(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength, const TwoWayPlan* plan)
+{
+	if (needleLength == 0) return 0;
+	if (needleLength > length) return SIZE_MAX;
+	if (needleLength == 1) return Simd::findChar(data, length, needle[0]);
+	if (needleLength <= SHORT_NEEDLE_LENGTH) return Simd::findShort(data, length, needle, needleLength);
+
+	TwoWayPlan local;
+	if (!plan)
+	{
+		prepare(local, needle, needleLength, false);
+		plan = &local;
+	}
+	return twoWay(Forward{ (const unsigned char*)data }, length, Forward{ (const unsigned char*)needle }, needleLength, *plan);
+}
+
+size_t Search::findLast(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength, const TwoWayPlan* plan)
+{
+	if (needleLength == 0) return length;
+	if (needleLength > length) return SIZE_MAX;
+	if (needleLength == 1) return Simd::findLastChar(data, length, needle[0]);
+
+	TwoWayPlan local;
+	if (!plan)
+	{
+		prepare(local, needle, needleLength, true);
+		plan = &local;
+	}
+
+	// 逆序字符串中的第一次出现即原字符串中的最后一次出现
+	size_t found = twoWay(Backward{ (const unsigned char*)data + length }, length, Backward{ (const unsigned char*)needle + needleLength }, needleLength, *plan);
+	return found == SIZE_MAX ? SIZE_MAX : length - found - needleLength;
+}
@@ -0,0 +1,76 @@
+﻿/**
+ * @brief GiString内部使用的子串查找算法
+ *
+ * @file gi_string_search.h
+ *
+ * @details
+ *  1. 单字节使用SIMD字符查找。
+ *  2. 短字符串(不超过SHORT_NEEDLE_LENGTH字节)使用SIMD首尾字节过滤，每个候选位置的比较次数有上限。
+ *  3. 长字符串使用带末字节移动表的Two-Way算法，最坏情况下为线性时间，常见文本中可以跳跃前进。
+ *  4. 倒序查找在逆序的字符串上运行相同的Two-Way算法。
+ *  5. 预处理结果可以保存下来重复使用，见GiSearcher。
+ *  6. 仅供库内部及测试使用，不属于公开API。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+
+namespace GiKoo
+{
+	namespace Search
+	{
+		/**
+		 * @brief 使用首尾字节过滤的最大长度，超过该长度时使用Two-Way算法
+		 */
+		const size_t SHORT_NEEDLE_LENGTH = 16;
+
+		/**
+		 * @brief Two-Way算法的预处理结果
+		 */
+		struct TwoWayPlan
+		{
+			size_t suffix;			// 临界分解位置，右半部分的起点
+			size_t period;			// 移动的周期
+			bool periodic;			// 整个字符串是否以period为周期
+			size_t shift[256];		// 按窗口末字节的移动距离
+		};
+
+		/**
+		 * @brief 预处理指定字符串
+		 *
+		 * @param plan 预处理结果
+		 * @param needle 指定字符串
+		 * @param needleLength 指定字符串的字节数，至少为1
+		 * @param reverse 为true时按逆序的字符串预处理，用于findLast()
+		 */
+		void prepare(TwoWayPlan& plan, const GI_STRING_DATA_TYPE* needle, size_t needleLength, bool reverse);
+
+		/**
+		 * @brief 正序查找，按长度选择算法
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param needle 指定字符串
+		 * @param needleLength 指定字符串的字节数
+		 * @param plan 以reverse = false预处理的结果。为nullptr时按需临时预处理
+		 *
+		 * @return 第一次出现的位置。needleLength为0时返回0，未找到时返回SIZE_MAX
+		 */
+		size_t find(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength, const TwoWayPlan* plan = nullptr);
+
+		/**
+		 * @brief 倒序查找，按长度选择算法
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param needle 指定字符串
+		 * @param needleLength 指定字符串的字节数
+		 * @param plan 以reverse = true预处理的结果。为nullptr时按需临时预处理
+		 *
+		 * @return 最后一次出现的位置。needleLength为0时返回length，未找到时返回SIZE_MAX
+		 */
+		size_t findLast(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength, const TwoWayPlan* plan = nullptr);
+	}
+}
@@ -0,0 +1,639 @@
+﻿#include "gi_string_simd.h"
+#include <cstdint>
+#include <cstring>
+
+#if GI_STRING_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2实现所在的函数需要单独开启指令集，其他代码仍按基础指令集编译
+#if defined(__GNUC__) || defined(__clang__)
+#define GI_STRING_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GI_STRING_TARGET_AVX2
+#endif
+
+using namespace GiKoo;
+
+namespace
+{
+	/**
+	 * @brief 最低位的1所在位置，mask不能为0
+	 */
+	inline size_t lowestBit(unsigned int mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return (size_t)__builtin_ctz(mask);
+#endif
+	}
+
+	/**
+	 * @brief 最高位的1所在位置，mask不能为0
+	 */
+	inline size_t highestBit(unsigned int mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, mask);
+		return index;
+#else
+		return (size_t)(31 - __builtin_clz(mask));
+#endif
+	}
+
+	/**
+	 * @brief 64位掩码最低位的1所在位置，mask不能为0
+	 */
+	inline size_t lowestBit64(uint64_t mask)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return index;
+#elif defined(_MSC_VER)
+		return (uint32_t)mask ? lowestBit((unsigned int)mask) : 32 + lowestBit((unsigned int)(mask >> 32));
+#else
+		return (size_t)__builtin_ctzll(mask);
+#endif
+	}
+
+	/**
+	 * @brief 按位掩码输出位置
+	 */
+	inline void emitBits(uint64_t mask, size_t base, size_t* offsets, size_t& count)
+	{
+		while (mask)
+		{
+			offsets[count++] = base + lowestBit64(mask);
+			mask &= mask - 1;
+		}
+	}
+
+	/**
+	 * @brief 按指令集选择实现
+	 */
+	template <typename Fn>
+	Fn select(Fn scalar, Fn sse2, Fn avx2)
+	{
+		switch (Simd::detectIsa())
+		{
+		case Simd::ISA_AVX2: return avx2;
+		case Simd::ISA_SSE2: return sse2;
+		default: return scalar;
+		}
+	}
+}
+
+Simd::Isa Simd::detectIsa()
+{
+#if GI_STRING_SIMD_X86
+	static const Isa isa = []() {
+#if defined(_MSC_VER)
+		// CPUID.7.EBX[5]为AVX2，同时需要操作系统通过XCR0开启YMM寄存器
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] >= 7)
+		{
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			__cpuidex(info, 7, 0);
+			bool avx2 = (info[1] & (1 << 5)) != 0;
+			if (osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6) return ISA_AVX2;
+		}
+		return ISA_SSE2;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") ? ISA_AVX2 : ISA_SSE2;
+#endif
+	}();
+	return isa;
+#else
+	return ISA_SCALAR;
+#endif
+}
+
+size_t Simd::findChar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+#if GI_STRING_SIMD_X86
+	static const auto impl = select(findCharScalar, findCharSse2, findCharAvx2);
+	return impl(data, length, ch);
+#else
+	return findCharScalar(data, length, ch);
+#endif
+}
+
+size_t Simd::findLastChar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+#if GI_STRING_SIMD_X86
+	static const auto impl = select(findLastCharScalar, findLastCharSse2, findLastCharAvx2);
+	return impl(data, length, ch);
+#else
+	return findLastCharScalar(data, length, ch);
+#endif
+}
+
+size_t Simd::findShort(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength)
+{
+#if GI_STRING_SIMD_X86
+	static const auto impl = select(findShortScalar, findShortSse2, findShortAvx2);
+	return impl(data, length, needle, needleLength);
+#else
+	return findShortScalar(data, length, needle, needleLength);
+#endif
+}
+
+size_t Simd::mismatch(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length)
+{
+#if GI_STRING_SIMD_X86
+	// 短数据不值得一次间接调用
+	if (length < 16) return mismatchScalar(a, b, length);
+
+	static const auto impl = select(mismatchScalar, mismatchSse2, mismatchAvx2);
+	return impl(a, b, length);
+#else
+	return mismatchScalar(a, b, length);
+#endif
+}
+
+size_t Simd::lineBreaks(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count)
+{
+#if GI_STRING_SIMD_X86
+	static const auto impl = select(lineBreaksScalar, lineBreaksSse2, lineBreaksAvx2);
+	return impl(data, length, offsets, capacity, count);
+#else
+	return lineBreaksScalar(data, length, offsets, capacity, count);
+#endif
+}
+
+size_t Simd::findCharScalar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		if (data[i] == ch) return i;
+	}
+	return SIZE_MAX;
+}
+
+size_t Simd::findLastCharScalar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+	while (length > 0)
+	{
+		--length;
+		if (data[length] == ch) return length;
+	}
+	return SIZE_MAX;
+}
+
+size_t Simd::findShortScalar(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength)
+{
+	if (needleLength > length) return SIZE_MAX;
+
+	const GI_STRING_DATA_TYPE first = needle[0];
+	const GI_STRING_DATA_TYPE last = needle[needleLength - 1];
+	for (size_t pos = 0; pos + needleLength <= length; ++pos)
+	{
+		if (data[pos] == first && data[pos + needleLength - 1] == last
+			&& memcmp(data + pos + 1, needle + 1, needleLength - 2) == 0)
+		{
+			return pos;
+		}
+	}
+	return SIZE_MAX;
+}
+
+size_t Simd::mismatchScalar(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length)
+{
+	// 每次比较8字节，小端序下异或结果的最低非零字节即第一个不同的字节
+	size_t i = 0;
+	for (; i + 8 <= length; i += 8)
+	{
+		uint64_t x;
+		uint64_t y;
+		memcpy(&x, a + i, 8);
+		memcpy(&y, b + i, 8);
+		if (x != y)
+		{
+#if GI_STRING_SIMD_X86
+			return i + lowestBit64(x ^ y) / 8;
+#else
+			break;
+#endif
+		}
+	}
+	for (; i < length; ++i)
+	{
+		if (a[i] != b[i]) return i;
+	}
+	return length;
+}
+
+size_t Simd::lineBreaksScalar(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count)
+{
+	count = 0;
+	size_t i = 0;
+	for (; i < length && count < capacity; ++i)
+	{
+		if (data[i] == '\n' || data[i] == '\r') offsets[count++] = i;
+	}
+	return i;
+}
+
+#if GI_STRING_SIMD_X86
+
+size_t Simd::findCharSse2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+	const __m128i needle = _mm_set1_epi8(ch);
+	size_t i = 0;
+
+	// 每次检查64字节，合并4个掩码后再判断
+	for (; i + 64 <= length; i += 64)
+	{
+		__m128i eq0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), needle);
+		__m128i eq1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 16)), needle);
+		__m128i eq2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 32)), needle);
+		__m128i eq3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 48)), needle);
+		__m128i any = _mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3));
+		if (_mm_movemask_epi8(any) == 0) continue;
+
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(eq0);
+		if (mask) return i + lowestBit(mask);
+		mask = (unsigned int)_mm_movemask_epi8(eq1);
+		if (mask) return i + 16 + lowestBit(mask);
+		mask = (unsigned int)_mm_movemask_epi8(eq2);
+		if (mask) return i + 32 + lowestBit(mask);
+		mask = (unsigned int)_mm_movemask_epi8(eq3);
+		return i + 48 + lowestBit(mask);
+	}
+
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), needle);
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(eq);
+		if (mask) return i + lowestBit(mask);
+	}
+
+	// 剩余不足16字节。长度足够时回退重叠读取最后16字节，否则逐字节比较
+	if (i < length)
+	{
+		if (length >= 16)
+		{
+			size_t last = length - 16;
+			__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + last)), needle);
+			unsigned int mask = (unsigned int)_mm_movemask_epi8(eq) >> (i - last);
+			if (mask) return i + lowestBit(mask);
+			return SIZE_MAX;
+		}
+
+		size_t found = findCharScalar(data + i, length - i, ch);
+		return found == SIZE_MAX ? SIZE_MAX : i + found;
+	}
+	return SIZE_MAX;
+}
+
+size_t Simd::findLastCharSse2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+	const __m128i needle = _mm_set1_epi8(ch);
+	size_t end = length;
+
+	for (; end >= 64; end -= 64)
+	{
+		size_t i = end - 64;
+		__m128i eq0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), needle);
+		__m128i eq1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 16)), needle);
+		__m128i eq2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 32)), needle);
+		__m128i eq3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i + 48)), needle);
+		__m128i any = _mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3));
+		if (_mm_movemask_epi8(any) == 0) continue;
+
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(eq3);
+		if (mask) return i + 48 + highestBit(mask);
+		mask = (unsigned int)_mm_movemask_epi8(eq2);
+		if (mask) return i + 32 + highestBit(mask);
+		mask = (unsigned int)_mm_movemask_epi8(eq1);
+		if (mask) return i + 16 + highestBit(mask);
+		mask = (unsigned int)_mm_movemask_epi8(eq0);
+		return i + highestBit(mask);
+	}
+
+	for (; end >= 16; end -= 16)
+	{
+		size_t i = end - 16;
+		__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), needle);
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(eq);
+		if (mask) return i + highestBit(mask);
+	}
+
+	// 剩余不足16字节。长度足够时重叠读取开头16字节，否则逐字节比较
+	if (end > 0)
+	{
+		if (length >= 16)
+		{
+			__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)data), needle);
+			unsigned int mask = (unsigned int)_mm_movemask_epi8(eq) & ((1u << end) - 1);
+			if (mask) return highestBit(mask);
+			return SIZE_MAX;
+		}
+
+		return findLastCharScalar(data, end, ch);
+	}
+	return SIZE_MAX;
+}
+
+size_t Simd::findShortSse2(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength)
+{
+	if (needleLength > length) return SIZE_MAX;
+
+	const __m128i first = _mm_set1_epi8(needle[0]);
+	const __m128i last = _mm_set1_epi8(needle[needleLength - 1]);
+
+	// 每次检查16个候选位置，尾字节的读取范围为[pos + needleLength - 1, pos + needleLength + 15)
+	size_t pos = 0;
+	for (; pos + needleLength + 15 <= length; pos += 16)
+	{
+		__m128i eqFirst = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + pos)), first);
+		__m128i eqLast = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + pos + needleLength - 1)), last);
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast));
+		while (mask)
+		{
+			size_t candidate = pos + lowestBit(mask);
+			if (memcmp(data + candidate + 1, needle + 1, needleLength - 2) == 0) return candidate;
+			mask &= mask - 1;
+		}
+	}
+
+	size_t found = findShortScalar(data + pos, length - pos, needle, needleLength);
+	return found == SIZE_MAX ? SIZE_MAX : pos + found;
+}
+
+size_t Simd::mismatchSse2(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length)
+{
+	if (length < 16) return mismatchScalar(a, b, length);
+
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(eq) ^ 0xFFFF;
+		if (mask) return i + lowestBit(mask);
+	}
+
+	// 剩余不足16字节，回退重叠比较最后16字节
+	if (i < length)
+	{
+		size_t last = length - 16;
+		__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + last)), _mm_loadu_si128((const __m128i*)(b + last)));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(eq) ^ 0xFFFF;
+		if (mask) return last + lowestBit(mask);
+	}
+	return length;
+}
+
+size_t Simd::lineBreaksSse2(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count)
+{
+	const __m128i lf = _mm_set1_epi8('\n');
+	const __m128i cr = _mm_set1_epi8('\r');
+	count = 0;
+
+	// 每块64字节合并为一个64位掩码，没有换行符的块只需一次判断
+	size_t i = 0;
+	for (; i + LINE_BREAK_BLOCK <= length && count + LINE_BREAK_BLOCK <= capacity; i += LINE_BREAK_BLOCK)
+	{
+		uint64_t mask = 0;
+		for (size_t k = 0; k < LINE_BREAK_BLOCK; k += 16)
+		{
+			__m128i chunk = _mm_loadu_si128((const __m128i*)(data + i + k));
+			__m128i eq = _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr));
+			mask |= (uint64_t)(unsigned int)_mm_movemask_epi8(eq) << k;
+		}
+		emitBits(mask, i, offsets, count);
+	}
+
+	// 容量不足时返回，由调用者继续扫描；否则逐字节处理不足一块的剩余部分
+	if (i + LINE_BREAK_BLOCK <= length) return i;
+
+	size_t tail = 0;
+	size_t scanned = lineBreaksScalar(data + i, length - i, offsets + count, capacity - count, tail);
+	for (size_t k = 0; k < tail; ++k)
+	{
+		offsets[count + k] += i;
+	}
+	count += tail;
+	return i + scanned;
+}
+
+GI_STRING_TARGET_AVX2
+size_t Simd::findCharAvx2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+	if (length < 32) return findCharSse2(data, length, ch);
+
+	const __m256i needle = _mm256_set1_epi8(ch);
+	size_t i = 0;
+
+	// 每次检查128字节，合并4个掩码后再判断
+	for (; i + 128 <= length; i += 128)
+	{
+		__m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), needle);
+		__m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 32)), needle);
+		__m256i eq2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 64)), needle);
+		__m256i eq3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 96)), needle);
+		__m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+		if (_mm256_movemask_epi8(any) == 0) continue;
+
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(eq0);
+		if (mask) return i + lowestBit(mask);
+		mask = (unsigned int)_mm256_movemask_epi8(eq1);
+		if (mask) return i + 32 + lowestBit(mask);
+		mask = (unsigned int)_mm256_movemask_epi8(eq2);
+		if (mask) return i + 64 + lowestBit(mask);
+		mask = (unsigned int)_mm256_movemask_epi8(eq3);
+		return i + 96 + lowestBit(mask);
+	}
+
+	for (; i + 32 <= length; i += 32)
+	{
+		__m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), needle);
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(eq);
+		if (mask) return i + lowestBit(mask);
+	}
+
+	// 剩余不足32字节，回退重叠读取最后32字节
+	if (i < length)
+	{
+		size_t last = length - 32;
+		__m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + last)), needle);
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(eq) >> (i - last);
+		if (mask) return i + lowestBit(mask);
+	}
+	return SIZE_MAX;
+}
+
+GI_STRING_TARGET_AVX2
+size_t Simd::findLastCharAvx2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+	if (length < 32) return findLastCharSse2(data, length, ch);
+
+	const __m256i needle = _mm256_set1_epi8(ch);
+	size_t end = length;
+
+	for (; end >= 128; end -= 128)
+	{
+		size_t i = end - 128;
+		__m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), needle);
+		__m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 32)), needle);
+		__m256i eq2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 64)), needle);
+		__m256i eq3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i + 96)), needle);
+		__m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+		if (_mm256_movemask_epi8(any) == 0) continue;
+
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(eq3);
+		if (mask) return i + 96 + highestBit(mask);
+		mask = (unsigned int)_mm256_movemask_epi8(eq2);
+		if (mask) return i + 64 + highestBit(mask);
+		mask = (unsigned int)_mm256_movemask_epi8(eq1);
+		if (mask) return i + 32 + highestBit(mask);
+		mask = (unsigned int)_mm256_movemask_epi8(eq0);
+		return i + highestBit(mask);
+	}
+
+	for (; end >= 32; end -= 32)
+	{
+		size_t i = end - 32;
+		__m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + i)), needle);
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(eq);
+		if (mask) return i + highestBit(mask);
+	}
+
+	// 剩余不足32字节，重叠读取开头32字节
+	if (end > 0)
+	{
+		__m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)data), needle);
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(eq) & ((1u << end) - 1);
+		if (mask) return highestBit(mask);
+	}
+	return SIZE_MAX;
+}
+
+GI_STRING_TARGET_AVX2
+size_t Simd::mismatchAvx2(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length)
+{
+	if (length < 16) return mismatchScalar(a, b, length);
+	if (length < 32)
+	{
+		// 16~31字节: 首尾两次可能重叠的16字节比较
+		__m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(eq) ^ 0xFFFF;
+		if (mask) return lowestBit(mask);
+		size_t last = length - 16;
+		eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + last)), _mm_loadu_si128((const __m128i*)(b + last)));
+		mask = (unsigned int)_mm_movemask_epi8(eq) ^ 0xFFFF;
+		return mask ? last + lowestBit(mask) : length;
+	}
+
+	// 每次比较128字节，异或结果合并后一次判断是否全为0
+	size_t i = 0;
+	for (; i + 128 <= length; i += 128)
+	{
+		__m256i x0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+		__m256i x1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i + 32)), _mm256_loadu_si256((const __m256i*)(b + i + 32)));
+		__m256i x2 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i + 64)), _mm256_loadu_si256((const __m256i*)(b + i + 64)));
+		__m256i x3 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i + 96)), _mm256_loadu_si256((const __m256i*)(b + i + 96)));
+		__m256i any = _mm256_or_si256(_mm256_or_si256(x0, x1), _mm256_or_si256(x2, x3));
+		if (_mm256_testz_si256(any, any)) continue;
+
+		// 不同的字节异或后不为0
+		const __m256i zero = _mm256_setzero_si256();
+		unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x0, zero));
+		if (mask) return i + lowestBit(mask);
+		mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x1, zero));
+		if (mask) return i + 32 + lowestBit(mask);
+		mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x2, zero));
+		if (mask) return i + 64 + lowestBit(mask);
+		mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x3, zero));
+		return i + 96 + lowestBit(mask);
+	}
+
+	for (; i + 32 <= length; i += 32)
+	{
+		__m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+		unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(eq);
+		if (mask) return i + lowestBit(mask);
+	}
+
+	// 剩余不足32字节，回退重叠比较最后32字节
+	if (i < length)
+	{
+		size_t last = length - 32;
+		__m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + last)), _mm256_loadu_si256((const __m256i*)(b + last)));
+		unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(eq);
+		if (mask) return last + lowestBit(mask);
+	}
+	return length;
+}
+
+GI_STRING_TARGET_AVX2
+size_t Simd::lineBreaksAvx2(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count)
+{
+	const __m256i lf = _mm256_set1_epi8('\n');
+	const __m256i cr = _mm256_set1_epi8('\r');
+	count = 0;
+
+	size_t i = 0;
+	for (; i + LINE_BREAK_BLOCK <= length && count + LINE_BREAK_BLOCK <= capacity; i += LINE_BREAK_BLOCK)
+	{
+		__m256i lo = _mm256_loadu_si256((const __m256i*)(data + i));
+		__m256i hi = _mm256_loadu_si256((const __m256i*)(data + i + 32));
+		__m256i eqLo = _mm256_or_si256(_mm256_cmpeq_epi8(lo, lf), _mm256_cmpeq_epi8(lo, cr));
+		__m256i eqHi = _mm256_or_si256(_mm256_cmpeq_epi8(hi, lf), _mm256_cmpeq_epi8(hi, cr));
+		uint64_t mask = (uint64_t)(unsigned int)_mm256_movemask_epi8(eqLo) | ((uint64_t)(unsigned int)_mm256_movemask_epi8(eqHi) << 32);
+		emitBits(mask, i, offsets, count);
+	}
+
+	// 容量不足时返回，由调用者继续扫描；否则逐字节处理不足一块的剩余部分
+	if (i + LINE_BREAK_BLOCK <= length) return i;
+
+	size_t tail = 0;
+	size_t scanned = lineBreaksScalar(data + i, length - i, offsets + count, capacity - count, tail);
+	for (size_t k = 0; k < tail; ++k)
+	{
+		offsets[count + k] += i;
+	}
+	count += tail;
+	return i + scanned;
+}
+
+GI_STRING_TARGET_AVX2
+size_t Simd::findShortAvx2(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength)
+{
+	if (needleLength > length) return SIZE_MAX;
+
+	const __m256i first = _mm256_set1_epi8(needle[0]);
+	const __m256i last = _mm256_set1_epi8(needle[needleLength - 1]);
+
+	// 每次检查32个候选位置
+	size_t pos = 0;
+	for (; pos + needleLength + 31 <= length; pos += 32)
+	{
+		__m256i eqFirst = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + pos)), first);
+		__m256i eqLast = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + pos + needleLength - 1)), last);
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(eqFirst, eqLast));
+		while (mask)
+		{
+			size_t candidate = pos + lowestBit(mask);
+			if (memcmp(data + candidate + 1, needle + 1, needleLength - 2) == 0) return candidate;
+			mask &= mask - 1;
+		}
+	}
+
+	size_t found = findShortSse2(data + pos, length - pos, needle, needleLength);
+	return found == SIZE_MAX ? SIZE_MAX : pos + found;
+}
+
+#endif
@@ -0,0 +1,167 @@
+﻿/**
+ * @brief GiString内部使用的SIMD算法
+ *
+ * @file gi_string_simd.h
+ *
+ * @details
+ *  1. 每个算法提供标量、SSE2、AVX2三种实现，首次调用时根据CPU特性选择最快的实现。
+ *  2. 非x86平台只提供标量实现。
+ *  3. 仅供库内部及测试使用，不属于公开API。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GI_STRING_SIMD_X86 1
+#else
+#define GI_STRING_SIMD_X86 0
+#endif
+
+namespace GiKoo
+{
+	namespace Simd
+	{
+		/**
+		 * @brief 指令集
+		 */
+		enum Isa
+		{
+			ISA_SCALAR,
+			ISA_SSE2,
+			ISA_AVX2,
+		};
+
+		/**
+		 * @brief 当前CPU支持的最高指令集
+		 */
+		Isa detectIsa();
+
+		/**
+		 * @brief 正序查找字符
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param ch 指定字符
+		 *
+		 * @return 第一次出现的位置。未找到时返回SIZE_MAX
+		 */
+		size_t findChar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+
+		/**
+		 * @brief 倒序查找字符
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param ch 指定字符
+		 *
+		 * @return 最后一次出现的位置。未找到时返回SIZE_MAX
+		 */
+		size_t findLastChar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+
+		/**
+		 * @brief 正序查找短字符串
+		 *
+		 * @details 同时比较候选位置的首字节和尾字节，两者都相同时才比较中间部分。
+		 *  每个候选位置最多比较needleLength个字节，适用于短字符串。
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param needle 指定字符串
+		 * @param needleLength 指定字符串的字节数，至少为2
+		 *
+		 * @return 第一次出现的位置。未找到时返回SIZE_MAX
+		 */
+		size_t findShort(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength);
+
+		/**
+		 * @brief 查找两段数据第一个不同的字节
+		 *
+		 * @param a 第一段数据
+		 * @param b 第二段数据
+		 * @param length 比较的字节数
+		 *
+		 * @return 第一个不同的字节的位置。全部相同时返回length
+		 */
+		size_t mismatch(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length);
+
+		/**
+		 * @brief 两段数据是否相同
+		 *
+		 * @details 不超过16字节时用首尾两次可能重叠的读取完成比较，不经过指令集分派；更长时使用mismatch()。
+		 *
+		 * @param a 第一段数据
+		 * @param b 第二段数据
+		 * @param length 比较的字节数
+		 */
+		inline bool equal(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length)
+		{
+			if (length >= 8)
+			{
+				if (length > 16) return mismatch(a, b, length) == length;
+
+				uint64_t x0, y0, x1, y1;
+				memcpy(&x0, a, 8);
+				memcpy(&y0, b, 8);
+				memcpy(&x1, a + length - 8, 8);
+				memcpy(&y1, b + length - 8, 8);
+				return ((x0 ^ y0) | (x1 ^ y1)) == 0;
+			}
+			if (length >= 4)
+			{
+				uint32_t x0, y0, x1, y1;
+				memcpy(&x0, a, 4);
+				memcpy(&y0, b, 4);
+				memcpy(&x1, a + length - 4, 4);
+				memcpy(&y1, b + length - 4, 4);
+				return ((x0 ^ y0) | (x1 ^ y1)) == 0;
+			}
+			if (length == 0) return true;
+			return a[0] == b[0] && a[length >> 1] == b[length >> 1] && a[length - 1] == b[length - 1];
+		}
+
+		/**
+		 * @brief 一次扫描找出所有换行符(\r和\n)的位置
+		 *
+		 * @details 按块比较并生成位掩码，逐位输出位置。剩余容量不足以容纳一整块的结果时提前返回，
+		 *  调用者处理完已输出的位置后从返回值处继续扫描。
+		 *
+		 * @param data 数据起点
+		 * @param length 字节数
+		 * @param offsets 输出的位置，相对于data
+		 * @param capacity offsets的容量，至少为LINE_BREAK_BLOCK
+		 * @param count 输出的位置数
+		 *
+		 * @return 已扫描的字节数
+		 */
+		size_t lineBreaks(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count);
+
+		/**
+		 * @brief lineBreaks()每块扫描的字节数
+		 */
+		const size_t LINE_BREAK_BLOCK = 64;
+
+		// 各指令集的实现，用于测试和基准测试。调用前需确认CPU支持对应指令集
+		size_t findCharScalar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+		size_t findLastCharScalar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+		size_t findShortScalar(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength);
+		size_t mismatchScalar(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length);
+		size_t lineBreaksScalar(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count);
+#if GI_STRING_SIMD_X86
+		size_t findCharSse2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+		size_t findLastCharSse2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+		size_t findShortSse2(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength);
+		size_t mismatchSse2(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length);
+		size_t lineBreaksSse2(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count);
+		size_t findCharAvx2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+		size_t findLastCharAvx2(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch);
+		size_t findShortAvx2(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength);
+		size_t mismatchAvx2(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length);
+		size_t lineBreaksAvx2(const GI_STRING_DATA_TYPE* data, size_t length, size_t* offsets, size_t capacity, size_t& count);
+#endif
+	}
+}
@@ -0,0 +1,160 @@
+﻿/**
+ * @brief GiString内部使用的拆分算法
+ *
+ * @file gi_string_split.h
+ *
+ * @details
+ *  1. collect()实现与Java的Pattern.split()相同的拆分规则，查找方式由调用者提供。
+ *  2. 正则表达式为普通字符串时不需要运行正则引擎，literalChar()和literalText()用于识别这种情况。
+ *  3. lines()实现与Java的String.lines()相同的按行拆分规则。
+ *  4. 仅供库内部使用，不属于公开API。
+ *
+ */
+
+#pragma once
+
+#include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gi_string_simd.h"
+
+namespace GiKoo
+{
+	namespace Split
+	{
+		/**
+		 * @brief 正则表达式是否只表示一个字符
+		 *
+		 * @details 与JDK的String.split()快速路径相同: 一个非元字符，或者\加一个非字母数字的字符。
+		 *  另外接受\t \n \r \f。
+		 *
+		 * @param regex 正则表达式
+		 * @param ch 表示的字符
+		 *
+		 * @retval true 只表示一个字符
+		 * @retval false 需要正则引擎
+		 */
+		bool literalChar(const GiStringView& regex, GI_STRING_DATA_TYPE& ch);
+
+		/**
+		 * @brief 正则表达式是否为不含元字符的普通字符串
+		 *
+		 * @param regex 正则表达式
+		 * @param text 去掉转义后的字符串
+		 *
+		 * @retval true 普通字符串，且不为空
+		 * @retval false 需要正则引擎
+		 */
+		bool literalText(const GiStringView& regex, GiString& text);
+
+		/**
+		 * @brief 按Java的规则拆分
+		 *
+		 * @param str 指定字符串
+		 * @param limit 数量限制。大于0时最多拆分为limit个；等于0时去掉末尾的空字符串；小于0时保留
+		 * @param find 查找函数bool(size_t offset, size_t& start, size_t& end)，返回从offset开始的下一个匹配
+		 * @param whole str对应的GiString。不为nullptr时，没有匹配的结果共享它的缓冲区
+		 *
+		 * @return 结果集合
+		 */
+		template <typename Find>
+		std::vector<GiString> collect(const GiStringView& str, int limit, Find find, const GiString* whole = nullptr)
+		{
+			std::vector<GiString> ret;
+			size_t index = 0;
+			size_t offset = 0;
+			size_t start;
+			size_t end;
+			bool limited = limit > 0;
+			while (offset <= str.length() && find(offset, start, end))
+			{
+				// 空匹配之后从下一个字节继续查找
+				offset = end == start ? end + 1 : end;
+
+				if (limited && ret.size() >= (size_t)limit - 1) break;
+
+				// 开头的零宽匹配不产生空字符串
+				if (index == 0 && start == 0 && end == 0) continue;
+				ret.push_back(GiString(str.subString(index, start - index)));
+				index = end;
+			}
+
+			// 没有匹配时返回原字符串
+			if (index == 0)
+			{
+				ret.clear();
+				ret.push_back(whole ? *whole : GiString(str));
+				return ret;
+			}
+
+			ret.push_back(GiString(str.subString(index)));
+			if (limit == 0)
+			{
+				while (!ret.empty() && ret.back().isEmpty())
+				{
+					ret.pop_back();
+				}
+			}
+			return ret;
+		}
+
+		/**
+		 * @brief 找出[from, to)内的每个行结束符
+		 *
+		 * @details \n、\r、\r\n均为行结束符。\r\n中的\n不单独作为结束符，因此结果只取决于字符串内容，
+		 *  与from、to的位置无关，可以分块处理。换行符的位置由Simd::lineBreaks()批量找出。
+		 *
+		 * @param str 指定字符串
+		 * @param from 起点
+		 * @param to 终点
+		 * @param onBreak 处理函数void(size_t at, size_t next)，at为结束符的位置，next为结束符之后的位置
+		 */
+		template <typename OnBreak>
+		void lineBreaks(const GiStringView& str, size_t from, size_t to, OnBreak onBreak)
+		{
+			const size_t BATCH = 256;
+			size_t offsets[BATCH];
+			const GI_STRING_DATA_TYPE* data = str.data();
+			size_t length = str.length();
+			size_t pos = from;
+			while (pos < to)
+			{
+				size_t count = 0;
+				size_t scanned = Simd::lineBreaks(data + pos, to - pos, offsets, BATCH, count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					size_t at = pos + offsets[i];
+					if (data[at] == '\n')
+					{
+						if (at > 0 && data[at - 1] == '\r') continue;
+						onBreak(at, at + 1);
+					}
+					else
+					{
+						onBreak(at, at + 1 < length && data[at + 1] == '\n' ? at + 2 : at + 1);
+					}
+				}
+				pos += scanned;
+			}
+		}
+
+		/**
+		 * @brief 按Java的String.lines()规则逐行处理
+		 *
+		 * @details 行内容不含结束符。末尾的结束符之后不再产生空行，空字符串没有任何行。
+		 *
+		 * @param str 指定字符串
+		 * @param emit 处理函数void(size_t start, size_t length)，按顺序接收每一行在str中的范围
+		 */
+		template <typename Emit>
+		void lines(const GiStringView& str, Emit emit)
+		{
+			size_t lineStart = 0;
+			lineBreaks(str, 0, str.length(), [&](size_t at, size_t next) {
+				emit(lineStart, at - lineStart);
+				lineStart = next;
+			});
+
+			if (lineStart < str.length()) emit(lineStart, str.length() - lineStart);
+		}
+	}
+}
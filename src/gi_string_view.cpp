@@ -0,0 +1,236 @@
+﻿#include "gikoo/gi_string_view.h"
+#include "gi_string_hash.h"
+#include "gi_string_search.h"
+#include "gi_string_simd.h"
+#include <cstring>
+
+#define MIN(x,y) (x > y ? y : x)
+
+using namespace GiKoo;
+
+namespace
+{
+	/**
+	 * @brief 剔除字符集合
+	 */
+	struct GiCharSet
+	{
+		bool contains[256];
+
+		explicit GiCharSet(const GI_STRING_DATA_TYPE* coll)
+		{
+			if (coll == nullptr) coll = " \r\n\t";
+
+			memset(contains, 0, sizeof(contains));
+			while (*coll != '\0')
+			{
+				contains[(unsigned char)*coll++] = true;
+			}
+		}
+
+		bool operator()(GI_STRING_DATA_TYPE ch) const
+		{
+			return contains[(unsigned char)ch];
+		}
+	};
+
+	bool isTrimmable(GI_STRING_DATA_TYPE ch)
+	{
+		return (unsigned char)ch <= 0x20;
+	}
+}
+
+#if !GI_STRING_HEADER_ONLY
+GiStringView::GiStringView(const GI_STRING_DATA_TYPE* str)
+	: m_data(str ? str : ""), m_length(str ? strlen(str) : 0)
+{
+}
+
+bool GiStringView::equals(const GiStringView& another) const
+{
+	if (m_length != another.m_length) return false;
+	if (m_data == another.m_data) return true;
+	return equal(m_data, another.m_data, m_length);
+}
+
+bool GiStringView::operator==(const GiStringView& another) const
+{
+	return equals(another);
+}
+
+bool GiStringView::operator!=(const GiStringView& another) const
+{
+	return !equals(another);
+}
+#endif
+
+int GiStringView::compareTo(const GiStringView& another) const
+{
+	size_t length = MIN(m_length, another.m_length);
+	size_t index = m_data == another.m_data ? length : Simd::mismatch(m_data, another.m_data, length);
+	if (index < length)
+	{
+		return (int)(unsigned char)m_data[index] - (int)(unsigned char)another.m_data[index];
+	}
+
+	// 一个是另一个的前缀，与Java相同返回长度之差
+	if (m_length >= another.m_length)
+	{
+		size_t diff = m_length - another.m_length;
+		return diff > (size_t)INT_MAX ? INT_MAX : (int)diff;
+	}
+	size_t diff = another.m_length - m_length;
+	return diff > (size_t)INT_MAX ? INT_MIN : -(int)diff;
+}
+
+bool GiStringView::operator<(const GiStringView& another) const
+{
+	return compareTo(another) < 0;
+}
+
+bool GiStringView::contains(const GiStringView& str) const
+{
+	return indexOf(str) != SIZE_MAX;
+}
+
+bool GiStringView::isBlank() const
+{
+	for (size_t i = 0; i < m_length; ++i)
+	{
+		if (m_data[i] != ' ') return false;
+	}
+	return true;
+}
+
+#if !GI_STRING_HEADER_ONLY
+bool GiStringView::startsWith(const GiStringView& prefix, size_t offset) const
+{
+	if (offset > m_length || prefix.m_length > m_length - offset) return false;
+	return memcmp(m_data + offset, prefix.m_data, sizeof(GI_STRING_DATA_TYPE) * prefix.m_length) == 0;
+}
+
+bool GiStringView::endsWith(const GiStringView& suffix) const
+{
+	if (suffix.m_length > m_length) return false;
+	return memcmp(m_data + m_length - suffix.m_length, suffix.m_data, sizeof(GI_STRING_DATA_TYPE) * suffix.m_length) == 0;
+}
+#endif
+
+GiStringView GiStringView::strip(const GI_STRING_DATA_TYPE* coll) const
+{
+	GiCharSet set(coll);
+
+	size_t begin = 0;
+	size_t end = m_length;
+	while (begin < end && set(m_data[begin])) ++begin;
+	while (end > begin && set(m_data[end - 1])) --end;
+
+	return { m_data + begin, end - begin };
+}
+
+GiStringView GiStringView::stripLeading(const GI_STRING_DATA_TYPE* coll) const
+{
+	GiCharSet set(coll);
+
+	size_t begin = 0;
+	while (begin < m_length && set(m_data[begin])) ++begin;
+
+	return { m_data + begin, m_length - begin };
+}
+
+GiStringView GiStringView::stripTrailing(const GI_STRING_DATA_TYPE* coll) const
+{
+	GiCharSet set(coll);
+
+	size_t end = m_length;
+	while (end > 0 && set(m_data[end - 1])) --end;
+
+	return { m_data, end };
+}
+
+GiStringView GiStringView::trim() const
+{
+	return trimStart().trimEnd();
+}
+
+GiStringView GiStringView::trimStart() const
+{
+	size_t begin = 0;
+	while (begin < m_length && isTrimmable(m_data[begin])) ++begin;
+
+	return { m_data + begin, m_length - begin };
+}
+
+GiStringView GiStringView::trimEnd() const
+{
+	size_t end = m_length;
+	while (end > 0 && isTrimmable(m_data[end - 1])) --end;
+
+	return { m_data, end };
+}
+
+GiStringView GiStringView::subString(size_t offset, size_t length) const
+{
+	if (offset >= m_length) return {};
+	return { m_data + offset, MIN(m_length - offset, length) };
+}
+
+GiString GiStringView::toString() const
+{
+	return GiString(*this);
+}
+
+#if !GI_STRING_HEADER_ONLY
+size_t GiStringView::indexOf(GI_STRING_DATA_TYPE ch, size_t offset) const
+{
+	if (offset >= m_length) return SIZE_MAX;
+
+	size_t found = findChar(m_data + offset, m_length - offset, ch);
+	return found == SIZE_MAX ? SIZE_MAX : offset + found;
+}
+
+size_t GiStringView::indexOf(const GiStringView& str, size_t offset) const
+{
+	if (offset > m_length) return SIZE_MAX;
+
+	size_t found = find(m_data + offset, m_length - offset, str.m_data, str.m_length);
+	return found == SIZE_MAX ? SIZE_MAX : offset + found;
+}
+#endif
+
+size_t GiStringView::lastIndexOf(GI_STRING_DATA_TYPE ch, size_t offset) const
+{
+	if (m_length == 0) return SIZE_MAX;
+
+	return Simd::findLastChar(m_data, MIN(offset, m_length - 1) + 1, ch);
+}
+
+size_t GiStringView::lastIndexOf(const GiStringView& str, size_t offset) const
+{
+	if (str.m_length > m_length) return SIZE_MAX;
+
+	// 起始位置不大于offset的匹配都完整落在前MIN(offset, m_length - str.m_length) + str.m_length个字节内
+	return Search::findLast(m_data, MIN(offset, m_length - str.m_length) + str.m_length, str.m_data, str.m_length);
+}
+
+#if !GI_STRING_HEADER_ONLY
+size_t GiStringView::hashCode() const
+{
+	return Hash::hash(m_data, m_length);
+}
+#endif
+
+bool GiStringView::equal(const GI_STRING_DATA_TYPE* a, const GI_STRING_DATA_TYPE* b, size_t length)
+{
+	return Simd::equal(a, b, length);
+}
+
+size_t GiStringView::findChar(const GI_STRING_DATA_TYPE* data, size_t length, GI_STRING_DATA_TYPE ch)
+{
+	return Simd::findChar(data, length, ch);
+}
+
+size_t GiStringView::find(const GI_STRING_DATA_TYPE* data, size_t length, const GI_STRING_DATA_TYPE* needle, size_t needleLength)
+{
+	return Search::find(data, length, needle, needleLength);
+}
@@ -1,8 +1,68 @@
 ﻿#include "gtest/gtest.h"
 #include "gikoo/gi_string.h"
+#include "gikoo/gi_string_view.h"
+#include "gikoo/gi_allocator.h"
+#include "gikoo/gi_string_builder.h"
+#include "gikoo/gi_string_buffer.h"
+#include "gikoo/gi_searcher.h"
+#include "gikoo/gi_multi_matcher.h"
+#include "gikoo/gi_regex.h"
+#include "gikoo/gi_split_range.h"
+#include "gikoo/gi_static_string.h"
+#include "gikoo/gi_string_constexpr.h"
+#include "../src/gi_string_hash.h"
+#include "../src/gi_string_parallel.h"
+#include "../src/gi_string_search.h"
+#include "../src/gi_string_simd.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <string>
+#include <thread>
 
 using namespace GiKoo;
 
+// 统计全局堆内存申请次数，用于验证短字符串优化等不申请内存的场景
+static std::atomic<size_t> s_newCount(0);
+
+// 申请和释放都不内联：内联后编译器在调用处看到operator new返回的指针被free()释放，
+// 会误报-Wmismatched-new-delete
+#if defined(_MSC_VER)
+#define TEST_NOINLINE __declspec(noinline)
+#else
+#define TEST_NOINLINE __attribute__((noinline))
+#endif
+
+TEST_NOINLINE static void* countedMalloc(size_t size)
+{
+	++s_newCount;
+	void* ptr = malloc(size ? size : 1);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+TEST_NOINLINE static void countedFree(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void* operator new(size_t size) { return countedMalloc(size); }
+void* operator new[](size_t size) { return countedMalloc(size); }
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { countedFree(ptr); }
+
 TEST(GiStringUnit, Construction) {
 	GiString a;
 	EXPECT_EQ(a.c_str()[0], 0);
@@ -10,19 +70,19 @@ TEST(GiStringUnit, Construction) {
 	GiString b = "a";
 	EXPECT_EQ(b.c_str()[0], 'a');
 	EXPECT_EQ(b.c_str()[1], '\0');
-	EXPECT_EQ(b.length(), 1);
+	EXPECT_EQ(b.length(), 1u);
 
 	GiString c = "ab";
 	EXPECT_EQ(c.c_str()[0], 'a');
 	EXPECT_EQ(c.c_str()[1], 'b');
 	EXPECT_EQ(c.c_str()[2], '\0');
-	EXPECT_EQ(c.length(), 2);
+	EXPECT_EQ(c.length(), 2u);
 
 	GiString d = c;
 	EXPECT_EQ(d.c_str()[0], 'a');
 	EXPECT_EQ(d.c_str()[1], 'b');
 	EXPECT_EQ(d.c_str()[2], '\0');
-	EXPECT_EQ(d.length(), 2);
+	EXPECT_EQ(d.length(), 2u);
 
 	EXPECT_TRUE(true);
 }
@@ -34,13 +94,13 @@ TEST(GiStringUnit, ParamConstruction) {
 	EXPECT_EQ(a.c_str()[1], 'c');
 	EXPECT_EQ(a.c_str()[2], 'd');
 	EXPECT_EQ(a.c_str()[3], '\0');
-	EXPECT_EQ(a.length(), 3);
+	EXPECT_EQ(a.length(), 3u);
 
 	GiString b = { "abcd", 1, 2 };
 	EXPECT_EQ(b.c_str()[0], 'b');
 	EXPECT_EQ(b.c_str()[1], 'c');
 	EXPECT_EQ(b.c_str()[2], '\0');
-	EXPECT_EQ(b.length(), 2);
+	EXPECT_EQ(b.length(), 2u);
 
 	EXPECT_TRUE(true);
 }
@@ -64,6 +124,55 @@ TEST(GiStringUnit, Compare) {
 	EXPECT_TRUE(c.equals(e));
 	EXPECT_TRUE(e.equals(c));
 }
+
+TEST(GiStringUnit, compareTo) {
+	// 与Java的compareTo()对照
+	EXPECT_EQ(GiString("abcd").compareTo(GiString("abcd")), 0);
+	EXPECT_EQ(GiString("abcd").compareTo(GiString("aecd")), 'b' - 'e');
+	EXPECT_EQ(GiString("a").compareTo(GiString("abc")), -2);
+	EXPECT_EQ(GiString("abc").compareTo(GiString("")), 3);
+	EXPECT_EQ(GiString("").compareTo(GiString()), 0);
+	EXPECT_GT(GiString("\xc3\xa9").compareTo(GiString("z")), 0);
+	EXPECT_TRUE(GiString("apple") < GiString("banana"));
+	EXPECT_FALSE(GiString("apple") < GiString("apple"));
+	EXPECT_TRUE(GiString("apple") != GiString("apples"));
+	EXPECT_TRUE(GiStringView("app") < GiStringView("apple"));
+	EXPECT_EQ(GiStringView("b").compareTo(GiStringView("a")), 1);
+
+	// 原来返回指针的版本
+	GiString a = { "abcd" };
+	EXPECT_EQ(a.mismatch(GiString("abcd")), nullptr);
+	EXPECT_EQ(a.mismatch(GiString("abXd")), a.c_str() + 2);
+	EXPECT_EQ(a.mismatch(GiString("abcdef")), a.c_str() + 4);
+	EXPECT_EQ(a.mismatch(GiString()), a.c_str());
+
+	// 较长的字符串，不同的字节出现在各个位置
+	std::string text(300, 'x');
+	GiString base(text.c_str());
+	for (size_t pos = 0; pos < text.size(); pos += 13)
+	{
+		std::string changed = text;
+		changed[pos] = 'y';
+		GiString other(changed.c_str());
+		EXPECT_FALSE(base.equals(other)) << pos;
+		EXPECT_LT(base.compareTo(other), 0) << pos;
+		EXPECT_EQ(base.mismatch(other), base.c_str() + pos);
+	}
+
+	// 已缓存的hash数值不同时直接判定不等，相同内容的hash数值必然相同
+	GiString x = { "same content, separate buffers" };
+	GiString y = { "same content, separate buffers" };
+	x.hashCode();
+	y.hashCode();
+	EXPECT_TRUE(x.equals(y));
+	EXPECT_TRUE(x == y);
+
+	std::vector<GiString> words = { GiString("pear"), GiString("apple"), GiString("fig"), GiString("applesauce") };
+	std::sort(words.begin(), words.end());
+	EXPECT_TRUE(words[0].equals("apple"));
+	EXPECT_TRUE(words[1].equals("applesauce"));
+	EXPECT_TRUE(words[3].equals("pear"));
+}
 TEST(GiStringUnit, strip) {
 	GiString a = { " abcd" };
 	EXPECT_TRUE(a.strip().equals("abcd"));
@@ -287,4 +396,2014 @@ TEST(GiStringUnit, trimEnd) {
 
 	a = "abcd \n\t edf";
 	EXPECT_TRUE(a.trimEnd().equals("abcd \n\t edf"));
-}
\ No newline at end of file
+}
+TEST(GiStringUnit, length) {
+	GiString a = { "abcd" };
+	EXPECT_EQ(a.length(), 4u);
+	EXPECT_FALSE(a.isEmpty());
+	EXPECT_EQ(a.charAt(3), 'd');
+	EXPECT_EQ(a.charAt(4), 0);
+	EXPECT_EQ(a[3], 'd');
+	EXPECT_EQ(a[4], 'a');
+
+	a = "ab";
+	EXPECT_EQ(a.length(), 2u);
+	EXPECT_EQ(a.charAt(2), 0);
+
+	a = "abcdefgh";
+	EXPECT_EQ(a.length(), 8u);
+	EXPECT_TRUE(a.equals("abcdefgh"));
+
+	a.copy("abcdefgh", 3);
+	EXPECT_EQ(a.length(), 3u);
+	EXPECT_TRUE(a.equals("abc"));
+
+	a = a;
+	EXPECT_TRUE(a.equals("abc"));
+
+	a.copy(a.c_str() + 1);
+	EXPECT_EQ(a.length(), 2u);
+	EXPECT_TRUE(a.equals("bc"));
+
+	a.empty();
+	EXPECT_EQ(a.length(), 0u);
+	EXPECT_TRUE(a.isEmpty());
+	EXPECT_EQ(a.c_str()[0], '\0');
+}
+
+TEST(GiStringUnit, subString) {
+	GiString a = { "abcdef" };
+	EXPECT_TRUE(a.subString(0).equals("abcdef"));
+	EXPECT_TRUE(a.subString(2).equals("cdef"));
+	EXPECT_TRUE(a.subString(2, 2).equals("cd"));
+	EXPECT_TRUE(a.subString(4, 100).equals("ef"));
+	EXPECT_TRUE(a.subString(6).equals(""));
+	EXPECT_TRUE(a.subString(100).equals(""));
+	EXPECT_EQ(a.subString(2, 2).length(), 2u);
+}
+
+TEST(GiStringUnit, smallStringAllocation) {
+	size_t before = s_newCount;
+	{
+		GiString a;
+		GiString b = "key";
+		GiString c = b;
+		GiString d = "12345678901234567890123";
+		GiString e = d;
+		e = b;
+		e.empty();
+		EXPECT_EQ(d.length(), (size_t)GI_STRING_SSO_CAPACITY);
+		EXPECT_TRUE(c.equals("key"));
+		EXPECT_TRUE(d.subString(20).equals("123"));
+	}
+	EXPECT_EQ(s_newCount - before, 0u);
+
+	before = s_newCount;
+	{
+		GiString a = "123456789012345678901234";
+		EXPECT_EQ(s_newCount - before, 1u);
+		EXPECT_EQ(a.length(), (size_t)GI_STRING_SSO_CAPACITY + 1);
+		EXPECT_EQ(a.c_str()[GI_STRING_SSO_CAPACITY + 1], '\0');
+
+		GiString b;
+		b.copy(a.c_str());
+		EXPECT_EQ(s_newCount - before, 2u);
+		EXPECT_TRUE(b.equals(a));
+
+		// 容量足够时复用已有的堆内存
+		b.copy("short");
+		b.copy("123456789012345678901234");
+		EXPECT_EQ(s_newCount - before, 2u);
+		EXPECT_TRUE(b.equals(a));
+	}
+}
+
+// 与GiString成员布局一致但不含虚表指针的对照结构
+struct GiStringLayout
+{
+	GI_STRING_DATA_TYPE* data;
+	size_t length;
+	std::atomic<size_t> hash;
+	union
+	{
+		size_t capacity;
+		GI_STRING_DATA_TYPE local[GI_STRING_SSO_CAPACITY + 1];
+	};
+};
+
+TEST(GiStringUnit, layout) {
+	// 任何成员一旦声明为virtual，对象就会重新带上虚表指针
+	static_assert(!std::is_polymorphic<GiString>::value, "GiString must not have virtual members");
+	static_assert(sizeof(GiString) == sizeof(GiStringLayout), "GiString must not carry a vtable pointer");
+	EXPECT_EQ(sizeof(GiString), sizeof(GiStringLayout));
+}
+
+TEST(GiStringUnit, move) {
+	static_assert(std::is_nothrow_move_constructible<GiString>::value, "GiString must be nothrow movable");
+	static_assert(std::is_nothrow_move_assignable<GiString>::value, "GiString must be nothrow movable");
+
+	GiString a = "123456789012345678901234";
+	const char* data = a.c_str();
+
+	size_t before = s_newCount;
+	GiString b = std::move(a);
+	EXPECT_EQ(s_newCount - before, 0u);
+	EXPECT_EQ(b.c_str(), data);
+	EXPECT_TRUE(b.equals("123456789012345678901234"));
+	EXPECT_TRUE(a.isEmpty());
+	EXPECT_EQ(a.c_str()[0], '\0');
+
+	before = s_newCount;
+	GiString c = "short";
+	c = std::move(b);
+	EXPECT_EQ(s_newCount - before, 0u);
+	EXPECT_EQ(c.c_str(), data);
+	EXPECT_TRUE(b.isEmpty());
+
+	GiString d = "short";
+	GiString e = std::move(d);
+	EXPECT_TRUE(e.equals("short"));
+	EXPECT_TRUE(d.isEmpty());
+
+	e = std::move(e);
+	EXPECT_TRUE(e.equals("short"));
+
+	// vector扩容时移动而非拷贝
+	std::vector<GiString> vec;
+	vec.emplace_back("123456789012345678901234");
+	data = vec[0].c_str();
+	for (int i = 0; i < 16; ++i) vec.emplace_back();
+	EXPECT_EQ(vec[0].c_str(), data);
+	EXPECT_TRUE(vec[0].equals("123456789012345678901234"));
+}
+
+TEST(GiStringUnit, copyOnWrite) {
+	GiString a = "123456789012345678901234";
+
+	size_t before = s_newCount;
+	GiString b = a;
+	GiString c;
+	c = b;
+#if GI_STRING_COPY_ON_WRITE
+	EXPECT_EQ(s_newCount - before, 0u);
+	EXPECT_EQ(b.c_str(), a.c_str());
+	EXPECT_EQ(c.c_str(), a.c_str());
+#else
+	EXPECT_EQ(s_newCount - before, 2u);
+#endif
+
+	// 写入时复制出独立的缓冲区
+	b[0] = 'x';
+	EXPECT_NE(b.c_str(), a.c_str());
+	EXPECT_TRUE(a.equals("123456789012345678901234"));
+	EXPECT_TRUE(c.equals("123456789012345678901234"));
+	EXPECT_TRUE(b.equals("x23456789012345678901234"));
+
+	// 交出可写引用后，缓冲区不再共享
+	GI_STRING_DATA_TYPE& ref = b[1];
+	GiString d = b;
+	EXPECT_NE(d.c_str(), b.c_str());
+	ref = 'y';
+	EXPECT_TRUE(b.equals("xy3456789012345678901234"));
+	EXPECT_TRUE(d.equals("x23456789012345678901234"));
+
+	// 重新赋值不影响共享的对象
+	c.copy("abc");
+	EXPECT_TRUE(c.equals("abc"));
+	EXPECT_TRUE(a.equals("123456789012345678901234"));
+	c = a;
+	c.empty();
+	EXPECT_TRUE(c.isEmpty());
+	EXPECT_TRUE(a.equals("123456789012345678901234"));
+}
+
+TEST(GiStringUnit, copyOnWriteThreads) {
+	const GiString shared = "shared buffer across pipeline stages";
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&shared, t]() {
+			for (int i = 0; i < 10000; ++i)
+			{
+				GiString copy = shared;
+				GiString again = copy;
+				if (i % 2 == 0) again[0] = (GI_STRING_DATA_TYPE)('a' + t);
+				EXPECT_EQ(copy.length(), shared.length());
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	EXPECT_TRUE(shared.equals("shared buffer across pipeline stages"));
+}
+
+TEST(GiStringUnit, inPlaceSharedThreads) {
+	// 原地修改共享的缓冲区时，另一个线程同时释放最后一份拷贝。结果分别放在堆上和内联缓冲区
+	const char* inputs[] = { "   shared buffer released by another thread   ", "                 short result                 " };
+	const char* expected[] = { "shared buffer released by another thread", "short result" };
+	for (int i = 0; i < 2000; ++i)
+	{
+		GiString text = inputs[i % 2];
+		GiString* copy = new GiString(text);
+		std::atomic<bool> start(false);
+		std::thread thread([copy, &start]() {
+			while (!start.load(std::memory_order_acquire)) {}
+			delete copy;
+		});
+		start.store(true, std::memory_order_release);
+		text.trimInPlace();
+		thread.join();
+		EXPECT_STREQ(text.c_str(), expected[i % 2]);
+	}
+}
+
+#if GI_STRING_MEMORY_STATS
+TEST(GiStringUnit, memoryStats) {
+	GiStringMemoryStats before = GiString::memoryStats();
+	{
+		GiString a = "123456789012345678901234";
+		GiString b = "short";
+		GiStringMemoryStats stats = GiString::memoryStats();
+		EXPECT_EQ(stats.liveObjects - before.liveObjects, 2u);
+		EXPECT_EQ(stats.totalAllocations - before.totalAllocations, 1u);
+		EXPECT_GT(stats.liveBytes, before.liveBytes);
+
+		// 反复赋值不能泄漏
+		for (int i = 0; i < 100; ++i)
+		{
+			b.copy("this string does not fit in the inline buffer");
+			b = a;
+			a = "another long string that needs a heap buffer";
+			b.copy(a.c_str(), 30);
+		}
+		stats = GiString::memoryStats();
+		EXPECT_EQ(stats.liveObjects - before.liveObjects, 2u);
+		EXPECT_EQ((stats.totalAllocations - stats.totalFrees) - (before.totalAllocations - before.totalFrees), 2u);
+	}
+	GiStringMemoryStats after = GiString::memoryStats();
+	EXPECT_EQ(after.liveBytes, before.liveBytes);
+	EXPECT_EQ(after.liveObjects, before.liveObjects);
+	EXPECT_EQ(after.totalAllocations - before.totalAllocations, after.totalFrees - before.totalFrees);
+}
+
+TEST(GiStringUnit, memoryStatsThreads) {
+	// 各线程分别计数，在其他线程析构、线程退出后分组被复用，加总结果仍然正确
+	GiStringMemoryStats before = GiString::memoryStats();
+	std::vector<GiString> moved;
+	std::mutex lock;
+	for (int round = 0; round < 3; ++round)
+	{
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&moved, &lock]() {
+				GiString local = "a string allocated on a worker thread";
+				GiString handed = "a string destroyed on the main thread";
+				std::lock_guard<std::mutex> guard(lock);
+				moved.push_back(std::move(handed));
+			});
+		}
+		for (auto& thread : threads) thread.join();
+	}
+
+	GiStringMemoryStats stats = GiString::memoryStats();
+	EXPECT_EQ(stats.liveObjects - before.liveObjects, moved.size());
+	EXPECT_EQ(stats.totalAllocations - before.totalAllocations, 24u);
+	EXPECT_EQ(stats.totalFrees - before.totalFrees, 12u);
+	moved.clear();
+	moved.shrink_to_fit();
+
+	GiStringMemoryStats after = GiString::memoryStats();
+	EXPECT_EQ(after.liveBytes, before.liveBytes);
+	EXPECT_EQ(after.liveObjects, before.liveObjects);
+	EXPECT_EQ(after.totalFrees - before.totalFrees, 24u);
+}
+#endif
+
+TEST(GiStringUnit, query) {
+	GiString a = { "abcabc" };
+	EXPECT_EQ(a.indexOf('b'), 1u);
+	EXPECT_EQ(a.indexOf('b', 2), 4u);
+	EXPECT_EQ(a.indexOf('x'), SIZE_MAX);
+	EXPECT_EQ(a.indexOf('a', 100), SIZE_MAX);
+	EXPECT_EQ(a.lastIndexOf('b'), 4u);
+	EXPECT_EQ(a.lastIndexOf('b', 3), 1u);
+	EXPECT_EQ(a.lastIndexOf('c', 0), SIZE_MAX);
+
+	EXPECT_EQ(a.indexOf("bc"), 1u);
+	EXPECT_EQ(a.indexOf("bc", 2), 4u);
+	EXPECT_EQ(a.indexOf("bd"), SIZE_MAX);
+	EXPECT_EQ(a.indexOf(""), 0u);
+	EXPECT_EQ(a.indexOf("", 6), 6u);
+	EXPECT_EQ(a.lastIndexOf("bc"), 4u);
+	EXPECT_EQ(a.lastIndexOf("bc", 3), 1u);
+	EXPECT_EQ(a.lastIndexOf("abcabcd"), SIZE_MAX);
+
+	EXPECT_TRUE(a.contains("cab"));
+	EXPECT_FALSE(a.contains("cb"));
+	EXPECT_TRUE(a.startsWith("abc"));
+	EXPECT_TRUE(a.startsWith("ca", 2));
+	EXPECT_FALSE(a.startsWith("ca", 5));
+	EXPECT_TRUE(a.endsWith("bc"));
+	EXPECT_FALSE(a.endsWith("ab"));
+
+	GiString b = { "abcabc" };
+	EXPECT_EQ(a.hashCode(), b.hashCode());
+	EXPECT_EQ(a.hashCode(), a.view().hashCode());
+}
+
+TEST(GiStringView, query) {
+	GiString str = { "  key = value\t" };
+	GiStringView v = str;
+
+	EXPECT_EQ(v.length(), str.length());
+	EXPECT_EQ(v.data(), str.c_str());
+	EXPECT_EQ(v.charAt(2), 'k');
+	EXPECT_EQ(v.charAt(100), 0);
+	EXPECT_EQ(v.indexOf('='), 6u);
+	EXPECT_EQ(v.indexOf("value"), 8u);
+	EXPECT_TRUE(v.contains("key"));
+	EXPECT_TRUE(v.startsWith("  key"));
+	EXPECT_TRUE(v.endsWith("\t"));
+	EXPECT_TRUE(v.equals(str.view()));
+	EXPECT_FALSE(v.equals("key"));
+	EXPECT_EQ(v.hashCode(), str.hashCode());
+
+	GiStringView empty;
+	EXPECT_TRUE(empty.isEmpty());
+	EXPECT_TRUE(empty.isBlank());
+	EXPECT_TRUE(empty.equals(""));
+	EXPECT_TRUE(GiStringView(nullptr).isEmpty());
+	EXPECT_TRUE(GiStringView("abc", 2).equals("ab"));
+}
+
+TEST(GiStringView, trim) {
+	GiStringView v = "  key = value\t";
+
+	EXPECT_TRUE(v.trim().equals("key = value"));
+	EXPECT_TRUE(v.trimStart().equals("key = value\t"));
+	EXPECT_TRUE(v.trimEnd().equals("  key = value"));
+	EXPECT_TRUE(v.strip().equals("key = value"));
+	EXPECT_TRUE(v.strip(" ").equals("key = value\t"));
+	EXPECT_TRUE(v.stripLeading().equals("key = value\t"));
+	EXPECT_TRUE(v.stripTrailing().equals("  key = value"));
+	EXPECT_TRUE(GiStringView(" \t ").trim().isEmpty());
+	EXPECT_TRUE(GiStringView(" \t ").strip().isEmpty());
+
+	EXPECT_TRUE(v.subString(2, 3).equals("key"));
+	EXPECT_TRUE(v.subString(8).equals("value\t"));
+	EXPECT_TRUE(v.subString(100).isEmpty());
+
+	GiString copy = v.trim().toString();
+	EXPECT_TRUE(copy.equals("key = value"));
+}
+
+TEST(GiStringView, noAllocation) {
+	GiString line = "  user_name = someone@example.com ; role = administrator  ";
+
+	size_t before = s_newCount;
+	GiStringView rest = line.view().trim();
+	size_t count = 0;
+	while (!rest.isEmpty())
+	{
+		size_t end = rest.indexOf(';');
+		GiStringView field = rest.subString(0, end).trim();
+		size_t eq = field.indexOf('=');
+		GiStringView key = field.subString(0, eq).trimEnd();
+		GiStringView value = field.subString(eq + 1).trimStart();
+		EXPECT_FALSE(key.isEmpty());
+		EXPECT_FALSE(value.isEmpty());
+		++count;
+
+		if (end == SIZE_MAX) break;
+		rest = rest.subString(end + 1);
+	}
+	EXPECT_EQ(s_newCount - before, 0u);
+	EXPECT_EQ(count, 2u);
+}
+
+TEST(GiAllocator, arena) {
+	GiArenaAllocator arena(1024);
+	EXPECT_EQ(GiAllocator::current(), GiAllocator::defaultAllocator());
+
+	size_t before = s_newCount;
+	{
+		GiAllocatorScope scope(&arena);
+		EXPECT_EQ(GiAllocator::current(), &arena);
+
+		GiString a = "a request scoped string on the arena";
+		GiString b = a.subString(2);
+		EXPECT_TRUE(b.equals("request scoped string on the arena"));
+		EXPECT_GT(arena.bytesUsed(), 0u);
+
+		// 只有第一个块向系统申请内存
+		EXPECT_EQ(s_newCount - before, 1u);
+	}
+	EXPECT_EQ(GiAllocator::current(), GiAllocator::defaultAllocator());
+
+	arena.reset();
+	EXPECT_EQ(arena.bytesUsed(), 0u);
+
+	// 超过块大小的申请
+	GiAllocatorScope scope(&arena);
+	GiString big(std::string(4096, 'x').c_str());
+	EXPECT_EQ(big.length(), 4096u);
+	EXPECT_EQ(big.charAt(4095), 'x');
+}
+
+TEST(GiAllocator, copyOutOfArena) {
+	GiString cache;
+	GiString constructed;
+	{
+		GiArenaAllocator arena;
+		GiAllocatorScope scope(&arena);
+		GiString tmp = "a request scoped value that is long";
+		tmp.hashCode();
+		cache = tmp;
+		GiString copied(tmp);
+		constructed = copied;
+		EXPECT_NE(cache.c_str(), tmp.c_str());
+		EXPECT_GT(arena.bytesUsed(), 0u);
+	}
+
+	// arena已经释放，拷贝仍然可读，并且可以修改、释放
+	EXPECT_STREQ(cache.c_str(), "a request scoped value that is long");
+	EXPECT_STREQ(constructed.c_str(), "a request scoped value that is long");
+	EXPECT_EQ(cache.hashCode(), GiStringView("a request scoped value that is long").hashCode());
+	cache[0] = 'A';
+	EXPECT_STREQ(cache.c_str(), "A request scoped value that is long");
+#if GI_STRING_COPY_ON_WRITE
+	GiString shared = constructed;
+	EXPECT_EQ(shared.c_str(), constructed.c_str());
+#endif
+}
+
+TEST(GiAllocator, nestedScope) {
+	GiArenaAllocator outer;
+	GiPoolAllocator inner;
+	{
+		GiAllocatorScope scope1(&outer);
+		{
+			GiAllocatorScope scope2(&inner);
+			EXPECT_EQ(GiAllocator::current(), &inner);
+		}
+		EXPECT_EQ(GiAllocator::current(), &outer);
+	}
+	EXPECT_EQ(GiAllocator::current(), GiAllocator::defaultAllocator());
+}
+
+TEST(GiAllocator, pool) {
+	GiPoolAllocator pool;
+
+	void* a = pool.allocate(40);
+	pool.deallocate(a, 40);
+	void* b = pool.allocate(64);
+	EXPECT_EQ(a, b);
+	pool.deallocate(b, 64);
+
+	void* big = pool.allocate(100000);
+	pool.deallocate(big, 100000);
+
+	GiString outside = "long lived string from the default allocator";
+	{
+		GiAllocatorScope scope(&pool);
+		GiString str = "long lived string from the pool allocator";
+		GiString copy = str;
+		copy[0] = 'L';
+		EXPECT_TRUE(str.startsWith("long"));
+		EXPECT_TRUE(copy.startsWith("Long"));
+
+		// 作用域外申请的缓冲区仍归还给原来的分配器
+		outside.copy("replaced inside the pool scope, freed by new/delete");
+	}
+	EXPECT_TRUE(outside.startsWith("replaced"));
+}
+
+// 长期有效的分配器，统计申请次数
+class GiCountingAllocator : public GiAllocator
+{
+public:
+	size_t allocations = 0;
+
+	void* allocate(size_t size) override
+	{
+		++allocations;
+		return defaultAllocator()->allocate(size);
+	}
+
+	void deallocate(void* ptr, size_t size) override
+	{
+		defaultAllocator()->deallocate(ptr, size);
+	}
+};
+
+TEST(GiAllocator, copyKeepsAllocator) {
+	GiCountingAllocator counting;
+	GiArenaAllocator arena;
+	EXPECT_FALSE(counting.isScoped());
+	EXPECT_TRUE(arena.isScoped());
+
+	GiString original;
+	GiString writable;
+	{
+		GiAllocatorScope scope(&counting);
+		original = GiString("long lived string from a long lived allocator");
+		writable = GiString("long lived string handed out for writing");
+		writable[0] = 'L';
+	}
+	EXPECT_EQ(counting.allocations, 2u);
+
+	// 在其他作用域内拷贝，照常共享，复制时留在原分配器
+	GiAllocatorScope scope(&arena);
+	GiString copy = original;
+	GiString deep = writable;
+#if GI_STRING_COPY_ON_WRITE
+	EXPECT_EQ(copy.c_str(), original.c_str());
+	EXPECT_EQ(counting.allocations, 3u);
+#else
+	EXPECT_NE(copy.c_str(), original.c_str());
+	EXPECT_EQ(counting.allocations, 4u);
+#endif
+	EXPECT_NE(deep.c_str(), writable.c_str());
+	EXPECT_STREQ(deep.c_str(), "Long lived string handed out for writing");
+	EXPECT_EQ(arena.bytesUsed(), 0u);
+}
+
+TEST(GiAllocator, poolThreads) {
+	GiPoolAllocator pool;
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&pool]() {
+			GiAllocatorScope scope(&pool);
+			std::vector<GiString> strings;
+			for (int i = 0; i < 2000; ++i)
+			{
+				strings.emplace_back(std::string(24 + i % 200, 'p').c_str());
+				if (strings.size() > 100) strings.erase(strings.begin());
+			}
+			for (auto& str : strings) EXPECT_EQ(str.charAt(0), 'p');
+		});
+	}
+	for (auto& thread : threads) thread.join();
+}
+
+TEST(GiAllocator, poolThreadCache) {
+	// 线程退出时缓存归还给共享空闲链表，其他线程可以取到
+	GiPoolAllocator pool;
+	void* freed = nullptr;
+	std::thread([&pool, &freed]() {
+		freed = pool.allocate(32);
+		pool.deallocate(freed, 32);
+	}).join();
+	std::vector<void*> taken;
+	for (int i = 0; i < 64; ++i) taken.push_back(pool.allocate(32));
+	EXPECT_NE(std::find(taken.begin(), taken.end(), freed), taken.end());
+
+	// 由其他线程释放
+	std::thread([&pool, &taken]() {
+		for (void* ptr : taken) pool.deallocate(ptr, 32);
+	}).join();
+
+	// 同一线程使用的内存池多于线程缓存的槽位
+	std::vector<std::unique_ptr<GiPoolAllocator>> pools;
+	for (int i = 0; i < 8; ++i) pools.emplace_back(new GiPoolAllocator());
+	for (auto& each : pools)
+	{
+		GiAllocatorScope scope(each.get());
+		GiString str = "a string stored in one of many pools";
+		EXPECT_TRUE(str.startsWith("a string"));
+	}
+
+	// 内存池销毁时其他线程的缓存中仍有它的内存，之后该线程使用新的内存池
+	std::mutex lock;
+	std::condition_variable changed;
+	int step = 0;
+	std::unique_ptr<GiPoolAllocator> first(new GiPoolAllocator());
+	std::unique_ptr<GiPoolAllocator> second;
+	std::thread worker([&]() {
+		first->deallocate(first->allocate(100), 100);
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			step = 1;
+			changed.notify_all();
+			changed.wait(guard, [&]() { return step == 2; });
+		}
+		GiAllocatorScope scope(second.get());
+		GiString str = "allocated after the first pool was destroyed";
+		EXPECT_TRUE(str.endsWith("destroyed"));
+	});
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		changed.wait(guard, [&]() { return step == 1; });
+		first.reset();
+		second.reset(new GiPoolAllocator());
+		step = 2;
+		changed.notify_all();
+	}
+	worker.join();
+}
+
+TEST(GiStringUnit, concat) {
+	GiString a = "abc";
+	EXPECT_TRUE(a.concat("def").equals("abcdef"));
+	EXPECT_TRUE(a.concat("").equals("abc"));
+	EXPECT_TRUE(GiString().concat(a).equals("abc"));
+	EXPECT_TRUE(a.concat("defghijklmnopqrstuvwxyz0123").equals("abcdefghijklmnopqrstuvwxyz0123"));
+	EXPECT_TRUE(a.equals("abc"));
+}
+
+TEST(GiStringBuilder, append) {
+	GiStringBuilder builder;
+	builder.append("key").append('=').append(GiString("value")).append(GiStringView(";;", 1));
+	builder.append(42).append(' ').append(-7).append(' ').append(0u);
+	builder.append(' ').append(LLONG_MIN).append(' ').append(ULLONG_MAX);
+	builder.append((const char*)nullptr);
+
+	EXPECT_TRUE(builder.toString().equals("key=value;42 -7 0 -9223372036854775808 18446744073709551615"));
+	EXPECT_EQ(builder.length(), builder.toString().length());
+	EXPECT_EQ(builder.charAt(3), '=');
+
+	// 追加自身内容
+	GiStringBuilder self("abc");
+	self.append(self.view()).append(self.view());
+	EXPECT_TRUE(self.toString().equals("abcabcabcabc"));
+}
+
+TEST(GiStringBuilder, growth) {
+	GiStringBuilder builder;
+	size_t before = s_newCount;
+	for (int i = 0; i < 10000; ++i)
+	{
+		builder.append('x');
+	}
+	EXPECT_EQ(builder.length(), 10000u);
+	EXPECT_GE(builder.capacity(), 10000u);
+
+	// 2倍扩容，申请次数为对数级别
+	EXPECT_LE(s_newCount - before, 16u);
+
+	GiStringBuilder reserved(1000);
+	before = s_newCount;
+	for (int i = 0; i < 1000; ++i)
+	{
+		reserved.append('y');
+	}
+	EXPECT_EQ(s_newCount - before, 0u);
+
+	reserved.clear();
+	EXPECT_EQ(reserved.length(), 0u);
+	EXPECT_GE(reserved.capacity(), 1000u);
+}
+
+TEST(GiStringBuilder, edit) {
+	GiStringBuilder builder("hello world");
+	builder.insert(5, ",");
+	EXPECT_TRUE(builder.view().equals("hello, world"));
+	builder.insert(0, '>');
+	EXPECT_TRUE(builder.view().equals(">hello, world"));
+	builder.insert(100, "!");
+	EXPECT_TRUE(builder.view().equals(">hello, world!"));
+	builder.insert(1, builder.view().subString(1, 5));
+	EXPECT_TRUE(builder.view().equals(">hellohello, world!"));
+
+	builder.deleteCharAt(0);
+	EXPECT_TRUE(builder.view().equals("hellohello, world!"));
+	builder.deleteCharAt(100);
+	EXPECT_TRUE(builder.view().equals("hellohello, world!"));
+
+	builder.reverse();
+	EXPECT_TRUE(builder.view().equals("!dlrow ,olleholleh"));
+
+	GiStringBuilder single("a");
+	single.reverse();
+	EXPECT_TRUE(single.view().equals("a"));
+}
+
+TEST(GiStringBuilder, toString) {
+	GiStringBuilder builder;
+	builder.append("a string that is long enough for the heap");
+	const char* data = builder.view().data();
+
+	// 共享缓冲区，构建器修改时复制
+	GiString shared = builder.toString();
+#if GI_STRING_COPY_ON_WRITE
+	EXPECT_EQ(shared.c_str(), data);
+#endif
+	builder.append('!');
+	EXPECT_TRUE(shared.equals("a string that is long enough for the heap"));
+	EXPECT_TRUE(builder.view().equals("a string that is long enough for the heap!"));
+
+	// 交出缓冲区
+	data = builder.view().data();
+	GiString moved = std::move(builder).toString();
+	EXPECT_EQ(moved.c_str(), data);
+	EXPECT_EQ(builder.length(), 0u);
+}
+
+TEST(GiStringBuffer, singleThread) {
+	GiStringBuffer buffer;
+	buffer.append("count=").append(3).append(',').append(GiString("x")).append(GiStringView("yz", 1));
+	EXPECT_TRUE(buffer.toString().equals("count=3,xy"));
+	EXPECT_EQ(buffer.length(), 10u);
+
+	buffer.insert(0, '[').append(']');
+	EXPECT_TRUE(buffer.toString().equals("[count=3,xy]"));
+	buffer.deleteCharAt(0);
+	buffer.reverse();
+	EXPECT_TRUE(buffer.toString().equals("]yx,3=tnuoc"));
+
+	buffer.clear();
+	EXPECT_EQ(buffer.length(), 0u);
+
+	// 超过合并阈值的内容
+	std::string big(10000, 'b');
+	buffer.append("a").append(big.c_str()).append("c");
+	GiString result = buffer.toString();
+	EXPECT_EQ(result.length(), 10002u);
+	EXPECT_EQ(result.charAt(0), 'a');
+	EXPECT_EQ(result.charAt(10001), 'c');
+}
+
+TEST(GiStringBuffer, arenaScope) {
+	GiStringBuffer buffer(8);
+	{
+		GiArenaAllocator arena;
+		GiAllocatorScope scope(&arena);
+		buffer.append("appended inside an arena scope, long enough to leave the local buffer;");
+		buffer.append(std::string(5000, 'a').c_str());
+		buffer.insert(0, '[');
+		EXPECT_EQ(buffer.length(), 5071u);
+		EXPECT_EQ(arena.bytesUsed(), 0u);
+	}
+
+	// arena释放后缓冲区仍然可用
+	buffer.append("x").append(']');
+	GiString result = buffer.toString();
+	EXPECT_EQ(result.length(), 5073u);
+	EXPECT_TRUE(result.startsWith("[appended inside"));
+	EXPECT_TRUE(result.endsWith("ax]"));
+}
+
+TEST(GiStringBuffer, multiThread) {
+	GiStringBuffer buffer;
+	const int THREADS = 8;
+	const int APPENDS = 2000;
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREADS; ++t)
+	{
+		threads.emplace_back([&buffer, t]() {
+			for (int i = 0; i < APPENDS; ++i)
+			{
+				GiStringBuilder line;
+				line.append((char)('A' + t)).append(i).append(';');
+				buffer.append(line.view());
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	// 每次追加完整出现，同一线程的顺序不变
+	GiString result = buffer.toString();
+	GiStringView rest = result.view();
+	int next[THREADS] = {};
+	while (!rest.isEmpty())
+	{
+		size_t end = rest.indexOf(';');
+		ASSERT_NE(end, SIZE_MAX);
+		int t = rest.charAt(0) - 'A';
+		ASSERT_GE(t, 0);
+		ASSERT_LT(t, THREADS);
+
+		GiStringBuilder expected;
+		expected.append(next[t]++);
+		EXPECT_TRUE(rest.subString(1, end - 1).equals(expected.view()));
+		rest = rest.subString(end + 1);
+	}
+	for (int t = 0; t < THREADS; ++t)
+	{
+		EXPECT_EQ(next[t], APPENDS);
+	}
+}
+
+TEST(GiStringSimd, findChar) {
+	typedef size_t(*FindFn)(const GI_STRING_DATA_TYPE*, size_t, GI_STRING_DATA_TYPE);
+	std::vector<FindFn> forward = { Simd::findChar, Simd::findCharScalar };
+	std::vector<FindFn> backward = { Simd::findLastChar, Simd::findLastCharScalar };
+#if GI_STRING_SIMD_X86
+	forward.push_back(Simd::findCharSse2);
+	backward.push_back(Simd::findLastCharSse2);
+	if (Simd::detectIsa() >= Simd::ISA_AVX2)
+	{
+		forward.push_back(Simd::findCharAvx2);
+		backward.push_back(Simd::findLastCharAvx2);
+	}
+#endif
+
+	// 覆盖各种长度、起始地址对齐方式以及命中位置
+	std::vector<GI_STRING_DATA_TYPE> buffer(300, 'a');
+	for (size_t align = 0; align < 4; ++align)
+	{
+		for (size_t length = 0; length < 200; ++length)
+		{
+			const GI_STRING_DATA_TYPE* data = buffer.data() + align;
+			for (auto fn : forward) EXPECT_EQ(fn(data, length, 'x'), SIZE_MAX);
+			for (auto fn : backward) EXPECT_EQ(fn(data, length, 'x'), SIZE_MAX);
+
+			for (size_t pos = 0; pos < length; pos += (length > 70 ? 7 : 1))
+			{
+				buffer[align + pos] = 'x';
+				for (auto fn : forward) EXPECT_EQ(fn(data, length, 'x'), pos) << length;
+				for (auto fn : backward) EXPECT_EQ(fn(data, length, 'x'), pos) << length;
+
+				// 首尾都有匹配时分别取最前和最后
+				if (pos + 1 < length)
+				{
+					buffer[align + length - 1] = 'x';
+					for (auto fn : forward) EXPECT_EQ(fn(data, length, 'x'), pos);
+					for (auto fn : backward) EXPECT_EQ(fn(data, length, 'x'), length - 1);
+					buffer[align + length - 1] = 'a';
+				}
+				buffer[align + pos] = 'a';
+			}
+		}
+	}
+
+	// 高位字节
+	const char high[] = "abc\xff\x80";
+	EXPECT_EQ(Simd::findChar(high, 5, (GI_STRING_DATA_TYPE)0x80), 4u);
+	EXPECT_EQ(Simd::findLastChar(high, 5, (GI_STRING_DATA_TYPE)0xff), 3u);
+}
+
+TEST(GiStringSimd, mismatch) {
+	typedef size_t(*MismatchFn)(const GI_STRING_DATA_TYPE*, const GI_STRING_DATA_TYPE*, size_t);
+	std::vector<MismatchFn> fns = { Simd::mismatch, Simd::mismatchScalar };
+#if GI_STRING_SIMD_X86
+	fns.push_back(Simd::mismatchSse2);
+	if (Simd::detectIsa() >= Simd::ISA_AVX2) fns.push_back(Simd::mismatchAvx2);
+#endif
+
+	std::vector<GI_STRING_DATA_TYPE> a(300, 'a');
+	std::vector<GI_STRING_DATA_TYPE> b(300, 'a');
+	for (size_t length = 0; length < 200; ++length)
+	{
+		for (auto fn : fns) EXPECT_EQ(fn(a.data() + 1, b.data() + 3, length), length);
+		for (size_t pos = 0; pos < length; ++pos)
+		{
+			b[3 + pos] = (GI_STRING_DATA_TYPE)0x80;
+			for (auto fn : fns) EXPECT_EQ(fn(a.data() + 1, b.data() + 3, length), pos) << length;
+			if (pos + 1 < length)
+			{
+				b[3 + length - 1] = 'b';
+				for (auto fn : fns) EXPECT_EQ(fn(a.data() + 1, b.data() + 3, length), pos) << length;
+				b[3 + length - 1] = 'a';
+			}
+			b[3 + pos] = 'a';
+		}
+	}
+}
+
+TEST(GiStringSimd, lineBreaks) {
+	typedef size_t(*LineFn)(const GI_STRING_DATA_TYPE*, size_t, size_t*, size_t, size_t&);
+	std::vector<LineFn> fns = { Simd::lineBreaks, Simd::lineBreaksScalar };
+#if GI_STRING_SIMD_X86
+	fns.push_back(Simd::lineBreaksSse2);
+	if (Simd::detectIsa() >= Simd::ISA_AVX2) fns.push_back(Simd::lineBreaksAvx2);
+#endif
+
+	// 随机分布的换行符，容量较小时分多次扫描，结果与逐字节比较相同
+	srand(17);
+	std::string text;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		int r = rand() % 10;
+		text += r == 0 ? '\n' : (r == 1 ? '\r' : (char)('a' + r));
+	}
+	std::vector<size_t> expected;
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		if (text[i] == '\n' || text[i] == '\r') expected.push_back(i);
+	}
+
+	for (auto fn : fns)
+	{
+		for (size_t capacity : { Simd::LINE_BREAK_BLOCK, (size_t)100, (size_t)2000 })
+		{
+			std::vector<size_t> offsets(capacity);
+			std::vector<size_t> actual;
+			size_t pos = 0;
+			while (pos < text.size())
+			{
+				size_t count = 0;
+				size_t scanned = fn(text.data() + pos, text.size() - pos, offsets.data(), capacity, count);
+				ASSERT_GT(scanned, 0u);
+				for (size_t i = 0; i < count; ++i)
+				{
+					actual.push_back(pos + offsets[i]);
+				}
+				pos += scanned;
+			}
+			EXPECT_EQ(actual, expected) << capacity;
+		}
+	}
+}
+
+TEST(GiStringSearch, matchesStdString) {
+	typedef size_t(*FindShortFn)(const GI_STRING_DATA_TYPE*, size_t, const GI_STRING_DATA_TYPE*, size_t);
+	std::vector<FindShortFn> shortFns = { Simd::findShort, Simd::findShortScalar };
+#if GI_STRING_SIMD_X86
+	shortFns.push_back(Simd::findShortSse2);
+	if (Simd::detectIsa() >= Simd::ISA_AVX2) shortFns.push_back(Simd::findShortAvx2);
+#endif
+
+	// 小字母表的随机文本中包含大量部分匹配，与std::string的结果逐一对比
+	srand(20241017);
+	for (int round = 0; round < 300; ++round)
+	{
+		std::string text(rand() % 300, 'a');
+		for (auto& ch : text) ch = (char)('a' + rand() % 3);
+		for (size_t length = 1; length <= 40 && length <= text.size(); ++length)
+		{
+			std::string needle = text.substr(rand() % (text.size() - length + 1), length);
+			if (rand() % 2) needle[rand() % length] = (char)('a' + rand() % 3);
+
+			EXPECT_EQ(Search::find(text.data(), text.size(), needle.data(), length), text.find(needle));
+			EXPECT_EQ(Search::findLast(text.data(), text.size(), needle.data(), length), text.rfind(needle));
+			if (length >= 2 && length <= Search::SHORT_NEEDLE_LENGTH)
+			{
+				for (auto fn : shortFns) EXPECT_EQ(fn(text.data(), text.size(), needle.data(), length), text.find(needle));
+			}
+
+			GiString str(text.c_str());
+			GiString pattern(needle.c_str());
+			size_t offset = rand() % (text.size() + 1);
+			EXPECT_EQ(str.indexOf(pattern, offset), text.find(needle, offset));
+			EXPECT_EQ(str.lastIndexOf(pattern, offset), text.rfind(needle, offset));
+		}
+	}
+}
+
+TEST(GiStringSearch, adversarial) {
+	// 周期性文本和几乎匹配的长字符串，朴素算法需要O(n*m)次比较
+	std::string text(1 << 20, 'a');
+	std::string needle(1000, 'a');
+	needle[500] = 'b';
+	EXPECT_EQ(Search::find(text.data(), text.size(), needle.data(), needle.size()), SIZE_MAX);
+	EXPECT_EQ(Search::findLast(text.data(), text.size(), needle.data(), needle.size()), SIZE_MAX);
+
+	text.replace(text.size() - needle.size(), needle.size(), needle);
+	EXPECT_EQ(Search::find(text.data(), text.size(), needle.data(), needle.size()), text.size() - needle.size());
+	EXPECT_EQ(Search::findLast(text.data(), text.size(), needle.data(), needle.size()), text.size() - needle.size());
+
+	std::string periodic;
+	while (periodic.size() < (1 << 20)) periodic += "abaabaab";
+	std::string target = periodic.substr(3, 4000) + "x";
+	EXPECT_EQ(Search::find(periodic.data(), periodic.size(), target.data(), target.size()), SIZE_MAX);
+	EXPECT_EQ(Search::find(periodic.data(), periodic.size(), target.data(), target.size() - 1), 3u);
+	EXPECT_EQ(Search::findLast(periodic.data(), periodic.size(), target.data(), target.size() - 1), periodic.rfind(target.substr(0, 4000)));
+
+	// 高位字节
+	const char high[] = "\x80\xff\x80\xff\x81\xff\x80\xff\x80\xff\x81\xff\x80\xff\x80\xff\x81\xff\x80";
+	const char pattern[] = "\xff\x80\xff\x81\xff\x80\xff\x80\xff\x81\xff\x80\xff\x80\xff\x81\xff";
+	EXPECT_EQ(Search::find(high, sizeof(high) - 1, pattern, sizeof(pattern) - 1), 1u);
+}
+
+TEST(GiStringUnit, replace) {
+	GiString a = { "hello world, hello gikoo" };
+	EXPECT_TRUE(a.replace("hello", "bye").equals("bye world, bye gikoo"));
+	EXPECT_TRUE(a.replace("o", "").equals("hell wrld, hell gik"));
+	EXPECT_TRUE(a.replace("xyz", "abc").equals(a));
+	EXPECT_TRUE(a.replace('o', '0').equals("hell0 w0rld, hell0 gik00"));
+	EXPECT_TRUE(a.replace('x', 'y').equals(a));
+	EXPECT_TRUE(a.equals("hello world, hello gikoo"));
+
+	// 与Java一致：匹配不重叠，空字符串在每个字符前后各匹配一次
+	GiString b = { "aaaa" };
+	EXPECT_TRUE(b.replace("aa", "b").equals("bb"));
+	EXPECT_TRUE(b.replace("aaa", "b").equals("ba"));
+	EXPECT_TRUE(GiString("abc").replace("", "-").equals("-a-b-c-"));
+	EXPECT_TRUE(GiString("").replace("", "-").equals("-"));
+
+	GiString longText = { "the quick brown fox jumps over the lazy dog, the quick brown fox" };
+	EXPECT_TRUE(longText.replace("the quick brown fox", "cat").equals("cat jumps over the lazy dog, cat"));
+}
+
+TEST(GiStringUnit, inPlace) {
+	GiString a = { "  \t the quick brown fox jumps over the lazy dog \r\n" };
+	GiString b = { "\x01 hello world, hello gikoo; hello world, hello gikoo \x1f" };
+	GiString c = { "--the quick brown fox jumps over the lazy dog--" };
+	GiString shared = a;
+	a.stripInPlace();
+	size_t allocations = GiString::memoryStats().totalAllocations;
+	const char* buffer = c.c_str();
+	c.stripLeadingInPlace("-").stripTrailingInPlace("-");
+	b.trimStartInPlace().trimEndInPlace().replaceInPlace("hello", "bye").replaceInPlace('o', '0');
+	EXPECT_EQ(GiString::memoryStats().totalAllocations, allocations);
+	EXPECT_EQ(c.c_str(), buffer);
+	EXPECT_STREQ(c.c_str(), "the quick brown fox jumps over the lazy dog");
+	EXPECT_STREQ(b.c_str(), "bye w0rld, bye gik00; bye w0rld, bye gik00");
+	EXPECT_EQ(b.hashCode(), GiStringView("bye w0rld, bye gik00; bye w0rld, bye gik00").hashCode());
+
+	// 共享的缓冲区先复制，其他对象不受影响
+	EXPECT_STREQ(a.c_str(), "the quick brown fox jumps over the lazy dog");
+	EXPECT_STREQ(shared.c_str(), "  \t the quick brown fox jumps over the lazy dog \r\n");
+	GiString literal = "   x-request-identifier-header-name   "_gs;
+	EXPECT_STREQ(literal.trimInPlace().c_str(), "x-request-identifier-header-name");
+	EXPECT_STREQ(GiString(" small ").trimInPlace().c_str(), "small");
+	EXPECT_TRUE(GiString(" \t ").trimInPlace().isEmpty());
+
+	// 与replace()结果一致，包括新字符串较长和旧字符串为空的情况
+	const char* replacements[][2] = { { "aa", "b" }, { "aa", "cd" }, { "a", "xyz" }, { "", "-" }, { "q", "r" }, { "aaaa", "" } };
+	for (auto& item : replacements)
+	{
+		GiString text = { "aaaaa baaab aaaaaaaaaaaaaaaaaaaaaaaaaaaa" };
+		GiString expected = text.replace(item[0], item[1]);
+		EXPECT_TRUE(text.replaceInPlace(item[0], item[1]).equals(expected)) << item[0] << " -> " << item[1];
+	}
+	GiString self = { "abcabc" };
+	EXPECT_STREQ(self.replaceInPlace(self, "x").c_str(), "x");
+	self = "abcabc";
+	GiString copy = self;
+	EXPECT_STREQ(self.replaceInPlace("abc", copy.subString(0, 1)).c_str(), "aa");
+	EXPECT_STREQ(copy.c_str(), "abcabc");
+
+	// 临时对象直接接管缓冲区
+	GiString padded = { "   padded string longer than the local buffer   " };
+	buffer = padded.c_str();
+	GiString trimmed = std::move(padded).trim();
+	EXPECT_EQ(trimmed.c_str(), buffer);
+	EXPECT_STREQ(trimmed.c_str(), "padded string longer than the local buffer");
+	buffer = trimmed.c_str();
+	GiString replaced = std::move(trimmed).replace("string ", "").replace('l', 'L');
+	EXPECT_EQ(replaced.c_str(), buffer);
+	EXPECT_STREQ(replaced.c_str(), "padded Longer than the LocaL buffer");
+}
+
+TEST(GiStringUnit, lines) {
+	auto expectLines = [](const char* str, std::vector<const char*> expected) {
+		GiString text = { str };
+		std::vector<GiString> lines = text.lines();
+		std::vector<GiStringView> views = text.lineViews();
+		ASSERT_EQ(lines.size(), expected.size()) << str;
+		ASSERT_EQ(views.size(), expected.size()) << str;
+		for (size_t i = 0; i < lines.size(); ++i)
+		{
+			EXPECT_TRUE(lines[i].equals(expected[i])) << str << " [" << i << "]";
+			EXPECT_TRUE(views[i].equals(expected[i])) << str << " [" << i << "]";
+		}
+	};
+
+	// 与Java的String.lines()对照
+	expectLines("", {});
+	expectLines("abc", { "abc" });
+	expectLines("abc\n", { "abc" });
+	expectLines("\n", { "" });
+	expectLines("\n\n", { "", "" });
+	expectLines("\r\n\r\n", { "", "" });
+	expectLines("a\nb\r\nc\rd", { "a", "b", "c", "d" });
+	expectLines("a\r\rb", { "a", "", "b" });
+	expectLines("a\n\r\nb\n\r", { "a", "", "b", "" });
+	expectLines("\r\nx", { "", "x" });
+
+	// 跨越扫描块和批次边界的\r\n
+	std::string log;
+	std::vector<std::string> expected;
+	for (size_t i = 0; i < 600; ++i)
+	{
+		std::string line(i % 70, (char)('a' + i % 26));
+		expected.push_back(line);
+		log += line;
+		log += i % 3 == 0 ? "\r\n" : (i % 3 == 1 ? "\n" : "\r");
+	}
+	GiString text(log.c_str());
+	std::vector<GiStringView> views = text.lineViews();
+	ASSERT_EQ(views.size(), expected.size());
+	for (size_t i = 0; i < views.size(); ++i)
+	{
+		EXPECT_TRUE(views[i].equals(expected[i].c_str())) << i;
+	}
+	EXPECT_EQ(views[5].data(), text.c_str() + log.find(expected[5]));
+}
+
+TEST(GiSearcher, query) {
+	GiSearcher shortNeedle("hello");
+	GiSearcher longNeedle("the quick brown fox");
+	GiSearcher single("o");
+	GiSearcher empty("");
+
+	GiString a = { "hello world, hello gikoo" };
+	EXPECT_EQ(a.indexOf(shortNeedle), 0u);
+	EXPECT_EQ(a.indexOf(shortNeedle, 1), 13u);
+	EXPECT_EQ(a.lastIndexOf(shortNeedle), 13u);
+	EXPECT_EQ(a.lastIndexOf(shortNeedle, 12), 0u);
+	EXPECT_EQ(a.indexOf(single, 5), 7u);
+	EXPECT_EQ(a.lastIndexOf(single), 23u);
+	EXPECT_EQ(a.indexOf(empty, 3), 3u);
+	EXPECT_EQ(a.lastIndexOf(empty), a.length());
+	EXPECT_TRUE(a.contains(shortNeedle));
+	EXPECT_FALSE(a.contains(longNeedle));
+
+	GiString b = { "a fox, the quick brown fox jumps over the quick brown fox" };
+	EXPECT_EQ(b.indexOf(longNeedle), 7u);
+	EXPECT_EQ(b.lastIndexOf(longNeedle), b.lastIndexOf(GiString("the quick brown fox")));
+	EXPECT_EQ(longNeedle.length(), 19u);
+	EXPECT_TRUE(longNeedle.pattern() == "the quick brown fox");
+
+	// 拷贝共享预处理结果，可以在多个线程中同时使用
+	GiSearcher copied = longNeedle;
+	std::vector<std::thread> threads;
+	std::atomic<size_t> hits(0);
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&]() {
+			for (int i = 0; i < 1000; ++i)
+			{
+				if (copied.indexOf(b.view()) == 7 && longNeedle.contains(b.view())) ++hits;
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+	EXPECT_EQ(hits.load(), 4000u);
+}
+
+TEST(GiSearcher, splitReplace) {
+	GiSearcher comma(",");
+	std::vector<GiString> parts = GiString("a,b,,c,,").split(comma);
+	ASSERT_EQ(parts.size(), 4u);
+	EXPECT_TRUE(parts[0].equals("a"));
+	EXPECT_TRUE(parts[1].equals("b"));
+	EXPECT_TRUE(parts[2].isEmpty());
+	EXPECT_TRUE(parts[3].equals("c"));
+
+	EXPECT_EQ(GiString(",a").split(comma).size(), 2u);
+	EXPECT_EQ(GiString(",,,").split(comma).size(), 0u);
+	ASSERT_EQ(GiString("").split(comma).size(), 1u);
+	ASSERT_EQ(GiString("abc").split(comma).size(), 1u);
+	EXPECT_TRUE(GiString("abc").split(comma)[0].equals("abc"));
+
+	std::vector<GiString> chars = GiString("abc").split(GiSearcher(""));
+	ASSERT_EQ(chars.size(), 3u);
+	EXPECT_TRUE(chars[2].equals("c"));
+
+	GiSearcher separator(" :: ");
+	std::vector<GiString> fields = GiString("key :: value :: ").split(separator);
+	ASSERT_EQ(fields.size(), 2u);
+	EXPECT_TRUE(fields[1].equals("value"));
+
+	GiSearcher word("hello");
+	GiString a = { "hello world, hello gikoo" };
+	EXPECT_TRUE(a.replace(word, "bye").equals("bye world, bye gikoo"));
+	EXPECT_TRUE(GiString("nothing").replace(word, "bye").equals("nothing"));
+	EXPECT_TRUE(GiString("ab").replace(GiSearcher(""), "-").equals("-a-b-"));
+	EXPECT_TRUE(GiString("aaaa").replace(GiSearcher("aa"), "b").equals("bb"));
+}
+
+TEST(GiMultiMatcher, findAll) {
+	std::vector<GiString> patterns = { "he", "she", "his", "hers", "", "he" };
+	for (auto layout : { GiMultiMatcher::LAYOUT_DENSE, GiMultiMatcher::LAYOUT_COMPACT })
+	{
+		GiMultiMatcher matcher(patterns, layout);
+		EXPECT_EQ(matcher.layout(), layout);
+		EXPECT_EQ(matcher.patternCount(), 6u);
+
+		// 重复的模式各自报告，空字符串不匹配。结束位置相同时较长的模式在前
+		std::vector<GiMatch> matches = matcher.findAll("ushers");
+		ASSERT_EQ(matches.size(), 4u);
+		EXPECT_EQ(matches[0].pattern, 1u);
+		EXPECT_EQ(matches[0].offset, 1u);
+		EXPECT_EQ(matches[1].pattern, 0u);
+		EXPECT_EQ(matches[1].offset, 2u);
+		EXPECT_EQ(matches[2].pattern, 5u);
+		EXPECT_EQ(matches[2].offset, 2u);
+		EXPECT_EQ(matches[3].pattern, 3u);
+		EXPECT_EQ(matches[3].offset, 2u);
+
+		EXPECT_TRUE(matcher.containsAny("this"));
+		EXPECT_FALSE(matcher.containsAny("a blue sky"));
+		EXPECT_TRUE(matcher.findAll("").empty());
+	}
+}
+
+TEST(GiMultiMatcher, matchesBruteForce) {
+	// 小字母表的随机模式之间有大量公共前后缀，与逐个查找的结果对比
+	srand(1013);
+	for (int round = 0; round < 50; ++round)
+	{
+		std::vector<GiString> patterns;
+		std::vector<std::string> raw;
+		size_t count = 1 + rand() % 40;
+		for (size_t i = 0; i < count; ++i)
+		{
+			std::string pattern(1 + rand() % 6, 'a');
+			for (auto& ch : pattern) ch = (char)('a' + rand() % 3);
+			raw.push_back(pattern);
+			patterns.push_back(GiString(pattern.c_str()));
+		}
+		std::string text(rand() % 200, 'a');
+		for (auto& ch : text) ch = (char)('a' + rand() % 4);
+
+		std::vector<std::pair<size_t, size_t>> expected;
+		for (size_t id = 0; id < raw.size(); ++id)
+		{
+			for (size_t pos = text.find(raw[id]); pos != std::string::npos; pos = text.find(raw[id], pos + 1))
+			{
+				expected.push_back(std::make_pair(pos + raw[id].size(), id));
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+
+		for (auto layout : { GiMultiMatcher::LAYOUT_DENSE, GiMultiMatcher::LAYOUT_COMPACT })
+		{
+			GiMultiMatcher matcher(patterns, layout);
+			std::vector<std::pair<size_t, size_t>> actual;
+			for (const GiMatch& match : matcher.findAll(GiStringView(text.c_str(), text.size())))
+			{
+				actual.push_back(std::make_pair(match.offset + raw[match.pattern].size(), match.pattern));
+			}
+			std::sort(actual.begin(), actual.end());
+			EXPECT_EQ(actual, expected);
+			EXPECT_EQ(matcher.containsAny(GiStringView(text.c_str(), text.size())), !expected.empty());
+		}
+	}
+}
+
+TEST(GiMultiMatcher, compactLayout) {
+	std::vector<GiString> patterns;
+	for (int i = 0; i < 5000; ++i)
+	{
+		patterns.push_back(GiString(("term" + std::to_string(i * 7919) + "_x").c_str()));
+	}
+
+	GiMultiMatcher dense(patterns, GiMultiMatcher::LAYOUT_DENSE);
+	GiMultiMatcher compact(patterns, GiMultiMatcher::LAYOUT_COMPACT);
+	GiMultiMatcher automatic(patterns);
+	EXPECT_EQ(automatic.layout(), GiMultiMatcher::LAYOUT_COMPACT);
+	EXPECT_LT(compact.memoryBytes() * 2, dense.memoryBytes());
+	EXPECT_EQ(dense.stateCount(), compact.stateCount());
+
+	GiString text = { "prefix term15838_x and term7919_x, term0_xterm39595_x" };
+	std::vector<GiMatch> expected = dense.findAll(text);
+	std::vector<GiMatch> actual = compact.findAll(text);
+	ASSERT_EQ(expected.size(), 4u);
+	ASSERT_EQ(actual.size(), 4u);
+	for (size_t i = 0; i < actual.size(); ++i)
+	{
+		EXPECT_EQ(actual[i].pattern, expected[i].pattern);
+		EXPECT_EQ(actual[i].offset, expected[i].offset);
+	}
+	EXPECT_EQ(actual[0].pattern, 2u);
+	EXPECT_EQ(actual[0].offset, 7u);
+}
+
+TEST(GiRegex, matches) {
+	EXPECT_TRUE(GiString("abc").matches("abc"));
+	EXPECT_FALSE(GiString("abcd").matches("abc"));
+	EXPECT_TRUE(GiString("aaa").matches("a*"));
+	EXPECT_TRUE(GiString("").matches("a*"));
+	EXPECT_TRUE(GiString("2024-10-17").matches("\\d{4}-\\d{2}-\\d{2}"));
+	EXPECT_FALSE(GiString("2024-1-17").matches("\\d{4}-\\d{2}-\\d{2}"));
+	EXPECT_TRUE(GiString("foo.bar@example.com").matches("[\\w.]+@[a-z]+\\.(com|org)"));
+	EXPECT_FALSE(GiString("foo@example.net").matches("[\\w.]+@[a-z]+\\.(com|org)"));
+	EXPECT_TRUE(GiString("ab12").matches("[a-c[0-9]]+"));
+	EXPECT_TRUE(GiString("x y").matches("x\\sy"));
+	EXPECT_TRUE(GiString("a.b").matches("a\\.b"));
+	EXPECT_FALSE(GiString("axb").matches("a\\.b"));
+	EXPECT_TRUE(GiString("a+b").matches("\\Qa+b\\E"));
+	EXPECT_TRUE(GiString("abab").matches("(?:ab){2}"));
+	EXPECT_FALSE(GiString("ababab").matches("(?:ab){1,2}"));
+	EXPECT_TRUE(GiString("\xe4\xb8\xad\xe4\xb8\xad").matches("\\u4e2d+"));
+	EXPECT_FALSE(GiString("a\nb").matches("a.b"));
+	EXPECT_TRUE(GiString("[]").matches("[\\[]\\]"));
+
+	// 边界
+	EXPECT_TRUE(GiString("abc").matches("^abc$"));
+	EXPECT_FALSE(GiString("abc\n").matches("abc$"));
+	EXPECT_TRUE(GiString("abc\n").matches("abc$\n"));
+	EXPECT_TRUE(GiString("one two").matches("\\w+\\b \\btwo"));
+	EXPECT_FALSE(GiString("onetwo").matches("one\\btwo"));
+
+	// 不支持或错误的语法
+	const char* invalid[] = { "(", "a)", "[a", "*a", "a{2,1}", "(?=a)", "\\1", "a++", "[a&&b]", "\\k", "[]" };
+	for (const char* pattern : invalid)
+	{
+		GiRegex regex(pattern);
+		EXPECT_FALSE(regex.isValid()) << pattern;
+		EXPECT_NE(regex.error(), nullptr);
+		EXPECT_FALSE(GiString("a").matches(pattern));
+	}
+	EXPECT_TRUE(GiRegex("a{2,}").isValid());
+	EXPECT_EQ(GiRegex("a").error(), nullptr);
+}
+
+TEST(GiRegex, find) {
+	GiRegex regex("a+?b|a+");
+	size_t start;
+	size_t end;
+	ASSERT_TRUE(regex.find("xxaaab", 0, start, end));
+	EXPECT_EQ(start, 2u);
+	EXPECT_EQ(end, 6u);
+
+	// 最左优先: 选择分支按顺序，贪婪和非贪婪量词
+	ASSERT_TRUE(GiRegex("a|ab").find("ab", 0, start, end));
+	EXPECT_EQ(end, 1u);
+	ASSERT_TRUE(GiRegex("a+").find("baaa", 0, start, end));
+	EXPECT_EQ(start, 1u);
+	EXPECT_EQ(end, 4u);
+	ASSERT_TRUE(GiRegex("a+?").find("baaa", 0, start, end));
+	EXPECT_EQ(end, 2u);
+	ASSERT_TRUE(GiRegex("\\bcat\\b").find("concat cat", 0, start, end));
+	EXPECT_EQ(start, 7u);
+	EXPECT_FALSE(GiRegex("^b").find("ab", 1, start, end));
+	EXPECT_FALSE(GiRegex("x").find("ab", 0, start, end));
+
+	// 指数级回溯的表达式保持线性时间
+	std::string text(100000, 'a');
+	EXPECT_FALSE(GiRegex("(a*)*b").find(GiStringView(text.c_str(), text.size()), 0, start, end));
+	EXPECT_FALSE(GiRegex("(a|aa)*c").matches(GiStringView(text.c_str(), text.size())));
+	EXPECT_TRUE(GiRegex("(a|aa)*").matches(GiStringView(text.c_str(), text.size())));
+}
+
+TEST(GiRegex, split) {
+	auto expectSplit = [](const char* str, const char* regex, int limit, std::vector<const char*> expected) {
+		std::vector<GiString> parts = GiString(str).split(GiString(regex), limit);
+		ASSERT_EQ(parts.size(), expected.size()) << str << " / " << regex << " / " << limit;
+		for (size_t i = 0; i < parts.size(); ++i)
+		{
+			EXPECT_TRUE(parts[i].equals(expected[i])) << str << " / " << regex << " [" << i << "]";
+		}
+	};
+
+	// 与Java的String.split()对照
+	expectSplit("boo:and:foo", ":", 2, { "boo", "and:foo" });
+	expectSplit("boo:and:foo", ":", 5, { "boo", "and", "foo" });
+	expectSplit("boo:and:foo", ":", -2, { "boo", "and", "foo" });
+	expectSplit("boo:and:foo", "o", 5, { "b", "", ":and:f", "", "" });
+	expectSplit("boo:and:foo", "o", -2, { "b", "", ":and:f", "", "" });
+	expectSplit("boo:and:foo", "o", 0, { "b", "", ":and:f" });
+	expectSplit("a1b22c333", "\\d+", 0, { "a", "b", "c" });
+	expectSplit("  leading spaces", "\\s+", 0, { "", "leading", "spaces" });
+	expectSplit("abc", "", 0, { "a", "b", "c" });
+	expectSplit("abc", "x*", 0, { "a", "b", "c" });
+	expectSplit("", ",", 0, { "" });
+	expectSplit(",,,", ",", 0, {});
+	expectSplit("abc", "abc", 0, {});
+	expectSplit("no match", ",", 0, { "no match" });
+	expectSplit("a,b", ",", 1, { "a,b" });
+	expectSplit("a,b", "(", 0, { "a,b" });
+}
+
+TEST(GiRegex, cache) {
+	GiRegex::clearCache();
+	GiRegex::setCacheCapacity(2);
+
+	GiString str = { "hello" };
+	EXPECT_TRUE(str.matches("h.*o"));
+	EXPECT_TRUE(str.matches("h.*o"));
+	EXPECT_TRUE(str.matches("h.*o"));
+	GiRegexCacheStats stats = GiRegex::cacheStats();
+	EXPECT_EQ(stats.misses, 1u);
+	EXPECT_EQ(stats.hits, 2u);
+	EXPECT_EQ(stats.size, 1u);
+
+	// 容量为2，最久未使用的"h.*o"被淘汰
+	EXPECT_TRUE(str.matches("hel+o"));
+	EXPECT_TRUE(str.matches("hel+o"));
+	EXPECT_FALSE(str.matches("x"));
+	EXPECT_EQ(GiRegex::cacheStats().size, 2u);
+	EXPECT_TRUE(str.matches("hel+o"));
+	EXPECT_EQ(GiRegex::cacheStats().misses, 3u);
+	EXPECT_TRUE(str.matches("h.*o"));
+	EXPECT_EQ(GiRegex::cacheStats().misses, 4u);
+
+	GiRegex a = GiRegex::cached("h.*o");
+	EXPECT_EQ(a.pattern().data(), GiRegex::cached("h.*o").pattern().data());
+
+	// 首次编译发生在arena作用域内，arena释放后缓存仍然可用
+	GiRegex::clearCache();
+	{
+		GiArenaAllocator arena;
+		GiAllocatorScope scope(&arena);
+		EXPECT_TRUE(str.matches("(hello|world) pattern long enough to leave the local buffer|hel+o"));
+		EXPECT_FALSE(str.matches("a literal pattern long enough to leave the local buffer"));
+	}
+	EXPECT_TRUE(str.matches("(hello|world) pattern long enough to leave the local buffer|hel+o"));
+	EXPECT_FALSE(str.matches("a literal pattern long enough to leave the local buffer"));
+	EXPECT_EQ(GiRegex::cacheStats().hits, 2u);
+
+	GiRegex::setCacheCapacity(GI_STRING_REGEX_CACHE_CAPACITY);
+	GiRegex::clearCache();
+}
+
+TEST(GiRegex, dfaMatchesPikeVm) {
+	// 以\A开头的表达式使用Pike VM，其余使用惰性DFA，两者结果必须相同
+	const char* patterns[] = { "(a|b)*abb", "a*b*a*", "(ab|a)(bc|c)", "[a-c]{2,4}b?", "(a+?b)+|c*", "a(b|)c*", ".*b.*" };
+	srand(1014);
+	for (const char* pattern : patterns)
+	{
+		GiRegex dfa(pattern);
+		GiRegex pike((std::string("\\A(?:") + pattern + ")").c_str());
+		for (int i = 0; i < 300; ++i)
+		{
+			std::string text(rand() % 8, 'a');
+			for (auto& ch : text) ch = (char)('a' + rand() % 3);
+			GiStringView view(text.c_str(), text.size());
+			EXPECT_EQ(dfa.matches(view), pike.matches(view)) << pattern << " / " << text;
+		}
+	}
+
+	// 多个线程同时使用同一个编译结果，DFA缓存被占用时改用Pike VM
+	GiRegex shared("([a-z]+\\.)*[a-z]+@[a-z]+\\.com");
+	std::atomic<size_t> hits(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&]() {
+			for (int i = 0; i < 2000; ++i)
+			{
+				if (shared.matches("first.last@example.com") && !shared.matches("first.last@example.org")) ++hits;
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+	EXPECT_EQ(hits.load(), 8000u);
+}
+
+TEST(GiRegex, literalFastPath) {
+	const char* literals[] = { ",", "abc", "\\.", "a\\|b", "\\t", "::", "x]y}" };
+	for (const char* pattern : literals)
+	{
+		EXPECT_TRUE(GiRegex(pattern).isLiteral()) << pattern;
+	}
+	const char* regexes[] = { "a.b", "\\d", "a+", "", "[,]", "\\x2c", "\\1" };
+	for (const char* pattern : regexes)
+	{
+		EXPECT_FALSE(GiRegex(pattern).isLiteral()) << pattern;
+	}
+
+	// 单个字符的分隔符不经过正则缓存
+	GiRegex::clearCache();
+	GiString csv = { "name,age,,city,," };
+	std::vector<GiString> fast = csv.split(",");
+	std::vector<GiString> tabs = GiString("a\tb\t\tc").split("\\t");
+	EXPECT_EQ(GiRegex::cacheStats().misses, 0u);
+
+	std::vector<GiString> slow = csv.split(GiRegex("[,]"));
+	ASSERT_EQ(fast.size(), 4u);
+	ASSERT_EQ(slow.size(), fast.size());
+	for (size_t i = 0; i < fast.size(); ++i)
+	{
+		EXPECT_TRUE(fast[i].equals(slow[i]));
+	}
+	EXPECT_TRUE(fast[3].equals("city"));
+	ASSERT_EQ(tabs.size(), 4u);
+	EXPECT_TRUE(tabs[2].isEmpty());
+	EXPECT_EQ(csv.split(",", 2).size(), 2u);
+	EXPECT_TRUE(csv.split(",", 2)[1].equals("age,,city,,"));
+	EXPECT_EQ(csv.split(",", -1).size(), 6u);
+
+	// 多个字符的普通字符串和转义字符走GiSearcher，结果与Java一致
+	std::vector<GiString> words = GiString("a::b::::c").split("::");
+	ASSERT_EQ(words.size(), 4u);
+	EXPECT_TRUE(words[2].isEmpty());
+	std::vector<GiString> dots = GiString("1.2.3").split("\\.");
+	ASSERT_EQ(dots.size(), 3u);
+	EXPECT_TRUE(dots[2].equals("3"));
+	EXPECT_TRUE(GiString("a|b").matches("a\\|b"));
+	EXPECT_FALSE(GiString("a|bc").matches("a\\|b"));
+	GiRegex::clearCache();
+}
+
+TEST(GiSplitRange, matchesSplit) {
+	// 惰性拆分的结果必须与split()逐项相同，包括limit和末尾空字符串的处理
+	const char* inputs[] = { "", ",", ",,,", "a", "a,b", ",a,,b,,", "boo:and:foo", "a::b::::c::", "::a", "  x  y  " };
+	const char* regexes[] = { ",", "o", "::", ":", "\\s+", "x*", "", "[,:]" };
+	const int limits[] = { -1, 0, 1, 2, 3, 10 };
+	for (const char* input : inputs)
+	{
+		GiString str = { input };
+		for (const char* regex : regexes)
+		{
+			for (int limit : limits)
+			{
+				std::vector<GiString> expected = str.split(GiString(regex), limit);
+				std::vector<GiStringView> actual;
+				for (GiStringView token : str.splitViews(GiString(regex), limit))
+				{
+					actual.push_back(token);
+				}
+				ASSERT_EQ(actual.size(), expected.size()) << input << " / " << regex << " / " << limit;
+				for (size_t i = 0; i < actual.size(); ++i)
+				{
+					EXPECT_TRUE(actual[i].equals(expected[i].view())) << input << " / " << regex << " / " << limit << " [" << i << "]";
+				}
+			}
+		}
+
+		GiSearcher separator(GiStringView("::"));
+		std::vector<GiString> expected = str.split(separator);
+		size_t count = 0;
+		for (GiStringView token : str.splitViews(separator))
+		{
+			ASSERT_LT(count, expected.size());
+			EXPECT_TRUE(token.equals(expected[count++].view()));
+		}
+		EXPECT_EQ(count, expected.size()) << input;
+	}
+}
+
+TEST(GiSplitRange, lazy) {
+	GiString line = { "2024-01-01,GET,/index.html,200,5120,,," };
+
+	// 单个字符的分隔符全程不申请内存，子串指向原缓冲区
+	size_t before = s_newCount;
+	size_t fields = 0;
+	GiStringView status;
+	for (GiStringView field : GiSplitRange(line.view(), ',', 0))
+	{
+		if (fields == 3) status = field;
+		++fields;
+	}
+	EXPECT_EQ(s_newCount - before, 0u);
+	EXPECT_EQ(fields, 5u);
+	EXPECT_TRUE(status.equals("200"));
+	EXPECT_EQ(status.data(), line.c_str() + 27);
+
+	// 中途停止后不再查找剩余部分
+	before = s_newCount;
+	GiSplitRange range = line.splitViews(",");
+	GiSplitRange::Iterator it = range.begin();
+	GiStringView first = *it;
+	++it;
+	GiStringView second = *it++;
+	size_t allocated = s_newCount - before;
+	EXPECT_EQ(allocated, 0u);
+	EXPECT_TRUE(first.equals("2024-01-01"));
+	EXPECT_TRUE(second.equals("GET"));
+	EXPECT_TRUE(it->equals("/index.html"));
+	EXPECT_TRUE(it != range.end());
+
+	// 保留末尾空字符串
+	fields = 0;
+	for (GiStringView field : line.splitViews(",", -1))
+	{
+		(void)field;
+		++fields;
+	}
+	EXPECT_EQ(fields, 8u);
+
+	// 表达式的编译结果由拆分范围持有，调用者的临时字符串可以立即释放
+	GiString text = { "a1b22c333" };
+	GiSplitRange digits = text.splitViews(GiString("\\d+"));
+	GiRegex::clearCache();
+	std::vector<GiStringView> parts(digits.begin(), digits.end());
+	ASSERT_EQ(parts.size(), 3u);
+	EXPECT_TRUE(parts[2].equals("c"));
+	GiRegex::clearCache();
+}
+
+TEST(GiStringParallel, threadPool) {
+	Parallel::ThreadPool pool(4);
+	EXPECT_EQ(pool.concurrency(), 4u);
+
+	// 每个任务恰好执行一次，多个线程同时提交也不互相影响
+	std::vector<std::atomic<int>> hits(1000);
+	auto submit = [&]() {
+		pool.run(hits.size(), [&](size_t i) { ++hits[i]; });
+	};
+	std::thread other(submit);
+	submit();
+	other.join();
+	for (auto& hit : hits)
+	{
+		EXPECT_EQ(hit.load(), 2);
+	}
+	pool.run(0, [&](size_t) { FAIL(); });
+}
+
+TEST(GiStringParallel, matchesSerial) {
+	Parallel::ThreadPool pool(4);
+
+	// 行结束符和自身重叠的分隔符落在块边界上时，结果与串行版本相同
+	std::string text;
+	srand(18);
+	while (text.size() < (1 << 20))
+	{
+		int r = rand() % 8;
+		text += r == 0 ? "\r\n" : (r == 1 ? "\r" : (r == 2 ? "\n" : (r == 3 ? "aaa" : "xyz")));
+	}
+	std::string crlf(1 + (1 << 20), '\n');
+	for (size_t i = 1; i < crlf.size(); i += 2)
+	{
+		crlf[i - 1] = '\r';
+	}
+	std::string runs(1 << 20, 'a');
+	for (size_t i = 0; i < runs.size(); i += 1 + rand() % 300)
+	{
+		runs[i] = ',';
+	}
+
+	for (const std::string* input : { &text, &crlf, &runs })
+	{
+		GiStringView str(input->c_str(), input->size());
+		std::vector<GiStringView> serial;
+		Split::lines(str, [&](size_t start, size_t length) { serial.push_back(str.subString(start, length)); });
+		std::vector<GiStringView> parallel;
+		Parallel::lines(str, parallel, [&](size_t start, size_t length) { return str.subString(start, length); }, pool);
+		ASSERT_EQ(parallel.size(), serial.size());
+		for (size_t i = 0; i < serial.size(); ++i)
+		{
+			ASSERT_EQ(parallel[i].data(), serial[i].data()) << i;
+			ASSERT_EQ(parallel[i].length(), serial[i].length()) << i;
+		}
+
+		for (const char* separator : { "aa", "a", ",", "\r\n", "\n\r", "zz" })
+		{
+			GiSearcher searcher((GiStringView(separator)));
+			for (int limit : { 0, -1 })
+			{
+				std::vector<GiStringView> expected;
+				for (GiStringView token : GiSplitRange(str, searcher, limit))
+				{
+					expected.push_back(token);
+				}
+				std::vector<GiStringView> actual;
+				bool matched = Parallel::split(str, searcher.length(), limit, [&](const GiStringView& window, size_t offset) {
+					return searcher.indexOf(window, offset);
+				}, actual, [&](size_t start, size_t length) { return str.subString(start, length); }, pool);
+				if (!matched) actual.push_back(str);
+				ASSERT_EQ(actual.size(), expected.size()) << separator << " / " << limit;
+				for (size_t i = 0; i < expected.size(); ++i)
+				{
+					ASSERT_EQ(actual[i].data(), expected[i].data()) << separator << " [" << i << "]";
+					ASSERT_EQ(actual[i].length(), expected[i].length()) << separator << " [" << i << "]";
+				}
+			}
+		}
+	}
+}
+
+TEST(GiStringParallel, threshold) {
+	size_t previous = GiString::parallelThreshold();
+	EXPECT_EQ(previous, (size_t)GI_STRING_PARALLEL_THRESHOLD);
+
+	std::string text;
+	for (size_t i = 0; i < 100000; ++i)
+	{
+		text += std::to_string(i) + (i % 5 ? "," : "\r\n");
+	}
+	GiString str(text.c_str());
+	GiString::setParallelThreshold(SIZE_MAX);
+	std::vector<GiString> serialLines = str.lines();
+	std::vector<GiString> serialFields = str.split(",");
+	std::vector<GiString> serialWords = str.split("\r\n");
+
+	GiString::setParallelThreshold(0);
+	EXPECT_EQ(GiString::parallelThreshold(), 0u);
+	std::vector<GiString> lines = str.lines();
+	std::vector<GiStringView> views = str.lineViews();
+	std::vector<GiString> fields = str.split(",");
+	std::vector<GiString> words = str.split("\r\n");
+	GiString::setParallelThreshold(previous);
+
+	ASSERT_EQ(lines.size(), serialLines.size());
+	ASSERT_EQ(views.size(), serialLines.size());
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		EXPECT_TRUE(lines[i].equals(serialLines[i]));
+		EXPECT_TRUE(views[i].equals(serialLines[i].view()));
+	}
+	ASSERT_EQ(fields.size(), serialFields.size());
+	for (size_t i = 0; i < fields.size(); ++i)
+	{
+		EXPECT_TRUE(fields[i].equals(serialFields[i]));
+	}
+	ASSERT_EQ(words.size(), serialWords.size());
+	EXPECT_TRUE(words.back().equals(serialWords.back()));
+}
+
+TEST(GiStringHash, vectors) {
+	// wyhash的官方测试向量，种子依次为0~6
+	const char* messages[] = { "", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz",
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+		"12345678901234567890123456789012345678901234567890123456789012345678901234567890" };
+	const uint64_t expected[] = { 0x93228a4de0eec5a2ull, 0xc5bac3db178713c4ull, 0xa97f2f7b1d9b3314ull, 0x786d1f1df3801df4ull,
+		0xdca5a8138ad37c87ull, 0xb9e734f117cfaf70ull, 0x6cc5eab49a92d617ull };
+	for (size_t i = 0; i < 7; ++i)
+	{
+		EXPECT_EQ(Hash::hash(messages[i], strlen(messages[i]), i), expected[i]) << i;
+	}
+
+	// 各种长度下没有冲突，GiString与GiStringView一致
+	std::unordered_set<size_t> seen;
+	std::string text;
+	for (size_t i = 0; i < 200; ++i)
+	{
+		GiString str(text.c_str());
+		EXPECT_EQ(str.hashCode(), str.view().hashCode());
+		EXPECT_TRUE(seen.insert(str.hashCode()).second) << i;
+		text += (char)('a' + i % 26);
+	}
+}
+
+TEST(GiStringHash, cached) {
+	GiString str = { "a string long enough to live on the heap" };
+	size_t hash = str.hashCode();
+	EXPECT_EQ(str.hashCode(), hash);
+
+	// 拷贝和移动带走已计算的数值
+	GiString copied = str;
+	EXPECT_EQ(copied.hashCode(), hash);
+	GiString moved = std::move(copied);
+	EXPECT_EQ(moved.hashCode(), hash);
+	EXPECT_EQ(copied.hashCode(), GiString().hashCode());
+
+	// 修改后重新计算
+	moved[0] = 'A';
+	EXPECT_NE(moved.hashCode(), hash);
+	EXPECT_EQ(moved.hashCode(), moved.view().hashCode());
+	EXPECT_EQ(str.hashCode(), hash);
+	moved = "short";
+	EXPECT_EQ(moved.hashCode(), GiStringView("short").hashCode());
+	moved.copy("another value");
+	EXPECT_EQ(moved.hashCode(), GiStringView("another value").hashCode());
+	moved.empty();
+	EXPECT_EQ(moved.hashCode(), GiStringView("").hashCode());
+}
+
+TEST(GiStringHash, staleReference) {
+	// 通过之前取得的引用写入后缓存过期，相等判断仍以内容为准
+	GiString a = { "hello" };
+	char& first = a[0];
+	a.hashCode();
+	first = 'j';
+	GiString b = { "jello" };
+	b.hashCode();
+	EXPECT_TRUE(a.equals(b));
+	EXPECT_TRUE(a == b);
+	EXPECT_FALSE(a != b);
+	EXPECT_EQ(a.compareTo(b), 0);
+
+	GiString longer = { "a string long enough to live on the heap" };
+	char& last = longer[longer.length() - 1];
+	longer.hashCode();
+	last = 'P';
+	EXPECT_TRUE(longer == "a string long enough to live on the heaP"_gs);
+	GiString expected = { "a string long enough to live on the heaP" };
+	expected.hashCode();
+	EXPECT_TRUE(longer.equals(expected));
+}
+
+TEST(GiStringHash, unorderedMap) {
+	std::unordered_map<GiString, int> counts;
+	for (int i = 0; i < 1000; ++i)
+	{
+		++counts[GiString(std::to_string(i % 100).c_str())];
+	}
+	ASSERT_EQ(counts.size(), 100u);
+	EXPECT_EQ(counts[GiString("42")], 10);
+	EXPECT_EQ(std::hash<GiString>()(GiString("42")), std::hash<GiStringView>()(GiStringView("42")));
+}
+
+TEST(GiStringIntern, canonical) {
+	GiString a = { "status" };
+	GiString b(GiStringView("status_code").subString(0, 6));
+	EXPECT_FALSE(a.isInterned());
+
+	// 短字符串驻留后同样共享一块堆缓冲区
+	GiString ia = a.intern();
+	GiString ib = b.intern();
+	EXPECT_TRUE(ia.isInterned());
+	EXPECT_EQ(ia.c_str(), ib.c_str());
+	EXPECT_EQ(ia.intern().c_str(), ia.c_str());
+	EXPECT_EQ(ia, a);
+	EXPECT_EQ(ia.hashCode(), a.hashCode());
+
+	// 驻留字符串之间按地址比较，与普通字符串之间仍按内容比较
+	GiString other = GiString("statut").intern();
+	EXPECT_NE(ia, other);
+	EXPECT_EQ(ib, a);
+	EXPECT_EQ(GiString().intern(), GiString());
+
+	// 拷贝共享缓冲区，修改时复制，池中的实例不受影响
+	GiString copied = ia;
+	EXPECT_EQ(copied.c_str(), ia.c_str());
+	copied[0] = 'S';
+	EXPECT_FALSE(copied.isInterned());
+	EXPECT_STREQ(copied.c_str(), "Status");
+	EXPECT_STREQ(a.intern().c_str(), "status");
+	EXPECT_EQ(a.intern().c_str(), ia.c_str());
+}
+
+TEST(GiStringIntern, concurrent) {
+	const int threadCount = 4;
+	const int vocabulary = 500;
+	std::vector<std::vector<GiString>> results(threadCount, std::vector<GiString>(vocabulary));
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&results, t]() {
+			for (int round = 0; round < 4; ++round)
+			{
+				for (int i = 0; i < vocabulary; ++i)
+				{
+					int id = (i * 7 + t * 13) % vocabulary;
+					GiString str = GiString(("field_" + std::to_string(id)).c_str()).intern();
+					if (round == 0) results[t][id] = str;
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	// 每个线程得到的规范实例相同
+	for (int i = 0; i < vocabulary; ++i)
+	{
+		GiString expected = GiString(("field_" + std::to_string(i)).c_str()).intern();
+		for (int t = 0; t < threadCount; ++t)
+		{
+			const GiString& str = results[t][i];
+			ASSERT_EQ(str, expected);
+			EXPECT_EQ(str.c_str(), expected.c_str());
+		}
+	}
+}
+
+TEST(GiStringIntern, purge) {
+	const GI_STRING_DATA_TYPE* address = nullptr;
+	size_t entries = 0;
+	{
+		GiString str = GiString("interned only for this test").intern();
+		address = str.c_str();
+		entries = GiString::internStats().entries;
+		EXPECT_GT(GiString::internStats().bytes, 0u);
+
+		// 仍被引用的字符串保留在池中
+		GiString::purgeInterned();
+		EXPECT_EQ(GiString("interned only for this test").intern().c_str(), address);
+	}
+
+	EXPECT_GE(GiString::purgeInterned(), 1u);
+	EXPECT_LT(GiString::internStats().entries, entries);
+	GiString again = GiString("interned only for this test").intern();
+	EXPECT_TRUE(again.isInterned());
+	EXPECT_STREQ(again.c_str(), "interned only for this test");
+}
+
+TEST(GiStringConstexpr, matchesRuntime) {
+	// 编译期求值，与wyhash的官方测试向量一致
+	static_assert(Constexpr::hash("message digest", 14, 3) == 0x786d1f1df3801df4ull, "");
+	static_assert(Constexpr::hash("12345678901234567890123456789012345678901234567890123456789012345678901234567890", 80, 6) == 0x6cc5eab49a92d617ull, "");
+	static_assert(Constexpr::length("status") == 6, "");
+	static_assert(Constexpr::find("content-type", 12, "type", 4) == 8, "");
+	static_assert(Constexpr::find("content-type", 12, "", 0) == 0, "");
+	static_assert(Constexpr::findChar("content-type", 12, 'x') == SIZE_MAX, "");
+
+	// 访问器总是constexpr
+	constexpr GiStringView key("status_code", 6);
+	static_assert(key.length() == 6 && key.charAt(1) == 't' && key.charAt(6) == 0 && !key.isEmpty(), "");
+
+	// 各种长度和种子下与运行期实现一致
+	std::string text;
+	for (size_t i = 0; i < 200; ++i)
+	{
+		for (uint64_t seed = 0; seed < 3; ++seed)
+		{
+			EXPECT_EQ(Constexpr::hash(text.c_str(), i, seed), Hash::hash(text.c_str(), i, seed)) << i;
+		}
+		text += (char)(i * 37 + 11);
+	}
+
+	const char* haystack = "abcabcabdabcabdd";
+	const char* needles[] = { "", "a", "abd", "abdd", "dd", "abcabdd", "x", "abcabcabdabcabddd" };
+	for (const char* needle : needles)
+	{
+		EXPECT_EQ(Constexpr::find(haystack, strlen(haystack), needle, strlen(needle)),
+			Search::find(haystack, strlen(haystack), needle, strlen(needle))) << needle;
+	}
+}
+
+#if GI_STATIC_STRING_HASH
+namespace
+{
+	int headerId(const GiString& name)
+	{
+		// 运行期的hashCode()与编译期求得的数值一致
+		switch (name.hashCode())
+		{
+		case "content-type"_gs.hashCode(): return name == "content-type"_gs ? 1 : 0;
+		case "content-length"_gs.hashCode(): return name == "content-length"_gs ? 2 : 0;
+		default: return 0;
+		}
+	}
+}
+#endif
+
+TEST(GiStaticString, compileTime) {
+	constexpr GiStaticString key = "content-type"_gs;
+	static_assert(key.length() == 12, "");
+#if !GI_STATIC_STRING_HASH
+	// 编译期无法得知随机种子，或者编译期实现与运行时的字节序不一致
+	static_assert(key.hashCode() == 0, "");
+#else
+	static_assert(key.hashCode() == (size_t)Constexpr::hash("content-type", 12, GI_STRING_HASH_SEED), "");
+	static_assert(GiStaticString("content-type").hashCode() == key.hashCode(), "");
+
+	EXPECT_EQ(key.hashCode(), GiString("content-type").hashCode());
+	EXPECT_EQ(headerId(GiString("content-type")), 1);
+	EXPECT_EQ(headerId(GiString("content-length")), 2);
+	EXPECT_EQ(headerId(GiString("accept")), 0);
+#endif
+}
+
+TEST(GiStaticString, noAllocation) {
+	static const char* const longLiteral = "x-request-identifier-header-name";
+	size_t allocations = GiString::memoryStats().totalAllocations;
+	GiString longName = "x-request-identifier-header-name"_gs;
+	GiString shortName = "accept"_gs;
+	GiString copied = longName;
+	GiString moved = std::move(copied);
+	size_t after = GiString::memoryStats().totalAllocations;
+	EXPECT_EQ(after, allocations);
+	EXPECT_STREQ(longName.c_str(), longLiteral);
+	EXPECT_EQ(moved.c_str(), longName.c_str());
+	EXPECT_STREQ(shortName.c_str(), "accept");
+	EXPECT_FALSE(longName.isInterned());
+
+	// 只读，写入前先复制
+	moved[0] = 'X';
+	EXPECT_STREQ(moved.c_str(), "X-request-identifier-header-name");
+	EXPECT_STREQ(longName.c_str(), longLiteral);
+	EXPECT_EQ(moved.hashCode(), GiStringView("X-request-identifier-header-name").hashCode());
+
+	GiString assigned = longName;
+	assigned = "short";
+	EXPECT_STREQ(assigned.c_str(), "short");
+	assigned = longName;
+	assigned.empty();
+	EXPECT_TRUE(assigned.isEmpty());
+	EXPECT_STREQ(longName.c_str(), longLiteral);
+
+	GiStringBuilder builder;
+	builder.append(longName).append('!');
+	EXPECT_STREQ(builder.toString().c_str(), "x-request-identifier-header-name!");
+	EXPECT_EQ(longName.subString(2, 7), GiString("request"));
+	EXPECT_TRUE(longName.intern().isInterned());
+	EXPECT_EQ(longName.intern().c_str(), GiString(longLiteral).intern().c_str());
+}
+
+TEST(GiStaticString, compare) {
+	GiString value("content-type");
+	GiString other("content-tyPE");
+	other.hashCode();
+	EXPECT_TRUE(value.equals("content-type"_gs));
+	EXPECT_TRUE(value == "content-type"_gs);
+	EXPECT_FALSE(value != "content-type"_gs);
+	EXPECT_FALSE(other == "content-type"_gs);
+	EXPECT_FALSE(value == "content-typ"_gs);
+	EXPECT_FALSE(GiString() == "content-type"_gs);
+	EXPECT_TRUE(GiString() == ""_gs);
+
+	EXPECT_TRUE(value.startsWith("content-"_gs));
+	EXPECT_TRUE(value.startsWith("type"_gs, 8));
+	EXPECT_FALSE(value.startsWith("content-type-long"_gs));
+	EXPECT_TRUE(value.endsWith("-type"_gs));
+	EXPECT_FALSE(value.endsWith("x-content-type"_gs));
+}
+
+#if GI_STRING_HEADER_ONLY
+namespace
+{
+	int methodId(const GiStringView& method)
+	{
+		// 字面量的hash数值在编译期求得，可直接用作case标签
+		switch (method.hashCode())
+		{
+		case GiStringView("GET").hashCode(): return method == "GET" ? 1 : 0;
+		case GiStringView("POST").hashCode(): return method == "POST" ? 2 : 0;
+		case GiStringView("DELETE").hashCode(): return method == "DELETE" ? 3 : 0;
+		default: return 0;
+		}
+	}
+}
+
+TEST(GiStringConstexpr, headerOnly) {
+	constexpr GiStringView path("/api/v1/users?id=7");
+	static_assert(path.length() == 18, "");
+	static_assert(path.startsWith("/api/") && !path.startsWith("/api/", 1), "");
+	static_assert(path.endsWith("id=7") && !path.endsWith("/"), "");
+	static_assert(path.indexOf('?') == 13 && path.indexOf("v1") == 5 && path.indexOf("v2") == SIZE_MAX, "");
+	static_assert(path.equals("/api/v1/users?id=7") && path != GiStringView("/api"), "");
+	static_assert(GiStringView("POST").hashCode() == GiStringView("POST", 4).hashCode(), "");
+
+	// 运行期结果与编译期一致
+	GiString method("DELETE");
+	EXPECT_EQ(methodId(method.view()), 3);
+	EXPECT_EQ(methodId(GiString("GET").view()), 1);
+	EXPECT_EQ(methodId(GiString("PUT").view()), 0);
+	EXPECT_EQ(method.hashCode(), GiStringView("DELETE").hashCode());
+	EXPECT_EQ(GiStringView(path.data()).indexOf("users"), 8u);
+}
+#endif